@@ -1,15 +1,20 @@
 #include "JC/App.h"
 
+#include "JC/Asset.h"
+#include "JC/Atomic.h"
+#include "JC/Bench.h"
 #include "JC/Cfg.h"
 #include "JC/Draw.h"
 #include "JC/Effect.h"
 #include "JC/File.h"
 #include "JC/Gpu.h"
 #include "JC/Input.h"
+#include "JC/Job.h"
 #include "JC/Log.h"
 #include "JC/Rng.h"
 #include "JC/StrDb.h"
 #include "JC/Sys.h"
+#include "JC/Task.h"
 #include "JC/Time.h"
 #include "JC/UnitTest.h"
 #include "JC/Window.h"
@@ -42,16 +47,94 @@ static void PanicFn(SrcLoc sl, char const* expr, char const* msg) {
 
 //--------------------------------------------------------------------------------------------------
 
+static constexpr U32 MaxTasks = 4 * 1024;
+
 static Mem permMem;
 static Mem tempMem;
+static Mem frameMems[Gpu::MaxFrames];	// frameMems[n % MaxFrames] is reset once the GPU retires frame n - MaxFrames
+
+// Pipelined: the main thread posts kickSem with simUpdateData filled in and the sim thread posts
+// doneSem with simRes filled in. Neither side touches the other's data in between.
+static bool        simInit;
+static App*        simApp;
+static Sys::Thread simThread;
+static Sys::Sem    simKickSem;
+static Sys::Sem    simDoneSem;
+static U32         simExit;
+static U64         simFrame;
+static UpdateData  simUpdateData;
+static Res<>       simRes;	// its Err lives in the sim thread's store until the next kick
+
+//--------------------------------------------------------------------------------------------------
+
+// Tasks resume on whichever thread runs Update(), just before it
+static Res<> UpdateApp(App* app, UpdateData const* appUpdateData) {
+	Task::Update(appUpdateData->sec);
+	return app->Update(appUpdateData);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void SimThreadFn(void*) {
+	for (;;) {
+		Sys::WaitSem(&simKickSem);
+		if (Atomic::Load(&simExit)) {
+			break;
+		}
+		Err::Update(simFrame);
+		simRes = UpdateApp(simApp, &simUpdateData);
+		Sys::PostSem(&simDoneSem);
+	}
+	Mem::ShutdownScratch();
+}
+
+static void StartSim(App* app) {
+	simApp  = app;
+	simExit = 0;
+	Sys::InitSem(&simKickSem, 0);
+	Sys::InitSem(&simDoneSem, 0);
+	simThread = Sys::StartThread(SimThreadFn, nullptr);
+	simInit   = true;
+}
+
+static void KickSim(U64 frame, UpdateData const* appUpdateData) {
+	simFrame      = frame;
+	simUpdateData = *appUpdateData;
+	Sys::PostSem(&simKickSem);
+}
+
+static Res<> WaitSim() {
+	Sys::WaitSem(&simDoneSem);
+	return simRes;
+}
+
+// Called after the error has been logged: joining frees the sim thread's Err store
+static void ShutdownSim() {
+	if (!simInit) {
+		return;
+	}
+	Atomic::Store(&simExit, 1);
+	Sys::PostSem(&simKickSem);
+	Sys::JoinThread(simThread);
+	Sys::ShutdownSem(&simKickSem);
+	Sys::ShutdownSem(&simDoneSem);
+	simInit = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Res<> RunImpl(App* app, int argc, char const* const* argv) {
 	SetPanicFn(PanicFn);
 
-	permMem = Mem::Create(16 * GB);
+	permMem = Mem::Create(16 * GB, PageKind::Huge);
 	tempMem = Mem::Create(16 * GB);
+	for (U32 i = 0; i < Gpu::MaxFrames; i++) {
+		frameMems[i] = Mem::Create(4 * GB);
+	}
 
 	Err::SetBreakOnErr(true);
 	Time::Init();
+	Job::Init();
 	StrDb::Init();
 	U64 rngSeed = Time::Now();
 	rngSeed = 0x14bd05373a90;
@@ -72,6 +155,10 @@ Res<> RunImpl(App* app, int argc, char const* const* argv) {
 
 	Logf("Rng seed = 0x%016x", rngSeed);
 
+	if (U32 const memTraceFrames = Cfg::GetU32(Cfg_MemTrace, 0); memTraceFrames) {
+		Mem::EnableTrace(true, memTraceFrames);
+	}
+
 	Input::Init(permMem);
 
 	Try(app->PreInit(permMem, tempMem));
@@ -108,14 +195,56 @@ Res<> RunImpl(App* app, int argc, char const* const* argv) {
 	};
 	Try(Draw::Init(&drawInitDesc));
 
+	Asset::Init(Gpu::ImmediateWait);
+	Task::Init(MaxTasks);
+
 	Try(app->Init(&windowState));
 
+	bool const pipelined = Cfg::GetU32(Cfg_Pipelined, 0) != 0;
+	if (pipelined) {
+		StartSim(app);
+	}
+	bool simBusy = false;	// the sim thread is running last loop's Update()
+
 	U64 frame = 0;
+	U64 frameMemFrameNum = U64Max;	// the GPU frame frameMem was last reset for
 	U64 lastTicks = Time::Now();
 	for (;;) {
 		frame++;
 
+		// From here until the kick below the sim thread is idle: everything up to it may touch what
+		// Update() does
+		if (simBusy) {
+			simBusy = false;
+			if (Res<> r = WaitSim(); !r) {
+				if (r.err == Err_Exit) {
+					return Ok();
+				}
+				return r.err;
+			}
+		}
+
+		Mem::TraceFrame();
 		Mem::Reset(tempMem, MemMark());
+		if (U64 const trimmed = Mem::Trim(tempMem); trimmed) {
+			Logf("Trimmed %u bytes of tempMem", trimmed);
+		}
+
+		// Loops that never reach the GPU (minimized, swapchain recreated, BeginFrame failed) keep
+		// appending to the same arena: what they put there may still be used by the frame that does
+		// get submitted, so it's only reset once the GPU frame number moves on
+		U64 const gpuFrameNum = Gpu::GetFrameNum();
+		Mem const frameMem = frameMems[gpuFrameNum % Gpu::MaxFrames];
+		if (gpuFrameNum != frameMemFrameNum) {
+			if (gpuFrameNum >= Gpu::MaxFrames) {
+				Try(Gpu::WaitFrame(gpuFrameNum - Gpu::MaxFrames));
+			}
+			Mem::Reset(frameMem, MemMark());
+			if (U64 const trimmed = Mem::Trim(frameMem); trimmed) {
+				Logf("Trimmed %u bytes of frameMem %u", trimmed, gpuFrameNum % Gpu::MaxFrames);
+			}
+			frameMemFrameNum = gpuFrameNum;
+		}
 		Err::Update(frame);
 
 		U64 const nowTicks = Time::Now();
@@ -129,6 +258,7 @@ Res<> RunImpl(App* app, int argc, char const* const* argv) {
 		Span<Input::Action const> const actions = Input::ProcessKeyEvents(windowEvents.keyEvents);
 
 		UpdateData const appUpdateData = {
+			.frameMem    = frameMem,
 			.sec         = sec,
 			.actions     = actions,
 			.mouseX      = windowEvents.mouseX,
@@ -137,20 +267,28 @@ Res<> RunImpl(App* app, int argc, char const* const* argv) {
 			.mouseDeltaY = windowEvents.mouseDeltaY,
 			.exit        = windowEvents.exitEvent,
 		};
-		if (Res<> r = app->Update(&appUpdateData); !r) {
+		Try(Asset::Update());	// finishes whatever the workers have prepared since last frame
+
+		// Before Update() so that pipelined, ResizeWindow() never overlaps it
+		bool const resized = prevWindowState.width != windowState.width || prevWindowState.height != windowState.height;
+		if (resized) {
+			Logf("Window size changed: %ux%u -> %ux%u", prevWindowState.width, prevWindowState.height, windowState.width, windowState.height);
+			Try(Gpu::RecreateSwapchain(windowState.width, windowState.height));
+			Try(Draw::ResizeWindow(windowState.width, windowState.height));
+			Try(app->ResizeWindow(windowState.width, windowState.height));
+		}
+
+		if (pipelined) {
+			KickSim(frame, &appUpdateData);
+			simBusy = true;
+		} else if (Res<> r = UpdateApp(app, &appUpdateData); !r) {
 			if (r.err == Err_Exit) {
 				return Ok();
 			}
 			return r.err;
 		}
 
-		bool recreatedSwapChain = false;
-		if (prevWindowState.width != windowState.width || prevWindowState.height != windowState.height) {
-			Logf("Window size changed: %ux%u -> %ux%u", prevWindowState.width, prevWindowState.height, windowState.width, windowState.height);
-			Try(Gpu::RecreateSwapchain(windowState.width, windowState.height));
-			recreatedSwapChain = true;
-			Try(Draw::ResizeWindow(windowState.width, windowState.height));
-			Try(app->ResizeWindow(windowState.width, windowState.height));
+		if (resized) {
 			continue;
 		}
 
@@ -187,11 +325,16 @@ Res<> RunImpl(App* app, int argc, char const* const* argv) {
 //--------------------------------------------------------------------------------------------------
 
 void Shutdown(App* app) {
+	ShutdownSim();
 	Gpu::WaitIdle();
 	app->Shutdown();
+	Task::Shutdown();
+	Asset::Shutdown();
 	Draw::Shutdown();
 	Gpu::Shutdown();
 	Window::Shutdown();
+	File::Shutdown();
+	Job::Shutdown();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -200,6 +343,9 @@ bool Run(App* app, int argc, char const* const* argv) {
 	if (argc == 2 && argv[1] == Str("test")) {
 		UnitTest::Run(); return 0;
 	}
+	if (argc == 2 && argv[1] == Str("bench")) {
+		Bench::Run(); return 0;
+	}
 
 	Res<> r = RunImpl(app, argc, argv);
 	if (!r) {
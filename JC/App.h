@@ -17,10 +17,13 @@ constexpr Str Cfg_WindowStyle      = "App.WindowStyle";
 constexpr Str Cfg_WindowWidth      = "App.WindowWidth";
 constexpr Str Cfg_WindowHeight     = "App.WindowHeight";
 constexpr Str Cfg_WindowDisplayIdx = "App.WindowDisplayIdx";
+constexpr Str Cfg_MemTrace         = "App.MemTrace";	// 0 = off, else log a report every N frames
+constexpr Str Cfg_Pipelined        = "App.Pipelined";	// 1 = Update() on its own thread, overlapping Draw(). Off unless set, e.g. App.Pipelined=1 on the command line
 
 //--------------------------------------------------------------------------------------------------
 
 struct UpdateData {
+	Mem                       frameMem;	// lives until the GPU retires this frame, so it's safe to hand to async consumers
 	F32                       sec;
 	Span<Input::Action const> actions;
 	I32                       mouseX;
@@ -30,6 +33,13 @@ struct UpdateData {
 	bool                      exit;
 };
 
+// Pipelined, Update() for frame N + 1 runs on the sim thread while the main thread runs Draw() for
+// frame N, so a frame costs the slower of the two rather than their sum. Everything else, the
+// window, Asset::Update() and ResizeWindow(), runs while Update() is idle. An app that opts in:
+// - hands Draw() its state through something like a TripleBuffer, never by sharing what Update() writes
+// - doesn't touch tempMem, Log, Gpu or Draw from Update(): frameMem and Mem::GetScratch() are its own
+// - has Draw() cope with nothing published yet: the first Update() is still running
+// Task::Update() runs just before Update(), on the same thread, so tasks follow the same rules.
 struct App {
 	Res<> (*PreInit)(Mem permMem, Mem tempMem);
 	Res<> (*Init)(Window::State const* windowState);
@@ -0,0 +1,366 @@
+#include "JC/Asset.h"
+
+#include "JC/Atomic.h"
+#include "JC/HandlePool.h"
+#include "JC/Job.h"
+#include "JC/Sys.h"
+#include "JC/UnitTest.h"
+
+namespace JC::Asset {
+
+//--------------------------------------------------------------------------------------------------
+
+static constexpr U32 MaxLoads        = 64;	// in flight: each holds an arena until it's finished
+static constexpr U64 LoadReserveSize = 1 * GB;
+
+struct LoadObj {
+	Str          path;	// copied into mem
+	Mem          mem;	// the load's own: prepare allocates from a worker, so it can't share tempMem
+	void*        state;
+	PrepareFn*   prepareFn;
+	FinishFn*    finishFn;
+	DropFn*      dropFn;
+	Job::Counter counter;	// nonzero while prepare is queued or running
+	Err const*   err;	// copied into mem: an Err belongs to the thread and frame that made it
+	bool         finished;
+};
+
+static bool                      init;
+static Mem                       mem;
+static FlushFn*                  flushFn;
+static HandlePool<Load, LoadObj> loadObjs;
+static Array<Load>               unfinished;	// in Start() order
+static thread_local bool         mainThread;	// Init()'s: the only one that may finish loads
+
+//--------------------------------------------------------------------------------------------------
+
+// Strings are cloned and printers printed, so the copy outlives the store and frame it came from
+static Err const* CopyErr(Mem mem, Err const* err) {
+	if (!err) {
+		return nullptr;
+	}
+	Err* const copy = Mem::AllocT<Err>(mem, 1);
+	*copy = *err;
+	copy->prev = CopyErr(mem, err->prev);
+	for (U32 i = 0; i < copy->namedArgsLen; i++) {
+		Arg* const arg = &copy->namedArgs[i].arg;
+		if (arg->type == Arg::Type::Str) {
+			*arg = Arg::Make(SPrintf(mem, "%s", Str(arg->s.data, arg->s.len)));
+		} else if (arg->type == Arg::Type::Printer) {
+			StrBuf sb(mem);
+			arg->printer->Print(&sb);
+			*arg = Arg::Make(sb.ToStr());
+		}
+	}
+	return copy;
+}
+
+// Rebuilds a copied chain in the calling thread's store, innermost first
+static Err const* RemakeErr(Err const* copy) {
+	if (!copy) {
+		return nullptr;
+	}
+	Err const* const prev = RemakeErr(copy->prev);
+	return Err::Makev(prev, copy->sl, copy->ns, copy->sCode, copy->uCode, copy->namedArgs, copy->namedArgsLen);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Init(FlushFn* flushFnIn) {
+	Assert(!init);
+	mem        = Mem::Create(1 * MB);
+	flushFn    = flushFnIn;
+	loadObjs.Init(mem, MaxLoads + 1);	// + 1: index 0 is reserved
+	unfinished.Init(mem, MaxLoads);
+	mainThread = true;
+	init       = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Shutdown() {
+	if (!init) {
+		return;
+	}
+	for (U32 i = 1; i < loadObjs.len; i++) {
+		LoadObj* const obj = &loadObjs.entries[i].obj;
+		if (loadObjs.entries[i].gen) {
+			Job::Wait(&obj->counter);
+			if (!obj->finished && obj->dropFn) {
+				obj->dropFn(obj->mem, obj->path, obj->state);
+			}
+			if (obj->mem) {
+				Mem::Destroy(obj->mem);
+			}
+		}
+	}
+	Mem::Destroy(mem);
+	mainThread = false;
+	init       = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void PrepareJob(void* userData) {
+	LoadObj* const obj = (LoadObj*)userData;
+	ErrMark const errMark = Err::Mark();
+	if (Res<> r = obj->prepareFn(obj->mem, obj->path, obj->state); !r) {
+		obj->err = CopyErr(obj->mem, r.err);
+	}
+	Err::Reset(errMark);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Load Start(LoadDesc const* desc) {
+	Assert(init);
+	Assert(unfinished.HasCapacity());
+	auto* const entry = loadObjs.Alloc();
+	LoadObj* const obj = &entry->obj;
+	obj->mem       = Mem::Create(LoadReserveSize);
+	obj->path      = SPrintf(obj->mem, "%s", desc->path);
+	obj->state     = desc->stateSize ? Mem::Alloc(obj->mem, desc->stateSize) : nullptr;
+	obj->prepareFn = desc->prepareFn;
+	obj->finishFn  = desc->finishFn;
+	obj->dropFn    = desc->dropFn;
+
+	Load const load = entry->Handle();
+	unfinished.Add(load);
+	if (obj->prepareFn) {
+		Job::Run(PrepareJob, obj, &obj->counter);
+	}
+	return load;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Once finished, a load that succeeded has no more use for its arena: the decoded data has been
+// copied to the GPU's staging memory. A failed prepare skips finish, so its state is dropped here;
+// a finish that fails cleans up after itself.
+static void Finish(LoadObj* obj) {
+	if (obj->err) {
+		if (obj->dropFn) {
+			obj->dropFn(obj->mem, obj->path, obj->state);
+		}
+	} else if (obj->finishFn) {
+		if (Res<> r = obj->finishFn(obj->mem, obj->path, obj->state); !r) {
+			obj->err = CopyErr(obj->mem, r.err);
+		}
+	}
+	obj->finished = true;
+	if (!obj->err) {
+		Mem::Destroy(obj->mem);
+		obj->mem   = Mem();
+		obj->path  = Str();
+		obj->state = nullptr;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<> Update() {
+	Assert(init);
+	Assert(mainThread);
+	U64 finishedLen = 0;
+	U64 keptLen     = 0;
+	for (U64 i = 0; i < unfinished.len; i++) {
+		LoadObj* const obj = loadObjs.Get(unfinished[i]);
+		if (Atomic::Load(&obj->counter.val)) {
+			unfinished[keptLen++] = unfinished[i];
+			continue;
+		}
+		Finish(obj);
+		finishedLen++;
+	}
+	unfinished.len = keptLen;
+
+	if (finishedLen && flushFn) {
+		Try(flushFn());
+	}
+	return Ok();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool IsDone(Load load) {
+	return loadObjs.Get(load)->finished;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<> Wait(Load load) {
+	LoadObj* const obj = loadObjs.Get(load);
+	Job::Wait(&obj->counter);	// runs queued jobs while it waits, this load's prepare among them
+	Res<> res = obj->finished ? Ok() : Update();	// only from the main thread: Update() asserts it
+	if (res && obj->err) {
+		res = RemakeErr(obj->err);
+	}
+	if (obj->mem) {
+		Mem::Destroy(obj->mem);
+	}
+	loadObjs.Free(load);
+	return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// All done already, as from the sim thread, and there's nothing to finish: any other load that's
+// ready stays for the main thread's Update()
+Res<> WaitAll(Span<Load const> loads) {
+	bool allDone = true;
+	for (U64 i = 0; i < loads.len; i++) {
+		LoadObj* const obj = loadObjs.Get(loads[i]);
+		Job::Wait(&obj->counter);
+		allDone &= obj->finished;
+	}
+	Res<> res = allDone ? Ok() : Update();
+	for (U64 i = 0; i < loads.len; i++) {
+		if (Res<> r = Wait(loads[i]); !r && res) {	// keep waiting: every handle must be released
+			res = r;
+		}
+	}
+	return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DefErr(AssetTest, Prepare);
+DefErr(AssetTest, Finish);
+
+struct TestState {
+	U64 n;
+	U64 square;
+};
+
+static U64 testFinished[16];
+static U32 testFlushes;
+static U32 testDropped;
+
+// The path is a number: 13 fails to prepare, 14 fails to finish
+static Res<> TestPrepare(Mem mem, Str path, void* state) {
+	TestState* const s = (TestState*)state;
+	for (U32 i = 0; i < path.len; i++) {
+		s->n = s->n * 10 + (U64)(path[i] - '0');
+	}
+	if (s->n == 13) {
+		return Err_Prepare("path", path);
+	}
+	U64* const scratch = Mem::AllocT<U64>(mem, 1024);
+	for (U64 i = 0; i < 1024; i++) {
+		scratch[i] = s->n;
+	}
+	s->square = scratch[s->n] * scratch[1023 - s->n];
+	return Ok();
+}
+
+static Res<> TestFinish(Mem, Str path, void* state) {
+	TestState const* const s = (TestState const*)state;
+	if (s->n == 14) {
+		return Err_Finish("path", path);
+	}
+	testFinished[s->n] = s->square;
+	return Ok();
+}
+
+static void TestDrop(Mem, Str, void*) {
+	testDropped++;
+}
+
+static Res<> TestFlush() {
+	testFlushes++;
+	return Ok();
+}
+
+static Load TestStart(Mem mem, U32 n) {
+	LoadDesc const desc = {
+		.path      = SPrintf(mem, "%u", n),
+		.stateSize = sizeof(TestState),
+		.prepareFn = TestPrepare,
+		.finishFn  = TestFinish,
+		.dropFn    = TestDrop,
+	};
+	return Start(&desc);
+}
+
+Unit_Test("Asset") {
+	Job::Init(2);
+	Defer { Job::Shutdown(); };
+	Init(TestFlush);
+	Defer { Shutdown(); };
+
+	Unit_SubTest("WaitAll") {
+		memset(testFinished, 0, sizeof(testFinished));
+		testFlushes = 0;
+		Load loads[12];
+		for (U32 i = 0; i < LenOf(loads); i++) {
+			loads[i] = TestStart(testMem, i);
+		}
+		Unit_Check(WaitAll(Span<Load const>(loads, LenOf(loads))));
+		U32 errors = 0;
+		for (U32 i = 0; i < LenOf(loads); i++) {
+			errors += testFinished[i] != (U64)i * i;
+		}
+		Unit_CheckEq(errors, 0u);
+		Unit_CheckEq(testFlushes, 1u);
+	}
+
+	Unit_SubTest("Poll") {
+		testFlushes = 0;
+		Load const load = TestStart(testMem, 7);
+		while (!IsDone(load)) {
+			Unit_Check(Update());
+		}
+		Unit_CheckEq(testFinished[7], (U64)49);
+		Unit_CheckEq(testFlushes, 1u);
+		Unit_Check(Wait(load));
+		Unit_CheckEq(testFlushes, 1u);
+
+		LoadDesc const desc = { .path = "nothing to do" };
+		Unit_Check(Wait(Start(&desc)));
+	}
+
+	Unit_SubTest("WaitAll off the main thread") {
+		testFlushes = 0;
+		Load const done = TestStart(testMem, 8);
+		while (!IsDone(done)) {
+			Unit_Check(Update());
+		}
+		LoadDesc const desc = { .path = "nothing to do" };
+		Load const pending = Start(&desc);	// prepared, not finished
+		struct ThreadData { Load load; bool ok; } data = { .load = done };
+		Sys::Thread const thread = Sys::StartThread([](void* userData) {
+			ThreadData* const d = (ThreadData*)userData;
+			d->ok = (bool)WaitAll(Span<Load const>(&d->load, 1));
+		}, &data);
+		Sys::JoinThread(thread);
+		Unit_Check(data.ok);
+		Unit_Check(!IsDone(pending));	// left for the main thread
+		Unit_CheckEq(testFlushes, 1u);
+		Unit_Check(Wait(pending));
+	}
+
+	Unit_SubTest("Errors") {
+		testDropped = 0;
+		Load const loads[3] = { TestStart(testMem, 12), TestStart(testMem, 13), TestStart(testMem, 14) };
+		Res<> r = WaitAll(Span<Load const>(loads, 3));
+		Unit_Check(!r && r.err == Err_Prepare);
+		Unit_CheckEq(testFinished[12], (U64)144);
+		Unit_CheckEq(testDropped, 1u);	// 13's prepare failed: 14's finish cleans up after itself
+
+		r = Wait(TestStart(testMem, 14));
+		Unit_Check(!r && r.err == Err_Finish);
+	}
+
+	Unit_SubTest("Shutdown drops unfinished") {
+		testDropped = 0;
+		Load const load = TestStart(testMem, 9);
+		Job::Wait(&loadObjs.Get(load)->counter);	// prepared, never finished
+		Shutdown();
+		Unit_CheckEq(testDropped, 1u);
+		Init(TestFlush);	// for the deferred Shutdown()
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Asset
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "JC/Common.h"
+
+namespace JC::Asset {
+
+//--------------------------------------------------------------------------------------------------
+
+// Loads that don't block the caller. Each load runs in two stages:
+// - Prepare runs on a Job worker and does the slow, self-contained part: read, decode, parse. It
+//   allocates from the load's own arena and touches nothing shared.
+// - Finish runs on the main thread from Update(): create GPU resources, queue their uploads and
+//   register the results where the rest of the game looks them up.
+// Update() finishes every load whose prepare is done, then flushes once for the whole batch, so a
+// dozen images cost one GPU wait instead of a dozen.
+// Start() returns at once. Poll with IsDone() or block with Wait(), which also releases the handle:
+// every load must be waited on. Loads finish in no particular order, so start a load that looks up
+// another's results only once that one is done. Call Update from the main thread. Start, IsDone and
+// Wait may come from a thread that never overlaps it, like the App's sim thread, but wait there only
+// on loads that IsDone: a Wait on anything else has to finish it, and asserts off the main thread.
+
+DefHandle(Load);
+
+using PrepareFn = Res<> (Mem mem, Str path, void* state);	// any thread
+using FinishFn  = Res<> (Mem mem, Str path, void* state);	// main thread
+using DropFn    = void  (Mem mem, Str path, void* state);	// main thread
+using FlushFn   = Res<> ();
+
+struct LoadDesc {
+	Str        path;
+	U64        stateSize;	// zeroed, from the load's arena, passed to both stages
+	PrepareFn* prepareFn;	// may be null
+	FinishFn*  finishFn;	// may be null
+	DropFn*    dropFn;	// may be null: frees what state holds outside the arena when finish won't run
+};
+
+void  Init(FlushFn* flushFn);	// called after each batch of finishes, e.g. Gpu::ImmediateWait; may be null
+void  Shutdown();	// waits out prepares still running and drops their results through dropFn
+Load  Start(LoadDesc const* desc);
+Res<> Update();	// fails only if the flush does: each load's own errors come from Wait()
+bool  IsDone(Load load);
+Res<> Wait(Load load);
+Res<> WaitAll(Span<Load const> loads);	// one flush for the lot; waits on every load, returns the first error
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Asset
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "JC/Common.h"
+
+#if defined Compiler_Msvc
+	#include <intrin.h>
+#endif	// Compiler
+
+namespace JC::Atomic {
+
+//--------------------------------------------------------------------------------------------------
+
+// The few atomic ops the lock-free code here needs. Loads are acquire, stores are release, and the
+// read-modify-writes are full barriers, which is what x64 gives us for free anyway.
+// On Msvc plain aligned loads and stores are atomic on x64: the barriers only stop the compiler.
+
+#if defined Compiler_Msvc
+	inline U32  Load (U32 const* p)                                { U32 const v = *(U32 const volatile*)p; _ReadWriteBarrier(); return v; }
+	inline U64  Load (U64 const* p)                                { U64 const v = *(U64 const volatile*)p; _ReadWriteBarrier(); return v; }
+	inline void Store(U32* p, U32 v)                               { _ReadWriteBarrier(); *(U32 volatile*)p = v; }
+	inline void Store(U64* p, U64 v)                               { _ReadWriteBarrier(); *(U64 volatile*)p = v; }
+	inline U32  FetchAdd(U32* p, U32 v)                            { return (U32)_InterlockedExchangeAdd((long volatile*)p, (long)v); }
+	inline U64  FetchAdd(U64* p, U64 v)                            { return (U64)_InterlockedExchangeAdd64((long long volatile*)p, (long long)v); }
+	inline U32  Exchange(U32* p, U32 v)                            { return (U32)_InterlockedExchange((long volatile*)p, (long)v); }
+	inline U64  Exchange(U64* p, U64 v)                            { return (U64)_InterlockedExchange64((long long volatile*)p, (long long)v); }
+	inline bool CompareExchange(U32* p, U32 expected, U32 desired) { return (U32)_InterlockedCompareExchange((long volatile*)p, (long)desired, (long)expected) == expected; }
+	inline bool CompareExchange(U64* p, U64 expected, U64 desired) { return (U64)_InterlockedCompareExchange64((long long volatile*)p, (long long)desired, (long long)expected) == expected; }
+	inline void Fence()                                            { _mm_mfence(); }
+	inline void Pause()                                            { _mm_pause(); }
+#elif defined Compiler_Gcc
+	inline U32  Load (U32 const* p)                                { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+	inline U64  Load (U64 const* p)                                { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+	inline void Store(U32* p, U32 v)                               { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+	inline void Store(U64* p, U64 v)                               { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+	inline U32  FetchAdd(U32* p, U32 v)                            { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+	inline U64  FetchAdd(U64* p, U64 v)                            { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+	inline U32  Exchange(U32* p, U32 v)                            { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+	inline U64  Exchange(U64* p, U64 v)                            { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+	inline bool CompareExchange(U32* p, U32 expected, U32 desired) { return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE); }
+	inline bool CompareExchange(U64* p, U64 expected, U64 desired) { return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE); }
+	inline void Fence()                                            { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+	inline void Pause()                                            { __builtin_ia32_pause(); }
+#endif	// Compiler
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Atomic
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "JC/Draw.h"
 #include "JC/Input.h"
 #include "JC/Key.h"
+#include "JC/Queue.h"
 #include "JC/Unit.h"
 #include "JC/Window.h"
 
@@ -42,6 +43,18 @@ static Input::BindingSet           bindingSet;
 static Array<Unit::Unit>           units[2];
 static Array<Draw::DrawSpriteDesc> unitDrawDescs[2];
 
+// All Draw() looks at, copied out at the end of each Update(). Pipelined, Draw() runs on the main
+// thread while the next Update() is already moving the camera and units.
+struct Frame {
+	Draw::Camera         camera;
+	U32                  hexDrawDescsLen;
+	U32                  unitDrawDescsLen[2];
+	Draw::DrawSpriteDesc hexDrawDescs[Map::MaxHexes];
+	Draw::DrawSpriteDesc unitDrawDescs[2][MaxArmyUnits];
+};
+
+static TripleBuffer<Frame> frames;
+
 //--------------------------------------------------------------------------------------------------
 
 void Init(Mem permMem, Mem tempMem, Window::State const* windowState) {
@@ -55,6 +68,8 @@ void Init(Mem permMem, Mem tempMem, Window::State const* windowState) {
 	camera.pos   = { 0.f, 0.f };
 	camera.scale = 3.f;
 
+	frames.Init();
+
 	bindingSet = Input::CreateBindingSet("Main");
 	Input::Bind(bindingSet, Key::Key::Escape,         Input::BindingType::OnKeyDown,  ActionId_Exit);
 	Input::Bind(bindingSet, Key::Key::Mouse1,         Input::BindingType::OnKeyUp,    ActionId_LClick);
@@ -121,6 +136,21 @@ static void ZoomCamera(F32 d) {
 
 //--------------------------------------------------------------------------------------------------
 
+static void Publish() {
+	Frame* const frame = frames.Back();
+	frame->camera = camera;
+	Span<Draw::DrawSpriteDesc const> const hexDrawDescs = Map::GetDrawDescs();
+	memcpy(frame->hexDrawDescs, hexDrawDescs.data, hexDrawDescs.len * sizeof(Draw::DrawSpriteDesc));
+	frame->hexDrawDescsLen = (U32)hexDrawDescs.len;
+	for (Side side = Side_Friendly; side <= Side_Enemy; side++) {
+		memcpy(frame->unitDrawDescs[side], unitDrawDescs[side].data, unitDrawDescs[side].len * sizeof(Draw::DrawSpriteDesc));
+		frame->unitDrawDescsLen[side] = (U32)unitDrawDescs[side].len;
+	}
+	frames.Publish();
+}
+
+//--------------------------------------------------------------------------------------------------
+
 static constexpr F32 CameraSpeedPixelsPerSec = 1000.f;
 
 Res<> Update(App::UpdateData const* appUpdateData) {
@@ -161,16 +191,23 @@ Res<> Update(App::UpdateData const* appUpdateData) {
 	camera.pos.x += cameraDx * CameraSpeedPixelsPerSec * appUpdateData->sec / camera.scale;
 	camera.pos.y += cameraDy * CameraSpeedPixelsPerSec * appUpdateData->sec / camera.scale;
 
+	Publish();
+
 	return Ok();
 }
 
 //--------------------------------------------------------------------------------------------------
 
 void Draw() {
-	Draw::SetCamera(camera);
-	Map::Draw();
-	Draw::DrawSprites(unitDrawDescs[Side_Friendly]);
-	Draw::DrawSprites(unitDrawDescs[Side_Enemy]);
+	Frame const* const frame = frames.Acquire();
+	if (!frame) {
+		return;	// no Update() has finished yet
+	}
+	Draw::SetCamera(frame->camera);
+	Draw::DrawSprites(Span<Draw::DrawSpriteDesc const>(frame->hexDrawDescs, frame->hexDrawDescsLen));
+	for (Side side = Side_Friendly; side <= Side_Enemy; side++) {
+		Draw::DrawSprites(Span<Draw::DrawSpriteDesc const>(frame->unitDrawDescs[side], frame->unitDrawDescsLen[side]));
+	}
 }
 
 //--------------------------------------------------------------------------------------------------
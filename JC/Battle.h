@@ -14,7 +14,6 @@ Res<> LoadMap(Str path);
 Res<> Update(App::UpdateData const* appUpdateData);
 void  Draw();
 
-void GenerateRandomMap(U32 cols, U32 rows);
 void GenerateRandomArmies();
 
 //--------------------------------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #include "JC/Battle_Map.h"
 
+#include "JC/Asset.h"
 #include "JC/Draw.h"
 #include "JC/Hash.h"
 #include "JC/Json.h"
@@ -15,8 +16,8 @@ DefErr(Battle_Map, MaxTerrain);
 //--------------------------------------------------------------------------------------------------
 
 struct TerrainDef {
-	Str name;
-	Str sprite;
+	Sym name;
+	Sym sprite;
 	U32 chance;
 	U32 movementCost;
 	U32 staminaCost;
@@ -42,7 +43,6 @@ Json_End(MapDef)
 
 static constexpr U32 HexSize     = 32;
 static constexpr U32 MaxTerrains = 128;
-static constexpr U32 MaxHexes    = 16 * 16;
 
 namespace Dir {
 	constexpr U32 TopLeft     = 0;
@@ -55,7 +55,7 @@ namespace Dir {
 }
 
 struct Terrain {
-	Str          name;
+	Sym          name;
 	Draw::Sprite sprite;
 	U32          movementCost;
 	U32          staminaCost;
@@ -76,7 +76,7 @@ struct Hex {
 static Mem                         tempMem;
 static U32                         hexSize;
 static Array<Terrain>              terrains;
-static JC::Map<Str, Terrain*>      terrainsMap;
+static JC::Map<Sym, Terrain*>      terrainsMap;
 static Array<TerrainChance>        terrainChances;
 static Array<Hex>                  hexes;
 static Draw::Font                  font;
@@ -88,7 +88,7 @@ static F32                         drawZ;
 void Init(Mem permMem, Mem tempMemIn, F32 drawZIn) {
 	tempMem = tempMemIn;
 	terrains.Init(permMem, MaxTerrains);
-	terrainsMap.Init(permMem, MaxTerrains);
+	terrainsMap.Init(permMem, MapCapFor(MaxTerrains));
 	terrainChances.Init(permMem, MaxTerrains);
 	hexes.Init(permMem, MaxHexes);
 	hexDrawDescs.Init(permMem, MaxHexes);
@@ -110,20 +110,25 @@ static void RebuildHexDrawDescs() {
 
 //--------------------------------------------------------------------------------------------------
 
-Res<> Load(Str path) {
-	MapDef mapDef; Try(Json::Load(tempMem, path, &mapDef));
+static Res<> PrepareMap(Mem mem, Str path, void* state) {
+	return Json::Load(mem, path, (MapDef*)state);
+}
+
+// Looks up sprites and fonts, so those loads must be done first
+static Res<> FinishMap(Mem, Str, void* state) {
+	MapDef const* const mapDef = (MapDef const*)state;
 
-	if (!terrains.HasCapacity(mapDef.terrain.len)) { return Err_MaxTerrain(); }
+	if (!terrains.HasCapacity(mapDef->terrain.len)) { return Err_MaxTerrain(); }
 
-	TryTo(Draw::GetFont(mapDef.font), font);
+	TryTo(Draw::GetFont(mapDef->font), font);
 
 	U32 accumulatedChance = terrainChances.len > 0 ? terrainChances[terrainChances.len - 1].chance : 0;
-	for (U64 i = 0; i < mapDef.terrain.len; i++) {
-		TerrainDef const* terrainDef = &mapDef.terrain[i];
+	for (U64 i = 0; i < mapDef->terrain.len; i++) {
+		TerrainDef const* terrainDef = &mapDef->terrain[i];
 		Draw::Sprite sprite; TryTo(Draw::GetSprite(terrainDef->sprite), sprite);
 		Terrain* terrain = terrains.Add();
 		*terrain = {
-			.name         = terrainDef->name,	// interned by Json
+			.name         = terrainDef->name,
 			.sprite       = sprite,
 			.movementCost = terrainDef->movementCost,
 			.staminaCost  = terrainDef->staminaCost,
@@ -141,6 +146,20 @@ Res<> Load(Str path) {
 	return Ok();
 }
 
+Asset::Load LoadAsync(Str path) {
+	Asset::LoadDesc const desc = {
+		.path      = path,
+		.stateSize = sizeof(MapDef),
+		.prepareFn = PrepareMap,
+		.finishFn  = FinishMap,
+	};
+	return Asset::Start(&desc);
+}
+
+Res<> Load(Str path) {
+	return Asset::Wait(LoadAsync(path));
+}
+
 //--------------------------------------------------------------------------------------------------
 
 static Vec2 CalcWorldPos(U32 c, U32 r) {
@@ -167,7 +186,9 @@ static Terrain const* RngTerrain() {
 
 void GenerateRandomMap(U32 cols, U32 rows) {
 	Assert(cols * rows <= MaxHexes);
-	JC::Map<U64, Hex*> colRowMap(tempMem, cols * rows);
+	Mem const scratch = Mem::GetScratch();
+	MemScope(scratch);
+	JC::Map<U64, Hex*> colRowMap(scratch, MapCapFor(cols * rows));
 	auto Key = [](U32 c, U32 r) { return (U64)c | ((U64)r << 32); };
 
 	hexes.len = 0;
@@ -208,8 +229,8 @@ void GenerateRandomMap(U32 cols, U32 rows) {
 
 //--------------------------------------------------------------------------------------------------
 
-void Draw() {
-	Draw::DrawSprites(hexDrawDescs);
+Span<Draw::DrawSpriteDesc const> GetDrawDescs() {
+	return hexDrawDescs;
 	/*
 	Draw::DrawStr({
 		.font   = font,
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "JC/Common.h"
+#include "JC/Asset.h"
+
+namespace JC::Draw { struct DrawSpriteDesc; }
 
 namespace JC::Battle::Map {
 
 //--------------------------------------------------------------------------------------------------
 
-void  Init(Mem permMem, Mem tempMemIn, F32 drawZ);
-void  Draw();
+constexpr U32 MaxHexes = 16 * 16;
+
+void                             Init(Mem permMem, Mem tempMemIn, F32 drawZ);
+Asset::Load                      LoadAsync(Str path);	// parses on a worker; its sprites and font must already be loaded
+Res<>                            Load(Str path);
+void                             GenerateRandomMap(U32 cols, U32 rows);	// safe from the sim thread
+Span<Draw::DrawSpriteDesc const> GetDrawDescs();	// until the next GenerateRandomMap()
 
 //--------------------------------------------------------------------------------------------------
 
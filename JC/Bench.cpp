@@ -0,0 +1,81 @@
+#include "JC/Bench.h"
+
+#include "JC/File.h"
+#include "JC/Log.h"
+#include "JC/StrDb.h"
+#include "JC/Sys.h"
+#include "JC/Time.h"
+
+namespace JC::Bench {
+
+//--------------------------------------------------------------------------------------------------
+
+static constexpr U32 MaxBenches = 256;
+
+struct BenchObj {
+	Str      name;
+	SrcLoc   sl;
+	BenchFn* benchFn = 0;
+};
+
+static BenchObj     benches[MaxBenches];
+static U32          benchesLen;
+static volatile U64 sink;
+
+//--------------------------------------------------------------------------------------------------
+
+BenchRegistrar::BenchRegistrar(Str name, SrcLoc sl, BenchFn* benchFn) {
+	Assert(benchesLen < MaxBenches);
+	benches[benchesLen++] = {
+		.name    = name,
+		.sl      = sl,
+		.benchFn = benchFn,
+	};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Report(Str label, U64 ticks, U64 ops) {
+	F64 const mils = Time::Mils(ticks);
+	Logf("  %-32s %10.3f ms %14.2f ns/op", label, mils, ops ? (mils * 1000000.0 / (F64)ops) : 0.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Consume(U64 u) {
+	sink = sink + u;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Run() {
+	Mem const benchMem = Mem::Create(16 * GB);
+	Mem const tempMem  = Mem::Create(1 * GB);
+
+	Time::Init();
+	StrDb::Init();
+	File::Init(tempMem);
+	Log::Init(tempMem);
+
+	auto logFn = [](Log::Msg const* msg) {
+		Sys::Print(Str(msg->line, msg->lineLen));
+		if (Sys::DbgPresent()) {
+			Sys::DbgPrint(msg->line);
+		}
+	};
+	Log::AddFn(logFn);
+
+	for (U32 i = 0; i < benchesLen; i++) {
+		Logf("%s", benches[i].name);
+		benches[i].benchFn(benchMem);
+		Mem::Reset(benchMem, MemMark());
+		Mem::Reset(tempMem, MemMark());
+	}
+
+	Log::RemoveFn(logFn);
+	File::Shutdown();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Bench
\ No newline at end of file
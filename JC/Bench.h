@@ -0,0 +1,35 @@
+#pragma once
+
+#include "JC/Common.h"
+
+namespace JC::Bench {
+
+//--------------------------------------------------------------------------------------------------
+
+// Benchmarks register like unit tests and run with "<exe> bench".
+// Each one times its own cases and calls Report(); benchMem is reset after it returns.
+
+void Run();
+
+void Report(Str label, U64 ticks, U64 ops);
+
+// Keeps a result alive so the optimizer can't drop the work that produced it
+void Consume(U64 u);
+
+using BenchFn = void([[maybe_unused]] Mem benchMem);
+
+struct BenchRegistrar {
+	BenchRegistrar(Str name, SrcLoc sl, BenchFn* fn);
+};
+
+#define Bench_DefImpl(name, fn, registrarVar) \
+	static void fn([[maybe_unused]] Mem benchMem); \
+	static Bench::BenchRegistrar registrarVar = Bench::BenchRegistrar(name, SrcLoc::Here(), fn); \
+	static void fn([[maybe_unused]] Mem benchMem)
+
+#define Bench_Def(name) \
+	Bench_DefImpl(name, MacroUniqueName(Bench_Fn_), MacroUniqueName(Bench_Registrar_))
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Bench
\ No newline at end of file
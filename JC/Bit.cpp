@@ -18,7 +18,10 @@ U32 Bsr64(U64 u) {
 		U32 idx;
 		_BitScanReverse64((unsigned long*)&idx, u);
 		return idx;
-	#endif	// Compiler_Msvc
+	#elif defined Compiler_Gcc
+		if (u == 0) { return 0; }
+		return 63 - (U32)__builtin_clzll(u);
+	#endif	// Compiler
 }
 
 U32 Bsf64(U64 u) {
@@ -27,7 +30,10 @@ U32 Bsf64(U64 u) {
 		U32 idx;
 		_BitScanForward64((unsigned long*)&idx, u);
 		return idx;
-	#endif	// Compiler_Msvc
+	#elif defined Compiler_Gcc
+		if (u == 0) { return 0; }
+		return (U32)__builtin_ctzll(u);
+	#endif	// Compiler
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -35,13 +41,17 @@ U32 Bsf64(U64 u) {
 U32 PopCount32(U32 u) {
 	#if defined Compiler_Msvc
 		return (U32)__popcnt(u);
-	#endif	// Compiler_Msvc
+	#elif defined Compiler_Gcc
+		return (U32)__builtin_popcount(u);
+	#endif	// Compiler
 }
 
 U32 PopCount64(U64 u) {
 	#if defined Compiler_Msvc
 		return (U32)__popcnt64(u);
-	#endif	// Compiler_Msvc
+	#elif defined Compiler_Gcc
+		return (U32)__builtin_popcountll(u);
+	#endif	// Compiler
 }
 
 //--------------------------------------------------------------------------------------------------
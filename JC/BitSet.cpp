@@ -0,0 +1,287 @@
+#include "JC/BitSet.h"
+
+#include "JC/Bench.h"
+#include "JC/Rng.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+#if defined Compiler_Msvc
+	#include <intrin.h>
+	#define Avx2Fn	// Msvc takes AVX2 intrinsics without /arch:AVX2
+#elif defined Compiler_Gcc
+	#include <cpuid.h>
+	#include <immintrin.h>
+	#define Avx2Fn __attribute__((target("avx2")))
+#endif	// Compiler
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// AVX2 needs the CPU bit and the OS saving YMM state across context switches
+static bool DetectAvx2() {
+	#if defined Compiler_Msvc
+		int regs[4];
+		__cpuid(regs, 0);
+		if (regs[0] < 7) { return false; }
+		__cpuid(regs, 1);
+		if (!(regs[2] & (1 << 27)) || !(regs[2] & (1 << 28))) { return false; }	// OSXSAVE, AVX
+		if ((_xgetbv(0) & 6) != 6) { return false; }	// XMM and YMM state
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+	#elif defined Compiler_Gcc
+		__builtin_cpu_init();	// we may run before the runtime's own init
+		return __builtin_cpu_supports("avx2");
+	#endif	// Compiler
+}
+
+bool const Bit::hasAvx2 = DetectAvx2();
+
+Avx2Fn void Bit::AndWordsAvx2(U64* dst, U64 const* src, U32 n) {
+	for (U32 i = 0; i + 4 <= n; i += 4) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*)(dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_and_si256(a, b));
+	}
+}
+
+Avx2Fn void Bit::OrWordsAvx2(U64* dst, U64 const* src, U32 n) {
+	for (U32 i = 0; i + 4 <= n; i += 4) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*)(dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(a, b));
+	}
+}
+
+Avx2Fn void Bit::AndNotWordsAvx2(U64* dst, U64 const* src, U32 n) {
+	for (U32 i = 0; i + 4 <= n; i += 4) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*)(dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_andnot_si256(b, a));	// ~b & a
+	}
+}
+
+// AVX2 has no vector popcount: count nibbles through a 16-entry shuffle table and sum the bytes
+// with SAD (Mula, Kurz & Lemire)
+Avx2Fn U64 Bit::PopCountWordsAvx2(U64 const* words, U32 n) {
+	__m256i const lut  = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	__m256i const mask = _mm256_set1_epi8(0x0f);
+	__m256i acc = _mm256_setzero_si256();
+	for (U32 i = 0; i + 4 <= n; i += 4) {
+		__m256i const v  = _mm256_loadu_si256((__m256i const*)(words + i));
+		__m256i const lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+		__m256i const hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+		acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+	}
+	return (U64)_mm256_extract_epi64(acc, 0) + (U64)_mm256_extract_epi64(acc, 1) + (U64)_mm256_extract_epi64(acc, 2) + (U64)_mm256_extract_epi64(acc, 3);
+}
+
+Avx2Fn U32 Bit::FindFirstBlockAvx2(U64 const* words, U32 n) {
+	U32 i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i const v = _mm256_loadu_si256((__m256i const*)(words + i));
+		if (!_mm256_testz_si256(v, v)) { break; }
+	}
+	return i;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("BitSet") {
+	Unit_SubTest("Get/Set/Clear") {
+		BitSet<200> b;
+		Unit_Check(!b.Any());
+		Unit_CheckEq(b.FindFirst(), Bit::NotFound);
+		b.Set(0);
+		b.Set(63);
+		b.Set(64);
+		b.Set(199);
+		Unit_Check(b.Get(0) && b.Get(63) && b.Get(64) && b.Get(199));
+		Unit_Check(!b.Get(1) && !b.Get(65) && !b.Get(198));
+		Unit_CheckEq(b.PopCount(), 4u);
+		b.Clear(0);
+		Unit_CheckEq(b.FindFirst(), 63u);
+		b.ClearAll();
+		Unit_Check(!b.Any());
+
+		b.SetAll();
+		Unit_CheckEq(b.PopCount(), 200u);	// nothing past N
+		b.Clear(199);
+		Unit_CheckEq(b.PopCount(), 199u);
+	}
+
+	Unit_SubTest("Set ops") {
+		BitSet<256> a;
+		BitSet<256> b;
+		for (U32 i = 0; i < 256; i += 2) { a.Set(i); }
+		for (U32 i = 0; i < 256; i += 3) { b.Set(i); }
+
+		BitSet<256> c = a;
+		c.And(b);
+		U32 errors = 0;
+		for (U32 i = 0; i < 256; i++) { errors += c.Get(i) != (i % 6 == 0); }
+		Unit_CheckEq(c.PopCount(), 43u);
+
+		c = a;
+		c.Or(b);
+		for (U32 i = 0; i < 256; i++) { errors += c.Get(i) != (i % 2 == 0 || i % 3 == 0); }
+
+		c = a;
+		c.AndNot(b);
+		for (U32 i = 0; i < 256; i++) { errors += c.Get(i) != (i % 2 == 0 && i % 3 != 0); }
+		Unit_CheckEq(c.FindFirst(), 2u);
+		Unit_CheckEq(errors, 0u);
+	}
+
+	Unit_SubTest("ForEachSet") {
+		BitSet<130> b;
+		b.Set(3);
+		b.Set(64);
+		b.Set(129);
+		U32 bits[4] = {};
+		U32 bitsLen = 0;
+		b.ForEachSet([&](U32 i) { bits[bitsLen++] = i; });
+		Unit_CheckEq(bitsLen, 3u);
+		Unit_CheckEq(bits[0], 3u);
+		Unit_CheckEq(bits[1], 64u);
+		Unit_CheckEq(bits[2], 129u);
+	}
+
+	Unit_SubTest("DynBitSet") {
+		// Long enough for the four-words-at-a-time paths, with a ragged tail
+		constexpr U32 Len = 64 * 37 + 5;
+		DynBitSet a(testMem, Len);
+		DynBitSet b(testMem, Len);
+		bool* const model = Mem::AllocT<bool>(testMem, Len);
+		Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+		for (U32 i = 0; i < Len; i++) {
+			U64 const rng = Rng::NextU64(&gen);
+			if (rng & 1) { a.Set(i); model[i] = true; }
+			if (rng & 2) { b.Set(i); }
+		}
+		U32 expected = 0;
+		for (U32 i = 0; i < Len; i++) { expected += model[i]; }
+		Unit_CheckEq(a.PopCount(), expected);
+
+		a.AndNot(b);
+		expected = 0;
+		U32 errors = 0;
+		for (U32 i = 0; i < Len; i++) {
+			model[i] = model[i] && !b.Get(i);
+			expected += model[i];
+			errors += a.Get(i) != model[i];
+		}
+		Unit_CheckEq(errors, 0u);
+		Unit_CheckEq(a.PopCount(), expected);
+
+		a.ClearAll();
+		a.Set(Len - 1);
+		Unit_CheckEq(a.FindFirst(), Len - 1);
+		a.SetAll();
+		Unit_CheckEq(a.PopCount(), Len);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// A pathfinder's visited set: clear, then a few hundred random tests and sets over 256 hexes
+Bench_Def("Visited set: bool[] vs BitSet") {
+	constexpr U32 Hexes  = 256;
+	constexpr U32 Builds = 200000;
+	constexpr U32 Visits = 400;
+
+	U16* const idxs = Mem::AllocUninitT<U16>(benchMem, Visits);
+	Rng::Gen gen = Rng::MakeGen(0x243f6a8885a308d3);
+	for (U32 i = 0; i < Visits; i++) {
+		idxs[i] = (U16)(Rng::NextU64(&gen) % Hexes);
+	}
+
+	U64 sum = 0;
+	bool visitedBools[Hexes];
+	U64 start = Time::Now();
+	for (U32 b = 0; b < Builds; b++) {
+		memset(visitedBools, 0, sizeof(visitedBools));
+		for (U32 i = 0; i < Visits; i++) {
+			if (!visitedBools[idxs[i]]) {
+				visitedBools[idxs[i]] = true;
+				sum++;
+			}
+		}
+		Bench::Consume(visitedBools[b % Hexes]);
+	}
+	U64 const boolTicks = Time::Now() - start;
+
+	BitSet<Hexes> visitedBits;
+	start = Time::Now();
+	for (U32 b = 0; b < Builds; b++) {
+		visitedBits.ClearAll();
+		for (U32 i = 0; i < Visits; i++) {
+			if (!visitedBits.Get(idxs[i])) {
+				visitedBits.Set(idxs[i]);
+				sum++;
+			}
+		}
+		Bench::Consume(visitedBits.words[b % visitedBits.WordsLen]);
+	}
+	U64 const bitsTicks = Time::Now() - start;
+
+	Bench::Report("bool[]", boolTicks, (U64)Builds * Visits);
+	Bench::Report("BitSet", bitsTicks, (U64)Builds * Visits);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// A threat overlay: union of 64 units' reach masks, minus one mask, counted
+Bench_Def("Threat overlay: bool[] vs BitSet") {
+	constexpr U32 Hexes  = 256;
+	constexpr U32 Units  = 64;
+	constexpr U32 Builds = 100000;
+
+	bool (*const reachBools)[Hexes] = (bool (*)[Hexes])Mem::AllocT<bool>(benchMem, Units * Hexes);
+	BitSet<Hexes>* const reachBits = Mem::AllocT<BitSet<Hexes>>(benchMem, Units);
+	Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+	for (U32 u = 0; u < Units; u++) {
+		for (U32 i = 0; i < Hexes; i++) {
+			if ((Rng::NextU64(&gen) & 15) == 0) {
+				reachBools[u][i] = true;
+				reachBits[u].Set(i);
+			}
+		}
+	}
+
+	U64 sum = 0;
+	U64 start = Time::Now();
+	for (U32 b = 0; b < Builds; b++) {
+		bool threat[Hexes] = {};
+		for (U32 u = 0; u < Units; u++) {
+			for (U32 i = 0; i < Hexes; i++) {
+				threat[i] |= reachBools[u][i];
+			}
+		}
+		U32 const exclude = b % Units;
+		for (U32 i = 0; i < Hexes; i++) {
+			sum += threat[i] && !reachBools[exclude][i];
+		}
+	}
+	U64 const boolTicks = Time::Now() - start;
+
+	start = Time::Now();
+	for (U32 b = 0; b < Builds; b++) {
+		BitSet<Hexes> threat;
+		for (U32 u = 0; u < Units; u++) {
+			threat.Or(reachBits[u]);
+		}
+		threat.AndNot(reachBits[b % Units]);
+		sum += threat.PopCount();
+	}
+	U64 const bitsTicks = Time::Now() - start;
+
+	Bench::Report("bool[]", boolTicks, Builds);
+	Bench::Report("BitSet", bitsTicks, Builds);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Bit.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Bulk ops over runs of U64 words, shared by BitSet and DynBitSet.
+// Runs of Avx2MinWords or more go four words at a time through BitSet.cpp's AVX2 versions when the
+// CPU has AVX2, checked once at startup so the same build runs on any x64. Shorter runs, the tail
+// of a run, and CPUs without it go a word at a time: a 256-hex set is four words, a handful of
+// instructions either way, not 256 byte compares.
+namespace Bit {
+
+constexpr U32 Avx2MinWords = 8;	// below this the call costs more than the vector loop saves
+
+extern bool const hasAvx2;
+
+// Each does the whole 4-word blocks of the run, n & ~3 words, and leaves the tail to the caller
+void AndWordsAvx2   (U64* dst, U64 const* src, U32 n);
+void OrWordsAvx2    (U64* dst, U64 const* src, U32 n);
+void AndNotWordsAvx2(U64* dst, U64 const* src, U32 n);
+U64  PopCountWordsAvx2(U64 const* words, U32 n);
+U32  FindFirstBlockAvx2(U64 const* words, U32 n);	// the first word of the first nonzero block, else n & ~3
+
+inline bool UseAvx2(U32 n) { return n >= Avx2MinWords && hasAvx2; }
+
+inline void AndWords(U64* dst, U64 const* src, U32 n) {
+	U32 i = 0;
+	if (UseAvx2(n)) { AndWordsAvx2(dst, src, n); i = n & ~3u; }
+	for (; i < n; i++) { dst[i] &= src[i]; }
+}
+
+inline void OrWords(U64* dst, U64 const* src, U32 n) {
+	U32 i = 0;
+	if (UseAvx2(n)) { OrWordsAvx2(dst, src, n); i = n & ~3u; }
+	for (; i < n; i++) { dst[i] |= src[i]; }
+}
+
+inline void AndNotWords(U64* dst, U64 const* src, U32 n) {
+	U32 i = 0;
+	if (UseAvx2(n)) { AndNotWordsAvx2(dst, src, n); i = n & ~3u; }
+	for (; i < n; i++) { dst[i] &= ~src[i]; }
+}
+
+inline U32 PopCountWords(U64 const* words, U32 n) {
+	U32 i = 0;
+	U64 count = 0;
+	if (UseAvx2(n)) { count = PopCountWordsAvx2(words, n); i = n & ~3u; }
+	for (; i < n; i++) { count += PopCount64(words[i]); }
+	return (U32)count;
+}
+
+constexpr U32 NotFound = U32Max;
+
+inline U32 FindFirstWords(U64 const* words, U32 n) {
+	U32 i = UseAvx2(n) ? FindFirstBlockAvx2(words, n) : 0;
+	for (; i < n; i++) {
+		if (words[i]) { return (i << 6) + Bsf64(words[i]); }
+	}
+	return NotFound;
+}
+
+inline bool AnyWords(U64 const* words, U32 n) {
+	return FindFirstWords(words, n) != NotFound;
+}
+
+// fn(U32 bit) may clear the bit it's passed, but not set later ones
+template <class F> void ForEachSetWords(U64 const* words, U32 n, F&& fn) {
+	for (U32 w = 0; w < n; w++) {
+		U64 word = words[w];
+		while (word) {
+			U32 const i = (w << 6) + Bsf64(word);
+			word &= word - 1;
+			fn(i);
+		}
+	}
+}
+
+}	// namespace Bit
+
+//--------------------------------------------------------------------------------------------------
+
+// Fixed-size bit set, a value type: copy it, memset it, embed it.
+// Bits at and past N in the last word are always zero, so PopCount() and FindFirst() need no masking.
+template <U32 N> struct BitSet {
+	static_assert(N > 0);
+	static constexpr U32 Len      = N;
+	static constexpr U32 WordsLen = (N + 63) / 64;
+
+	U64 words[WordsLen] = {};
+
+	bool Get  (U32 i) const { Assert(i < N); return (words[i >> 6] >> (i & 63)) & 1; }
+	void Set  (U32 i)       { Assert(i < N); words[i >> 6] |=  (U64)1 << (i & 63); }
+	void Clear(U32 i)       { Assert(i < N); words[i >> 6] &= ~((U64)1 << (i & 63)); }
+
+	void ClearAll() { memset(words, 0, sizeof(words)); }
+	void SetAll() {
+		memset(words, 0xff, sizeof(words));
+		if constexpr (N % 64) {
+			words[WordsLen - 1] = ((U64)1 << (N % 64)) - 1;
+		}
+	}
+
+	void And   (BitSet const& b) { Bit::AndWords   (words, b.words, WordsLen); }
+	void Or    (BitSet const& b) { Bit::OrWords    (words, b.words, WordsLen); }
+	void AndNot(BitSet const& b) { Bit::AndNotWords(words, b.words, WordsLen); }
+
+	U32  PopCount()  const { return Bit::PopCountWords (words, WordsLen); }
+	U32  FindFirst() const { return Bit::FindFirstWords(words, WordsLen); }	// Bit::NotFound if empty
+	bool Any()       const { return Bit::AnyWords      (words, WordsLen); }
+
+	template <class F> void ForEachSet(F&& fn) const { Bit::ForEachSetWords(words, WordsLen, fn); }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+// BitSet with its length picked at runtime and its words allocated from a Mem.
+// Set ops require both sides to have the same len.
+struct DynBitSet {
+	U64* words    = 0;
+	U32  len      = 0;
+	U32  wordsLen = 0;
+
+	DynBitSet() = default;
+
+	DynBitSet(Mem mem, U32 lenIn) { Init(mem, lenIn); }
+
+	void Init(Mem mem, U32 lenIn) {
+		len      = lenIn;
+		wordsLen = (lenIn + 63) / 64;
+		words    = Mem::AllocT<U64>(mem, wordsLen);
+	}
+
+	bool Get  (U32 i) const { Assert(i < len); return (words[i >> 6] >> (i & 63)) & 1; }
+	void Set  (U32 i)       { Assert(i < len); words[i >> 6] |=  (U64)1 << (i & 63); }
+	void Clear(U32 i)       { Assert(i < len); words[i >> 6] &= ~((U64)1 << (i & 63)); }
+
+	void ClearAll() { memset(words, 0, wordsLen * sizeof(U64)); }
+	void SetAll() {
+		memset(words, 0xff, wordsLen * sizeof(U64));
+		if (len % 64) {
+			words[wordsLen - 1] = ((U64)1 << (len % 64)) - 1;
+		}
+	}
+
+	void And   (DynBitSet const& b) { Assert(b.len == len); Bit::AndWords   (words, b.words, wordsLen); }
+	void Or    (DynBitSet const& b) { Assert(b.len == len); Bit::OrWords    (words, b.words, wordsLen); }
+	void AndNot(DynBitSet const& b) { Assert(b.len == len); Bit::AndNotWords(words, b.words, wordsLen); }
+
+	U32  PopCount()  const { return Bit::PopCountWords (words, wordsLen); }
+	U32  FindFirst() const { return Bit::FindFirstWords(words, wordsLen); }	// Bit::NotFound if empty
+	bool Any()       const { return Bit::AnyWords      (words, wordsLen); }
+
+	template <class F> void ForEachSet(F&& fn) const { Bit::ForEachSetWords(words, wordsLen, fn); }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "JC/Hash.h"
 #include "JC/Map.h"
+#include "JC/UnitTest.h"
 
 namespace JC::Cfg {
 
@@ -16,14 +17,39 @@ struct Cfg {
 static constexpr U32 MaxCfgs = 1024;
 
 static Array<Cfg>     cfgs;
-static Map<Str, Cfg*> cfgsMap;
+static Map<Str, Cfg*> cfgsMap;	// keyed by the caller's name: a literal or argv, which outlive us
 
 //--------------------------------------------------------------------------------------------------
 
+// Command-line args of the form Name=Val, e.g. App.Pipelined=1. Init() runs before the app's
+// PreInit(), so an app only overrides these by setting a cfg itself. A Val that's all digits sets
+// the U32 too.
 void Init(Mem permMem, int argc, char const* const* argv) {
-	argc;argv;
 	cfgs.Init(permMem, MaxCfgs);
-	cfgsMap.Init(permMem, MaxCfgs);
+	cfgsMap.Init(permMem, MapCapFor(MaxCfgs));
+
+	for (int i = 1; i < argc; i++) {
+		Str const arg = argv[i];
+		U32 eq = 0;
+		while (eq < arg.len && arg[eq] != '=') {
+			eq++;
+		}
+		if (eq == 0 || eq == arg.len) {
+			continue;
+		}
+		Str const name = Str(arg.data, eq);
+		Str const val  = Str(arg.data + eq + 1, arg.len - eq - 1);
+		SetStr(name, val);
+		U32  u32    = 0;
+		bool digits = val.len > 0;
+		for (U32 j = 0; j < val.len && digits; j++) {
+			digits = val[j] >= '0' && val[j] <= '9';
+			u32 = u32 * 10 + (U32)(val[j] - '0');
+		}
+		if (digits) {
+			SetU32(name, u32);
+		}
+	}
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -84,4 +110,18 @@ void SetU32(Str name, U32 val) {
 
 //--------------------------------------------------------------------------------------------------
 
+Unit_Test("Cfg.Args") {
+	char const* const argv[] = { "Game.exe", "App.Pipelined=1", "App.Title=Some Title", "App.Width=12x", "=3", "NoEquals" };
+	Init(testMem, (int)LenOf(argv), argv);
+	Unit_CheckEq(GetU32("App.Pipelined", 0), 1u);
+	Unit_Check(GetStr("App.Title", "") == "Some Title");
+	Unit_Check(GetStr("App.Width", "") == "12x");
+	Unit_CheckEq(GetU32("App.Width", 7), 0u);	// set by the arg, as a Str only
+	Unit_CheckEq(GetU32("NoEquals", 5), 5u);
+	SetU32("App.Pipelined", 0);
+	Unit_CheckEq(GetU32("App.Pipelined", 1), 0u);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 }	// namespace JC::Cfg
\ No newline at end of file
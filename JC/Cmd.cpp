@@ -30,7 +30,7 @@ static Map<Str, CmdObj*> cmdObjMap;
 void Init(Mem permMem) {
 	cmdObjs = Mem::AllocT<CmdObj>(permMem, MaxCmds);
 	cmdObjsLen = 0;
-	cmdObjMap.Init(permMem, MaxCmds);
+	cmdObjMap.Init(permMem, MapCapFor(MaxCmds));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1,17 +1,21 @@
 #pragma once
 
-namespace std {
-	template <class T> struct initializer_list {
-		const T* _begin = 0;
-		const T* _end   = 0;
-
-		constexpr initializer_list() = default;
-		constexpr initializer_list(const T* b, const T* e) { _begin = b; _end = e; }
-		constexpr const T* begin() const { return _begin; }
-		constexpr const T* end() const { return _end; }
-		constexpr size_t size() const { return _end - _begin; }
-	};
-}	// namespace std
+#if defined _MSC_VER
+	namespace std {
+		template <class T> struct initializer_list {
+			const T* _begin = 0;
+			const T* _end   = 0;
+
+			constexpr initializer_list() = default;
+			constexpr initializer_list(const T* b, const T* e) { _begin = b; _end = e; }
+			constexpr const T* begin() const { return _begin; }
+			constexpr const T* end() const { return _end; }
+			constexpr size_t size() const { return _end - _begin; }
+		};
+	}	// namespace std
+#else
+	#include <initializer_list>
+#endif	// _MSC_VER
 
 namespace JC {
 
@@ -20,7 +24,10 @@ namespace JC {
 #if defined _MSC_VER
 	#define Platform_Windows
 	#define Compiler_Msvc
-#endif	// _MSC_VER
+#elif defined __linux__
+	#define Platform_Linux
+	#define Compiler_Gcc	// also clang
+#endif	// Platform
 
 //--------------------------------------------------------------------------------------------------
 
@@ -54,6 +61,35 @@ namespace JC {
 	#define OffsetOf(type, member) __builtin_offsetof(type, member)
 	#define IfConstEval if (__builtin_is_constant_evaluated())
 	#define DbgBreak __debugbreak()
+#elif defined Compiler_Gcc
+	using I8  = signed char;
+	using I16 = signed short;
+	using I32 = signed int;
+	using I64 = signed long long;
+
+	using U8  = unsigned char;
+	using U16 = unsigned short;
+	using U32 = unsigned int;
+	using U64 = unsigned long long;
+
+	using F32 = float;
+	using F64 = double;
+
+	constexpr F32 F32Max = 3.402823466e+38f;
+	constexpr F64 F64Max = 1.7976931348623158e+308;
+
+	extern "C" {
+		using size_t = decltype(sizeof(0));
+		void*  memcpy(void* dst, const void* src, size_t size);
+		void*  memmove(void* dst, const void* src, size_t size);
+		int    memcmp(const void* p1, const void* p2, size_t size);
+		void*  memset(void* p, int val, size_t n);
+		size_t strlen(char const* s);
+		int    strcmp(char const* s1, char const* s2);
+	}
+	#define OffsetOf(type, member) __builtin_offsetof(type, member)
+	#define IfConstEval if (__builtin_is_constant_evaluated())
+	#define DbgBreak __builtin_trap()
 #endif	// Compiler
 
 constexpr U32 U16Max = (U16)0xffff;
@@ -221,7 +257,7 @@ struct Arg {
 
 //--------------------------------------------------------------------------------------------------
 
-#if defined Compiler_Msvc
+#if defined Compiler_Msvc || defined Compiler_Gcc
 	#define SrcLoc_File __builtin_FILE()
 	#define SrcLoc_Line ((U32)__builtin_LINE())
 #endif	// Compiler
@@ -243,19 +279,50 @@ struct MemMark {
 	SrcLoc lastAllocSl;
 };
 
+// Page size backing a virtual reservation.
+// Huge pages cut TLB misses on large, randomly accessed arenas, at the cost of committing in
+// Sys::HugePageSize steps.
+enum struct PageKind : U8 {
+	Normal,
+	Huge,	// transparent huge pages where supported, normal pages otherwise
+	HugeExplicit,	// preallocated huge page pool where supported, taken per 2MB commit: chunks it can't cover fall back to Huge
+};
+
 struct Mem {
 	U64 handle = 0;
 	operator bool() const { return handle != 0; }
 
-	static Mem                        Create(U64 reserveSize);
+	static Mem                        Create(U64 reserveSize, PageKind pageKind = PageKind::Normal);
+	static Mem                        CreateHeap(U64 reserveSize);
+	static void                       Destroy(Mem mem);
+	static Mem                        GetScratchImpl(Mem const* conflicts, U32 conflictsLen);
+	static void                       ShutdownScratch();
 	static void*                      Alloc(Mem mem, U64 size, SrcLoc sl = SrcLoc::Here());
+	static void*                      AllocAligned(Mem mem, U64 size, U64 align, SrcLoc sl = SrcLoc::Here());
+	static void*                      AllocUninit(Mem mem, U64 size, SrcLoc sl = SrcLoc::Here());
+	static void*                      AllocUninitAligned(Mem mem, U64 size, U64 align, SrcLoc sl = SrcLoc::Here());
 	static void*                      Realloc(Mem mem, void* oldPtr, U64 oldSize, U64 newSize, SrcLoc sl = SrcLoc::Here());
+	static void*                      ReallocAligned(Mem mem, void* oldPtr, U64 oldSize, U64 newSize, U64 align, SrcLoc sl = SrcLoc::Here());
+	static void                       Free(Mem mem, void* p);
 	static MemMark                    Mark(Mem mem);
 	static void                       Reset(Mem mem, MemMark mark);
-	template <class T> static T*      AllocT(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::Alloc(mem, n * sizeof(T), sl); }
-	template <class T> static T*      AllocT(Mem mem, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::Alloc(mem, sizeof(T), sl); }
-	template <class T> static Span<T> AllocSpan(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return Span<T>((T*)Mem::Alloc(mem, n * sizeof(T), sl), n); }
-	template <class T> static T*      ReallocT(Mem mem, T* oldPtr, U64 oldN, U64 newN, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::Realloc(mem, oldPtr, oldN * sizeof(T), newN * sizeof(T), sl); }
+	static U64                        Trim(Mem mem);
+	static void                       EnableTrace(bool enable, U32 reportFrames = 0);
+	static void                       TraceFrame();
+	static void                       TraceReport(U32 maxSites);
+	template <class T> static T*      AllocT(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::AllocAligned(mem, n * sizeof(T), alignof(T), sl); }
+	template <class T> static T*      AllocT(Mem mem, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::AllocAligned(mem, sizeof(T), alignof(T), sl); }
+	template <class T> static Span<T> AllocSpan(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return Span<T>((T*)Mem::AllocAligned(mem, n * sizeof(T), alignof(T), sl), n); }
+	template <class T> static T*      AllocUninitT(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::AllocUninitAligned(mem, n * sizeof(T), alignof(T), sl); }
+	template <class T> static Span<T> AllocUninitSpan(Mem mem, U64 n, SrcLoc sl = SrcLoc::Here()) { return Span<T>((T*)Mem::AllocUninitAligned(mem, n * sizeof(T), alignof(T), sl), n); }
+	template <class T> static T*      ReallocT(Mem mem, T* oldPtr, U64 oldN, U64 newN, SrcLoc sl = SrcLoc::Here()) { return (T*)Mem::ReallocAligned(mem, oldPtr, oldN * sizeof(T), newN * sizeof(T), alignof(T), sl); }
+
+	// Returns one of the calling thread's scratch arenas, never one of `conflicts`.
+	// Pass every arena the caller may be returning results in, then MemScope() the scratch.
+	template <class... M> static Mem GetScratch(M... conflicts) {
+		Mem const conflictsArr[sizeof...(M) + 1] = { conflicts..., Mem() };	// + 1 to allow zero args
+		return GetScratchImpl(conflictsArr, sizeof...(M));
+	}
 };
 
 struct MemScopeObj {
@@ -276,6 +343,11 @@ struct NamedArg {
 	Arg arg;
 };
 
+struct ErrMark {
+	U32 errsLen   = 0;
+	U64 strBufLen = 0;
+};
+
 struct [[nodiscard]] Err {
 	static constexpr U32 MaxNamedArgs = 32;
 
@@ -308,6 +380,8 @@ struct [[nodiscard]] Err {
 
 	static void SetBreakOnErr(bool breakOnErr);
 	static void Update(U64 frame);
+	static ErrMark Mark();
+	static void Reset(ErrMark mark);
 };
 
 
@@ -422,8 +496,8 @@ template <class... A> struct _CheckFmtStr {
 
 	operator char const*() const { return fmt; }
 
-	template <class... A> consteval void Check() {
-		constexpr Arg::Type argTypes[sizeof...(A) + 1] = { Arg::Make(A()).type... };
+	template <class... CA> consteval void Check() {
+		constexpr Arg::Type argTypes[sizeof...(CA) + 1] = { Arg::Make(CA()).type... };
 
 		U32 argIdx = 0;
 
@@ -431,7 +505,7 @@ template <class... A> struct _CheckFmtStr {
 		for (;;) {
 			while (*f != '%') {
 				if (*f == 0) {
-					if (argIdx < sizeof...(A)) { CheckFmtStr_TooManyArgs(); }
+					if (argIdx < sizeof...(CA)) { CheckFmtStr_TooManyArgs(); }
 					return;
 				}
 				f++;
@@ -464,7 +538,7 @@ template <class... A> struct _CheckFmtStr {
 				}
 			}
 
-			if (argIdx >= sizeof...(A)) { CheckFmtStr_NotEnoughArgs(); }
+			if (argIdx >= sizeof...(CA)) { CheckFmtStr_NotEnoughArgs(); }
 			switch (*f) {
 				case 't': if (argTypes[argIdx] != Arg::Type::Bool) { CheckFmtStr_t_Arg_NotBool(); } break;
 				case 'c': if (argTypes[argIdx] != Arg::Type::Char) { CheckFmtStr_c_Arg_NotChar(); } break;
@@ -513,6 +587,7 @@ struct StrBuf {
 	StrBuf() = default;
 	StrBuf(Mem mem);
 	void Init(Mem mem);
+	void Shutdown();
 	void Add(char c, SrcLoc sl = SrcLoc::Here());
 	void Add(char c, U32 n, SrcLoc sl = SrcLoc::Here());
 	void Add(char const* str, U32 strLen, SrcLoc sl = SrcLoc::Here());
@@ -11,12 +11,13 @@ namespace JC {
 static constexpr U32 MaxErrs   = 256;
 static constexpr U32 MaxStrBuf = 64 * 1024;
 
-static Err  errs[MaxErrs];
-static U32  errsLen = 1;	// reserve index 0 for invalid
-static U64  errFrame;
-static char errStrBuf[MaxStrBuf];
-static U64  errStrBufLen;
-static bool errBreakOnErr = false;
+// Each thread builds errors in its own store, so jobs can fail without racing the main loop's Update()
+static thread_local Err  errs[MaxErrs];
+static thread_local U32  errsLen = 1;	// reserve index 0 for invalid
+static thread_local U64  errFrame;
+static thread_local char errStrBuf[MaxStrBuf];
+static thread_local U64  errStrBufLen;
+static bool              errBreakOnErr = false;
 
 //--------------------------------------------------------------------------------------------------
 
@@ -50,8 +51,8 @@ static Arg CloneArg(Arg arg) {
 
 //--------------------------------------------------------------------------------------------------
 
-static bool                               recursive = false;
-static Array<NamedArg, Err::MaxNamedArgs> pushedNamedArgs;
+static thread_local bool                               recursive = false;
+static thread_local Array<NamedArg, Err::MaxNamedArgs> pushedNamedArgs;
 
 Err const* Err::Makev(Err const* prev, SrcLoc sl, Str ns, Str sCode, U64 uCode, NamedArg const* namedArgs, U32 namedArgsLen) {
 	Assert(errsLen < MaxErrs);
@@ -107,6 +108,24 @@ void Err::Update(U64 frameIn) {
 	errFrame = frameIn;
 	memset(errs, 0, errsLen * sizeof(Err));
 	errsLen = 0;
+	errStrBufLen = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// For threads that don't run the frame loop: errors made after Mark() are recycled by Reset(), once
+// the caller has copied out whatever it needs from them
+ErrMark Err::Mark() {
+	return ErrMark { .errsLen = errsLen, .strBufLen = errStrBufLen };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Err::Reset(ErrMark mark) {
+	Assert(mark.errsLen <= errsLen && mark.strBufLen <= errStrBufLen);
+	memset(errs + mark.errsLen, 0, (errsLen - mark.errsLen) * sizeof(Err));
+	errsLen      = mark.errsLen;
+	errStrBufLen = mark.strBufLen;
 }
 
 //--------------------------------------------------------------------------------------------------
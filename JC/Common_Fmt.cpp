@@ -514,6 +514,16 @@ void StrBuf::Init(Mem memIn) {
 
 //--------------------------------------------------------------------------------------------------	
 
+// Only returns memory to heap arenas: see Mem::Free()
+void StrBuf::Shutdown() {
+	Mem::Free(mem, data);
+	data = 0;
+	len  = 0;
+	cap  = 0;
+}
+
+//--------------------------------------------------------------------------------------------------	
+
 void GrowStrBuf(StrBuf* sb, U32 n, SrcLoc sl) {
 	U32 const newCap = Max(sb->cap * 2, sb->len + n);
 	sb->data = Mem::ReallocT<char>(sb->mem, sb->data, sb->cap, newCap, sl);
@@ -1,68 +1,237 @@
 #include "JC/Common.h"
 
+#include "JC/Bench.h"
 #include "JC/Bit.h"
+#include "JC/Hash.h"
+#include "JC/Heap.h"
+#include "JC/Log.h"
+#include "JC/Map.h"
 #include "JC/Sys.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
 
 namespace JC {
 
 //--------------------------------------------------------------------------------------------------
 
 static_assert(Bit::IsPow2(Sys::VirtualPageSize));
+static_assert(Bit::IsPow2(Sys::HugePageSize));
 
 static constexpr U64 Align              = 8;
-static constexpr U32 MaxMemObjs         = 64;
+static constexpr U32 MaxMemObjs         = 256;
+static constexpr U32 MaxScratchMems     = 3;	// per thread: one more than the most conflicts any caller passes
+static constexpr U64 ScratchReserveSize = 4 * GB;
+static constexpr U32 TrimBuckets        = 8;
+static constexpr U32 TrimBucketFrames   = 32;	// 8 * 32 = 256 frames, ~4 seconds at 60hz
+static constexpr U32 TrimWindowFrames   = TrimBuckets * TrimBucketFrames;
+static constexpr U32 MaxTraceSites      = 16 * 1024;
+static constexpr U64 TraceReserveSize   = 1 * GB;
+static constexpr U32 TraceReportSites   = 32;
 
 struct MemObj {
 	U8*    begin = 0;
 	U8*    end = 0;
 	U8*    endCommit = 0;
 	U8*    endReserve = 0;
+	U64    pageSize = 0;	// commit granularity
 	U8*    lastAlloc = 0;
 	SrcLoc lastAllocSl;
+	U8*    peak = 0;	// highest end since the last Trim()
+	U64    trimPeaks[TrimBuckets] = {};
+	U64    trimFrames = 0;
+	Heap   heap;	// set for general-purpose arenas: everything above is unused
 };
 
-static MemObj memObjs[MaxMemObjs];
+// Arenas are single-owner: only Create/Destroy touch shared state, so only they take the lock.
+// Zero-init is a valid unlocked mutex.
+static MemObj     memObjs[MaxMemObjs];
+static Sys::Mutex memObjsMutex;
+
+static thread_local Mem scratchMems[MaxScratchMems];
 
 //--------------------------------------------------------------------------------------------------
 
-Mem Mem::Create(U64 reserveSize) {
+// Allocation telemetry lives in its own arena which is never itself traced.
+// All trace state is guarded by traceMutex since any thread's arenas may be traced.
+
+struct TraceKey {
+	char const* file;
+	U32         line;
+	U32         memIdx;
+};
+
+static bool operator==(TraceKey k1, TraceKey k2) { return k1.line == k2.line && k1.memIdx == k2.memIdx && k1.file == k2.file; }
+static U64 Hash(TraceKey k) { return JC::Hash(&k, sizeof(k)); }
+
+struct TraceStats {
+	U64 bytes;
+	U64 count;
+	U64 frameBytes;
+	U64 peakFrameBytes;
+};
+
+struct TraceSite {
+	TraceKey   key;
+	TraceStats stats;
+};
+
+static bool              traceEnabled;
+static U32               traceReportFrames;
+static U64               traceFrame;
+static Mem               traceMem;
+static Sys::Mutex        traceMutex;
+static TraceSite*        traceSites;
+static U32               traceSitesLen;
+static Map<TraceKey, U32> traceSiteIdxs;	// idx + 1 so zero means not found
+static TraceStats        traceMemStats[MaxMemObjs];
+
+static void TraceAlloc(Mem mem, U64 size, SrcLoc sl) {
+	if (mem.handle == traceMem.handle) {
+		return;
+	}
+	TraceKey const key = { .file = sl.file, .line = sl.line, .memIdx = (U32)mem.handle };
+
+	Sys::LockMutex(&traceMutex);
+	U32 idx = traceSiteIdxs.FindOrZero(key);
+	if (!idx) {
+		Assert(traceSitesLen < MaxTraceSites);
+		traceSites[traceSitesLen] = { .key = key };
+		idx = ++traceSitesLen;
+		traceSiteIdxs.Put(key, idx);
+	}
+	TraceStats* const siteStats = &traceSites[idx - 1].stats;
+	siteStats->bytes      += size;
+	siteStats->count      += 1;
+	siteStats->frameBytes += size;
+
+	TraceStats* const memStats = &traceMemStats[mem.handle];
+	memStats->bytes      += size;
+	memStats->count      += 1;
+	memStats->frameBytes += size;
+	Sys::UnlockMutex(&traceMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Huge page arenas suit large long-lived arenas with scattered access, like permMem's Maps.
+// They commit at least Sys::HugePageSize, so small or short-lived arenas should stay Normal. Where
+// Sys has no huge pages every arena commits in normal pages.
+Mem Mem::Create(U64 reserveSize, PageKind pageKind) {
 	Assert(Bit::IsPow2(reserveSize));
+	U64 const pageSize = (pageKind == PageKind::Normal || !Sys::HasHugePages) ? Sys::VirtualPageSize : Sys::HugePageSize;
+	Assert(reserveSize >= pageSize);
+
+	U8* const begin = (U8*)Sys::VirtualReserve(reserveSize, pageKind);
 
+	Sys::LockMutex(&memObjsMutex);
 	MemObj* memObj = 0;
 	for (U32 i = 1; i < MaxMemObjs; i++) {	// reserve zero
-		if (!memObjs[i].begin)
+		if (!memObjs[i].begin && !memObjs[i].heap)
 		{
 			memObj = &memObjs[i];
 			break;
 		}
 	}
 	Assert(memObj);
+	memObj->begin = begin;
+	Sys::UnlockMutex(&memObjsMutex);
 
-	memObj->begin       = (U8*)Sys::VirtualReserve(reserveSize);
 	memObj->end         = memObj->begin;
 	memObj->endCommit   = memObj->begin;
 	memObj->endReserve  = memObj->begin + reserveSize;
+	memObj->pageSize    = pageSize;
 	memObj->lastAlloc   = 0;
 	memObj->lastAllocSl = { .file = "", .line = 0 };
+	memObj->peak        = memObj->begin;
 
 	return Mem { .handle = (U64)(memObj - memObjs) };
 }
 
 //--------------------------------------------------------------------------------------------------
 
-void* Mem::Alloc(Mem mem, U64 size, SrcLoc sl) {
+// A general-purpose arena backed by a TLSF Heap: allocations can be individually freed with
+// Mem::Free() and Realloc() reuses memory, so long-lived growable containers don't leak their old
+// buffers. Mark/Reset/Trim aren't supported.
+Mem Mem::CreateHeap(U64 reserveSize) {
+	Heap const heap = Heap::Create(reserveSize);
+
+	Sys::LockMutex(&memObjsMutex);
+	MemObj* memObj = 0;
+	for (U32 i = 1; i < MaxMemObjs; i++) {	// reserve zero
+		if (!memObjs[i].begin && !memObjs[i].heap) {
+			memObj = &memObjs[i];
+			break;
+		}
+	}
+	Assert(memObj);
+	memObj->heap = heap;
+	Sys::UnlockMutex(&memObjsMutex);
+
+	return Mem { .handle = (U64)(memObj - memObjs) };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Mem::Destroy(Mem mem) {
 	Assert(mem);
 	Assert(mem.handle < MaxMemObjs);
 	MemObj* const memObj = &memObjs[mem.handle];
+	if (memObj->heap) {
+		Heap::Destroy(memObj->heap);
+	} else {
+		Assert(memObj->begin);
+		Sys::VirtualFree(memObj->begin);
+	}
 
-	size = Bit::AlignUp(size, Align);
+	Sys::LockMutex(&memObjsMutex);
+	*memObj = MemObj();
+	Sys::UnlockMutex(&memObjsMutex);
+}
 
-	Assert(memObj->endCommit >= memObj->end);
+//--------------------------------------------------------------------------------------------------
+
+Mem Mem::GetScratchImpl(Mem const* conflicts, U32 conflictsLen) {
+	for (U32 i = 0; i < MaxScratchMems; i++) {
+		bool conflict = false;
+		if (scratchMems[i]) {
+			for (U32 j = 0; j < conflictsLen; j++) {
+				if (scratchMems[i].handle == conflicts[j].handle) {
+					conflict = true;
+					break;
+				}
+			}
+		}
+		if (!conflict) {
+			if (!scratchMems[i]) {
+				scratchMems[i] = Create(ScratchReserveSize);
+			}
+			return scratchMems[i];
+		}
+	}
+	Panic("All %u scratch arenas conflict: pass fewer conflicts", MaxScratchMems);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Call from a thread before it exits to hand its scratch arenas back
+void Mem::ShutdownScratch() {
+	for (U32 i = 0; i < MaxScratchMems; i++) {
+		if (scratchMems[i]) {
+			Destroy(scratchMems[i]);
+			scratchMems[i] = Mem();
+		}
+	}
+}
 
+//--------------------------------------------------------------------------------------------------
+
+// Commits enough pages for size more bytes past end, doubling so commit stays a power of two
+static void EnsureCommit(MemObj* memObj, U64 size) {
+	Assert(memObj->endCommit >= memObj->end);
 	U64 const avail = (U64)(memObj->endCommit - memObj->end);
 	if (size > avail) {
 		U64 const curCommit = (U64)(memObj->endCommit - memObj->begin);
-		U64 nextCommit = Max(Sys::VirtualPageSize, curCommit);
+		U64 nextCommit = Max(memObj->pageSize, curCommit);
 		while (avail + (nextCommit - curCommit) < size) {
 			nextCommit *= 2;
 		}
@@ -70,55 +239,133 @@ void* Mem::Alloc(Mem mem, U64 size, SrcLoc sl) {
 		Sys::VirtualCommit(memObj->endCommit, nextCommit - curCommit);
 		memObj->endCommit  = memObj->begin + nextCommit;
 	}
-	U8* const oldEnd = memObj->end;
-	memObj->end += size;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void* AllocImpl(Mem mem, U64 size, U64 align, bool zero, SrcLoc sl) {
+	Assert(mem);
+	Assert(mem.handle < MaxMemObjs);
+	Assert(Bit::IsPow2(align) && align <= Sys::VirtualPageSize);
+	MemObj* const memObj = &memObjs[mem.handle];
+
+	if (memObj->heap) {
+		void* const p = Heap::AllocAligned(memObj->heap, size, align);
+		if (traceEnabled) {
+			TraceAlloc(mem, size, sl);
+		}
+		if (zero) {
+			memset(p, 0, size);
+		}
+		return p;
+	}
+
+	size = Bit::AlignUp(size, Align);
+	U8* const p = (U8*)Bit::AlignPtrUp(memObj->end, Max(align, Align));
+
+	EnsureCommit(memObj, (U64)(p - memObj->end) + size);
+	memObj->end = p + size;
 
 	Assert(memObj->end <= memObj->endCommit);
 	Assert(Bit::IsPow2(memObj->endCommit - memObj->begin));
 
-	memObj->lastAlloc = oldEnd;
+	memObj->lastAlloc = p;
 	memObj->lastAllocSl = sl;
+	if (memObj->end > memObj->peak) {
+		memObj->peak = memObj->end;
+	}
+
+	if (traceEnabled) {
+		TraceAlloc(mem, size, sl);
+	}
+
+	if (zero) {
+		memset(p, 0, size);
+	}
+	return p;
+}
+
+//--------------------------------------------------------------------------------------------------
 
-	memset(oldEnd, 0, size);
-	return oldEnd;
+void* Mem::Alloc(Mem mem, U64 size, SrcLoc sl) {
+	return AllocImpl(mem, size, Align, true, sl);
+}
+
+void* Mem::AllocAligned(Mem mem, U64 size, U64 align, SrcLoc sl) {
+	return AllocImpl(mem, size, align, true, sl);
+}
+
+// For buffers the caller overwrites in full straight away: skips the zero fill, which costs as
+// much as the write itself on multi-megabyte buffers.
+void* Mem::AllocUninit(Mem mem, U64 size, SrcLoc sl) {
+	return AllocImpl(mem, size, Align, false, sl);
+}
+
+void* Mem::AllocUninitAligned(Mem mem, U64 size, U64 align, SrcLoc sl) {
+	return AllocImpl(mem, size, align, false, sl);
 }
 
 //--------------------------------------------------------------------------------------------------
 
 void* Mem::Realloc(Mem mem, void* oldPtr, U64 oldSize, U64 newSize, SrcLoc sl) {
+	return ReallocAligned(mem, oldPtr, oldSize, newSize, Align, sl);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// align must match the original allocation's
+void* Mem::ReallocAligned(Mem mem, void* oldPtr, U64 oldSize, U64 newSize, U64 align, SrcLoc sl) {
 	Assert(mem);
 	Assert(mem.handle < MaxMemObjs);
 	MemObj* const memObj = &memObjs[mem.handle];
 
+	if (memObj->heap) {
+		void* newPtr = 0;
+		if (align <= Heap::Align) {
+			newPtr = Heap::Realloc(memObj->heap, oldPtr, newSize);
+		} else if (oldPtr && Heap::Size(oldPtr) >= newSize) {
+			newPtr = oldPtr;
+		} else {
+			newPtr = Heap::AllocAligned(memObj->heap, newSize, align);
+			if (oldPtr) {
+				memcpy(newPtr, oldPtr, Min(oldSize, newSize));
+				Heap::Free(memObj->heap, oldPtr);
+			}
+		}
+		if (newSize > oldSize) {
+			if (traceEnabled) {
+				TraceAlloc(mem, newSize - oldSize, sl);
+			}
+			memset((U8*)newPtr + oldSize, 0, newSize - oldSize);
+		}
+		return newPtr;
+	}
+
 	if (!oldPtr || memObj->lastAlloc != (U8*)oldPtr) {
 		if (newSize <= oldSize) {
 			return oldPtr;
 		}
-		void* const newPtr = Alloc(mem, newSize, sl);
+		void* const newPtr = AllocImpl(mem, newSize, align, false, sl);
 		if (oldPtr) {
 			memcpy(newPtr, oldPtr, oldSize);
 		}
+		memset((U8*)newPtr + oldSize, 0, newSize - oldSize);
 		return newPtr;
 	}
 
 	U64 const alignedNewSize = Bit::AlignUp(newSize, Align);
 	memObj->end = (U8*)oldPtr;
-	Assert(memObj->endCommit >= memObj->end);
-	U64 const avail = (U64)(memObj->endCommit - memObj->end);
-	if (alignedNewSize > avail) {
-		U64 const curCommit = (U64)(memObj->endCommit - memObj->begin);
-		U64 nextCommit = Max(Sys::VirtualPageSize, curCommit);
-		while (avail + (nextCommit - curCommit) < alignedNewSize) {
-			nextCommit *= 2;
-		}
-		Assert(memObj->begin + nextCommit <= memObj->endReserve);
-		Sys::VirtualCommit(memObj->endCommit, nextCommit - curCommit);
-		memObj->endCommit  = memObj->begin + nextCommit;
-	}
+	EnsureCommit(memObj, alignedNewSize);
 	memObj->end += alignedNewSize;
 	Assert(memObj->end <= memObj->endCommit);
 	Assert(Bit::IsPow2(memObj->endCommit - memObj->begin));
 	memObj->lastAllocSl = sl;
+	if (memObj->end > memObj->peak) {
+		memObj->peak = memObj->end;
+	}
+	if (traceEnabled && newSize > oldSize) {
+		TraceAlloc(mem, newSize - oldSize, sl);
+	}
 
 	if (newSize > oldSize) {
 		memset((U8*)oldPtr + oldSize, 0, newSize - oldSize);
@@ -128,10 +375,23 @@ void* Mem::Realloc(Mem mem, void* oldPtr, U64 oldSize, U64 newSize, SrcLoc sl) {
 
 //--------------------------------------------------------------------------------------------------
 
+// Returns p to a heap arena. A no-op for bump arenas, whose memory is only reclaimed by Reset().
+void Mem::Free(Mem mem, void* p) {
+	Assert(mem);
+	Assert(mem.handle < MaxMemObjs);
+	MemObj* const memObj = &memObjs[mem.handle];
+	if (memObj->heap) {
+		Heap::Free(memObj->heap, p);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
 MemMark Mem::Mark(Mem mem) {
 	Assert(mem);
 	Assert(mem.handle < MaxMemObjs);
 	MemObj* const memObj = &memObjs[mem.handle];
+	Assert(!memObj->heap);
 	Assert(memObj->end >= memObj->begin);
 	return {
 		.mark        = (U64)(memObj->end - memObj->begin),
@@ -146,6 +406,7 @@ void Mem::Reset(Mem mem, MemMark mark) {
 	Assert(mem);
 	Assert(mem.handle < MaxMemObjs);
 	MemObj* const memObj = &memObjs[mem.handle];
+	Assert(!memObj->heap);
 	Assert(memObj->begin + mark.mark <= memObj->end);
 	Assert(!mark.lastAlloc || (memObj->begin <= mark.lastAlloc && mark.lastAlloc <= memObj->begin + mark.mark));
 	memObj->end         = memObj->begin + mark.mark;
@@ -155,4 +416,292 @@ void Mem::Reset(Mem mem, MemMark mark) {
 
 //--------------------------------------------------------------------------------------------------
 
+// Call once per frame from the arena's owning thread.
+// Tracks the arena's high-water mark over the last TrimWindowFrames calls and decommits any pages
+// committed above it, so a single spike doesn't pin that memory for the rest of the session.
+// Commit stays a power of two so Alloc's doubling still holds.
+// Returns the number of bytes decommitted.
+U64 Mem::Trim(Mem mem) {
+	Assert(mem);
+	Assert(mem.handle < MaxMemObjs);
+	MemObj* const memObj = &memObjs[mem.handle];
+	Assert(!memObj->heap);
+
+	U64 const framePeak = (U64)(memObj->peak - memObj->begin);
+	memObj->peak = memObj->end;
+
+	U32 const bucket = (U32)((memObj->trimFrames / TrimBucketFrames) % TrimBuckets);
+	if (memObj->trimFrames % TrimBucketFrames == 0) {
+		memObj->trimPeaks[bucket] = 0;
+	}
+	memObj->trimPeaks[bucket] = Max(memObj->trimPeaks[bucket], framePeak);
+	memObj->trimFrames++;
+	if (memObj->trimFrames < TrimWindowFrames) {
+		return 0;	// haven't seen a full window yet
+	}
+
+	U64 windowPeak = (U64)(memObj->end - memObj->begin);
+	for (U32 i = 0; i < TrimBuckets; i++) {
+		windowPeak = Max(windowPeak, memObj->trimPeaks[i]);
+	}
+
+	U64 const keepCommit = Max(memObj->pageSize, Bit::AlignPow2(windowPeak));
+	U64 const curCommit  = (U64)(memObj->endCommit - memObj->begin);
+	if (curCommit <= keepCommit) {
+		return 0;
+	}
+	Sys::VirtualDecommit(memObj->begin + keepCommit, curCommit - keepCommit);
+	memObj->endCommit = memObj->begin + keepCommit;
+	return curCommit - keepCommit;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// reportFrames > 0 logs a TraceReport() every reportFrames calls to TraceFrame()
+void Mem::EnableTrace(bool enable, U32 reportFrames) {
+	if (enable && !traceMem) {
+		traceMem = Create(TraceReserveSize);
+		traceSites = AllocT<TraceSite>(traceMem, MaxTraceSites);
+		traceSiteIdxs.Init(traceMem, MaxTraceSites * 2);
+	}
+	traceEnabled      = enable;
+	traceReportFrames = reportFrames;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Call once per frame, before resetting the frame's temp memory
+void Mem::TraceFrame() {
+	if (!traceEnabled) {
+		return;
+	}
+
+	Sys::LockMutex(&traceMutex);
+	for (U32 i = 0; i < traceSitesLen; i++) {
+		TraceStats* const stats = &traceSites[i].stats;
+		stats->peakFrameBytes = Max(stats->peakFrameBytes, stats->frameBytes);
+		stats->frameBytes = 0;
+	}
+	for (U32 i = 0; i < MaxMemObjs; i++) {
+		TraceStats* const stats = &traceMemStats[i];
+		stats->peakFrameBytes = Max(stats->peakFrameBytes, stats->frameBytes);
+		stats->frameBytes = 0;
+	}
+	traceFrame++;
+	Sys::UnlockMutex(&traceMutex);
+
+	if (traceReportFrames && traceFrame % traceReportFrames == 0) {
+		TraceReport(TraceReportSites);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Logs per-arena totals and the top maxSites call sites by total bytes allocated
+void Mem::TraceReport(U32 maxSites) {
+	if (!traceMem) {
+		return;
+	}
+
+	// Snapshot under the lock, log outside it: logging allocates
+	Mem const scratch = GetScratch();
+	MemScope(scratch);
+	Sys::LockMutex(&traceMutex);
+	U32 const sitesLen = traceSitesLen;
+	TraceSite* const sites = AllocT<TraceSite>(scratch, sitesLen);
+	memcpy(sites, traceSites, sitesLen * sizeof(TraceSite));
+	TraceStats memStats[MaxMemObjs];
+	memcpy(memStats, traceMemStats, sizeof(memStats));
+	U64 const frame = traceFrame;
+	Sys::UnlockMutex(&traceMutex);
+
+	maxSites = Min(maxSites, sitesLen);
+	for (U32 i = 0; i < maxSites; i++) {	// partial selection sort: only need the top maxSites
+		U32 maxIdx = i;
+		for (U32 j = i + 1; j < sitesLen; j++) {
+			if (sites[j].stats.bytes > sites[maxIdx].stats.bytes) {
+				maxIdx = j;
+			}
+		}
+		Swap(&sites[i], &sites[maxIdx]);
+	}
+
+	Logf("Mem trace after %u frames:", frame);
+	for (U32 i = 1; i < MaxMemObjs; i++) {
+		if (memStats[i].count) {
+			Logf("  mem %u: %u bytes in %u allocs, peak %u bytes/frame", i, memStats[i].bytes, memStats[i].count, memStats[i].peakFrameBytes);
+		}
+	}
+	for (U32 i = 0; i < maxSites; i++) {
+		TraceSite const* const site = &sites[i];
+		Logf("  %s(%u) mem %u: %u bytes in %u allocs, peak %u bytes/frame", site->key.file, site->key.line, site->key.memIdx, site->stats.bytes, site->stats.count, Max(site->stats.peakFrameBytes, site->stats.frameBytes));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Mem") {
+	Unit_SubTest("Scratch") {
+		Mem const s1 = Mem::GetScratch();
+		Unit_Check(s1);
+		Unit_CheckEq(Mem::GetScratch().handle, s1.handle);	// same thread, no conflicts -> same arena
+
+		Mem const s2 = Mem::GetScratch(s1);
+		Unit_Check(s2);
+		Unit_CheckNeq(s2.handle, s1.handle);
+		Unit_CheckEq(Mem::GetScratch(s2).handle, s1.handle);
+
+		Mem const s3 = Mem::GetScratch(s1, s2);
+		Unit_CheckNeq(s3.handle, s1.handle);
+		Unit_CheckNeq(s3.handle, s2.handle);
+
+		Unit_CheckNeq(Mem::GetScratch(testMem).handle, testMem.handle);
+	}
+
+	Unit_SubTest("Scratch nesting") {
+		Mem const outer = Mem::GetScratch(testMem);
+		MemScope(outer);
+		U64* const outerVals = Mem::AllocT<U64>(outer, 16);
+		outerVals[15] = 0xfeedfacefeedface;
+		{
+			Mem const inner = Mem::GetScratch(outer);
+			MemScope(inner);
+			memset(Mem::Alloc(inner, 4096), 0xff, 4096);
+		}
+		Unit_CheckEq(outerVals[15], (U64)0xfeedfacefeedface);
+	}
+
+	Unit_SubTest("Trim") {
+		Mem const mem = Mem::Create(1 * GB);
+		Defer { Mem::Destroy(mem); };
+
+		Mem::Alloc(mem, 1 * MB);
+		Mem::Reset(mem, MemMark());
+
+		U64 trimmed = 0;
+		for (U32 i = 0; i < TrimWindowFrames; i++) {
+			trimmed += Mem::Trim(mem);
+		}
+		Unit_CheckEq(trimmed, (U64)0);	// spike still inside the window
+
+		for (U32 i = 0; i < TrimBucketFrames; i++) {
+			trimmed += Mem::Trim(mem);
+		}
+		Unit_CheckEq(trimmed, 1 * MB - Sys::VirtualPageSize);
+
+		// Arena still grows again after trimming
+		U8* const p = (U8*)Mem::Alloc(mem, 64 * KB);
+		p[64 * KB - 1] = 1;
+		Unit_CheckEq(Mem::Trim(mem), (U64)0);
+	}
+
+	Unit_SubTest("HugeExplicit") {
+		// Each 2MB commit takes a pool page or falls back to THP: either way it's usable, and a
+		// decommitted chunk comes back zeroed
+		U64 const fallbacks = Sys::HugePageFallbacks();
+		Mem const mem = Mem::Create(1 * GB, PageKind::HugeExplicit);
+		Defer { Mem::Destroy(mem); };
+		U8* const p = (U8*)Mem::Alloc(mem, 5 * MB);
+		if (Sys::HasHugePages) {
+			Unit_CheckEq((U64)p % Sys::HugePageSize, (U64)0);
+		}
+		memset(p, 0x5a, 5 * MB);
+		Unit_CheckEq(p[5 * MB - 1], (U8)0x5a);
+		Unit_Check(Sys::HugePageFallbacks() - fallbacks <= 4);	// commits grow to a power of two: 8MB
+
+		Mem::Reset(mem, MemMark());
+		U64 trimmed = 0;
+		for (U32 i = 0; i < TrimWindowFrames + TrimBucketFrames; i++) {
+			trimmed += Mem::Trim(mem);
+		}
+		Unit_Check(trimmed > 0);
+		U8* const q = (U8*)Mem::AllocUninit(mem, 5 * MB);
+		Unit_CheckEq(q[4 * MB], (U8)0);
+	}
+
+	Unit_SubTest("Aligned") {
+		struct alignas(32) Vec8 { F32 f[8]; };
+
+		Mem const mem = Mem::Create(1 * GB);
+		Defer { Mem::Destroy(mem); };
+
+		Mem::Alloc(mem, 1);
+		U8* const p = (U8*)Mem::AllocAligned(mem, 100, 64);
+		Unit_CheckEq((U64)p % 64, (U64)0);
+		Unit_CheckEq(p[99], (U8)0);
+
+		Mem::Alloc(mem, 1);
+		Vec8* const v = Mem::AllocT<Vec8>(mem, 3);
+		Unit_CheckEq((U64)v % 32, (U64)0);
+
+		Mem::Alloc(mem, 1);	// forces the realloc to move
+		Vec8* const v2 = Mem::ReallocT<Vec8>(mem, v, 3, 100);
+		Unit_CheckNeq(v2, v);
+		Unit_CheckEq((U64)v2 % 32, (U64)0);
+		Unit_CheckEq(v2[99].f[7], 0.0f);
+
+		U8* const u = (U8*)Mem::AllocUninitAligned(mem, 4096, 4096);
+		Unit_CheckEq((U64)u % 4096, (U64)0);
+	}
+
+	Unit_SubTest("Trace") {
+		Mem::EnableTrace(true);
+		Defer { Mem::EnableTrace(false); };
+
+		SrcLoc const sl = SrcLoc::Here();
+		Mem::Alloc(testMem, 100, sl);
+		Mem::Alloc(testMem, 200, sl);
+		Mem::TraceFrame();
+		Mem::Alloc(testMem, 50, sl);
+
+		U32 const idx = traceSiteIdxs.FindOrZero(TraceKey { .file = sl.file, .line = sl.line, .memIdx = (U32)testMem.handle });
+		if (Unit_Check(idx)) {
+			TraceStats const* const stats = &traceSites[idx - 1].stats;
+			Unit_CheckEq(stats->count,          (U64)3);
+			Unit_CheckEq(stats->bytes,          (U64)(104 + 200 + 56));	// aligned sizes
+			Unit_CheckEq(stats->frameBytes,     (U64)56);
+			Unit_CheckEq(stats->peakFrameBytes, (U64)(104 + 200));
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Simulates ReadAllBytes(): allocate, then overwrite the whole buffer.
+// The arena is warmed first so both cases measure the zero pass, not page faults.
+Bench_Def("Mem: zeroed vs uninit reads") {
+	constexpr U64 MaxSize = 64 * MB;
+	constexpr U32 Iters   = 16;
+
+	U8* const src = (U8*)Mem::AllocUninit(benchMem, MaxSize);
+	memset(src, 0x5a, MaxSize);
+	MemMark const mark = Mem::Mark(benchMem);
+	memset(Mem::AllocUninit(benchMem, MaxSize), 0, MaxSize);
+	Mem::Reset(benchMem, mark);
+
+	for (U64 size = 1 * MB; size <= MaxSize; size *= 4) {
+		U64 sum = 0;
+		U64 start = Time::Now();
+		for (U32 i = 0; i < Iters; i++) {
+			U8* const buf = (U8*)Mem::Alloc(benchMem, size);
+			memcpy(buf, src, size);
+			sum += buf[size - 1];
+			Mem::Reset(benchMem, mark);
+		}
+		Bench::Report(SPrintf(benchMem, "Alloc       %3u MB", size / MB), Time::Now() - start, Iters);
+
+		start = Time::Now();
+		for (U32 i = 0; i < Iters; i++) {
+			U8* const buf = (U8*)Mem::AllocUninit(benchMem, size);
+			memcpy(buf, src, size);
+			sum += buf[size - 1];
+			Mem::Reset(benchMem, mark);
+		}
+		Bench::Report(SPrintf(benchMem, "AllocUninit %3u MB", size / MB), Time::Now() - start, Iters);
+		Bench::Consume(sum);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
 }	// namespace JC
\ No newline at end of file
@@ -34,6 +34,7 @@ static constexpr U32 Cfg_MaxSprites  = 64 * 1024;
 static constexpr U32 Cfg_MaxFonts    = 64;
 
 static constexpr U32 MaxDrawCmds    = 128 * 1024;
+static constexpr U32 InitialSprites = 1024;	// spriteObjsByName grows as needed
 static constexpr U32 MaxCanvases    = 64;
 static constexpr U32 MaxPasses      = 64;
 static constexpr U32 ErrorImageSize = 64;
@@ -52,7 +53,7 @@ struct SpriteObj {
 	Vec2 uv2;
 	Vec2 size;
 	Vec2 texelSize;
-	Str  name;
+	Sym  name;
 };
 
 struct Glyph {
@@ -117,7 +118,7 @@ struct SpriteDef {
 	U32 y = 0;
 	U32 w = 0;
 	U32 h = 0;
-	Str name;
+	Sym name;
 };
 
 Json_Begin(SpriteDef)
@@ -178,13 +179,14 @@ Json_End(FontDef)
 //--------------------------------------------------------------------------------------------------
 
 static Mem                 tempMem;
+static Mem                 heapMem;	// for spriteObjsByName: a growing Map only gets its old tables back from a heap
 static U32                 windowWidth;
 static U32                 windowHeight;
 static Gpu::Image          errorImage;
 static U32                 errorImageIdx;
 static Array<Atlas>        atlases;
 static Array<SpriteObj>    spriteObjs;
-static Map<Str, SpriteObj*>spriteObjsByName;
+static Map<Sym, SpriteObj*>spriteObjsByName;
 static Array<FontObj>      fontObjs;
 static Array<CanvasObj>    canvasObjs;
 static Gpu::Image          depthImage;
@@ -207,8 +209,9 @@ static U64                 frameIdx;
 //--------------------------------------------------------------------------------------------------
 
 static Res<Gpu::Shader> LoadShader(Str path) {
-	Span<U8> data;
-	if (Res<> r = File::ReadAllBytes(tempMem, path).To(data); !r) { return r.err; }
+	Span<U8 const> data;
+	if (Res<> r = File::Map(path).To(data); !r) { return r.err; }
+	Defer { File::Unmap(data); };
 	return Gpu::CreateShader(data.data, data.len);
 }
 
@@ -221,7 +224,8 @@ Res<> Init(InitDesc const* initDesc) {
 	atlases.Init(initDesc->permMem, Cfg_MaxAtlases);
 	spriteObjs.Init(initDesc->permMem, Cfg_MaxSprites);
 	spriteObjs.Add();// Reserve 0 for invalid
-	spriteObjsByName.Init(initDesc->permMem, Cfg_MaxSprites);
+	heapMem      = Mem::CreateHeap(64 * MB);
+	spriteObjsByName.Init(heapMem, InitialSprites);
 	fontObjs.Init(initDesc->permMem, Cfg_MaxFonts);
 	fontObjs.Add();// Reserve 0 for invalid
 	canvasObjs.Init(initDesc->permMem, MaxCanvases);
@@ -232,7 +236,7 @@ Res<> Init(InitDesc const* initDesc) {
 	TryTo(Gpu::CreateImage(ErrorImageSize, ErrorImageSize, Gpu::ImageFormat::B8G8R8A8_UNorm, Gpu::ImageUsage::Sampled | Gpu::ImageUsage::Copy), errorImage);
 	errorImageIdx = Gpu::GetImageBindIdx(errorImage);
 	Gpu_Name(errorImage);
-	U8* errorImageData = Mem::AllocT<U8>(tempMem, ErrorImageSize * ErrorImageSize * 4);
+	U8* errorImageData = Mem::AllocUninitT<U8>(tempMem, ErrorImageSize * ErrorImageSize * 4);
 	for (U32 i = 0; i < ErrorImageSize * ErrorImageSize * 4; i++) {
 		errorImageData[i] = 0xff;
 	}
@@ -304,6 +308,7 @@ void Shutdown() {
 	Gpu::DestroyShader(fragmentShader);
 	Gpu::DestroyImage(depthImage);
 	Gpu::DestroyImage(errorImage);
+	Mem::Destroy(heapMem);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -332,8 +337,16 @@ Res<> ResizeWindow(U32 windowWidthIn, U32 windowHeightIn) {
 
 //--------------------------------------------------------------------------------------------------
 
-static Res<Gpu::Image> LoadImage(Str path) {
-	Span<U8> data; TryTo(File::ReadAllBytes(tempMem, path), data);
+struct DecodedImage {
+	U8* pixels;	// from stbi: UploadImage() frees it
+	U32 width;
+	U32 height;
+};
+
+// Any thread
+static Res<DecodedImage> DecodeImage(Str path) {
+	Span<U8 const> data; TryTo(File::Map(path), data);
+	Defer { File::Unmap(data); };
 
 	int width = 0;
 	int height = 0;
@@ -341,31 +354,67 @@ static Res<Gpu::Image> LoadImage(Str path) {
 	if (!imageData) {
 		return Err_LoadImage("path", path, "desc", stbi_failure_reason());
 	}
-	Defer { stbi_image_free(imageData); };
+	return DecodedImage { .pixels = imageData, .width = (U32)width, .height = (U32)height };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// The copy is only queued: Asset::Update() waits once for the whole batch
+static Res<Gpu::Image> UploadImage(Str path, DecodedImage const* decodedImage) {
+	Defer { stbi_image_free(decodedImage->pixels); };
 
 	Gpu::Image image;
-	Try(Gpu::CreateImage(width, height, Gpu::ImageFormat::R8G8B8A8_UNorm, Gpu::ImageUsage::Sampled | Gpu::ImageUsage::Copy).To(image));
+	Try(Gpu::CreateImage(decodedImage->width, decodedImage->height, Gpu::ImageFormat::R8G8B8A8_UNorm, Gpu::ImageUsage::Sampled | Gpu::ImageUsage::Copy).To(image));
 	Gpu_Namef(image, "%s", path);
-	Try(Gpu::ImmediateCopyToImage(imageData, image, Gpu::BarrierStage::VertexShader_SamplerRead, Gpu::ImageLayout::ShaderRead));
+	Try(Gpu::ImmediateCopyToImage(decodedImage->pixels, image, Gpu::BarrierStage::VertexShader_SamplerRead, Gpu::ImageLayout::ShaderRead));
 
 	return image;
 }
 
 //--------------------------------------------------------------------------------------------------
 
-Res<> LoadSprites(Str path) {
+struct SpritesLoad {
+	AtlasDef     atlasDef;
+	DecodedImage decodedImage;
+};
+
+static bool IsAtlasLoaded(Str path) {
 	for (U32 i = 0; i < atlases.len; i++) {
 		if (File::PathsEq(path, atlases[i].path)) {
-			return Ok();
+			return true;
 		}
 	}
+	return false;
+}
 
-	if (!atlases.HasCapacity()) { return Err_Max("type", "atlases", "max", Cfg_MaxAtlases); }
+static Res<> PrepareSprites(Mem mem, Str path, void* state) {
+	SpritesLoad* const load = (SpritesLoad*)state;
+	Span<U8 const> data; TryTo(File::Map(path), data);
+	Defer { File::Unmap(data); };
+	Try(Json::JsonToObject(mem, Str((char const*)data.data, (U32)data.len), &load->atlasDef));	// Json interns every string, so the view can go once parsed
+	TryTo(DecodeImage(load->atlasDef.imagePath), load->decodedImage);
+	return Ok();
+}
 
-	Str json; TryTo(File::ReadAllStr(tempMem, path), json);
-	AtlasDef atlasDef; Try(Json::JsonToObject(tempMem, json, &atlasDef));
+// Only when FinishSprites() won't run, which frees the pixels itself
+static void DropSprites(Mem, Str, void* state) {
+	stbi_image_free(((SpritesLoad*)state)->decodedImage.pixels);	// null if prepare failed before decoding
+}
+
+static Res<> FinishSprites(Mem, Str path, void* state) {
+	SpritesLoad* const load = (SpritesLoad*)state;
+	AtlasDef const* const atlasDef = &load->atlasDef;
+	if (IsAtlasLoaded(path)) {	// started twice: the other one finished first
+		stbi_image_free(load->decodedImage.pixels);
+		return Ok();
+	}
 
-	Gpu::Image image; TryTo(LoadImage(atlasDef.imagePath), image);
+	if (!atlases.HasCapacity()) {
+		stbi_image_free(load->decodedImage.pixels);
+		return Err_Max("type", "atlases", "max", Cfg_MaxAtlases);
+	}
+
+	Gpu::Image image; TryTo(UploadImage(atlasDef->imagePath, &load->decodedImage), image);
 	U32 const imageIdx    = Gpu::GetImageBindIdx(image);
 	F32 const imageWidth  = (F32)Gpu::GetImageWidth(image);
 	F32 const imageHeight = (F32)Gpu::GetImageHeight(image);
@@ -375,12 +424,12 @@ Res<> LoadSprites(Str path) {
 		.imageIdx = imageIdx,
 	});
 
-	if (!spriteObjs.HasCapacity(atlasDef.sprites.len)) { return Err_Max("type", "sprites", "max", Cfg_MaxSprites); }
+	if (!spriteObjs.HasCapacity(atlasDef->sprites.len)) { return Err_Max("type", "sprites", "max", Cfg_MaxSprites); }
 
-	for (U64 i = 0; i < atlasDef.sprites.len; i++) {
-		SpriteDef* const spriteDef = &atlasDef.sprites[i];
+	for (U64 i = 0; i < atlasDef->sprites.len; i++) {
+		SpriteDef const* const spriteDef = &atlasDef->sprites[i];
 		if (spriteObjsByName.FindOrZero(spriteDef->name)) {
-			return Err_DuplicateSprite("path", path, "name", spriteDef->name);
+			return Err_DuplicateSprite("path", path, "name", StrDb::GetStr(spriteDef->name));
 		}
 		F32 const x = (F32)spriteDef->x;
 		F32 const y = (F32)spriteDef->y;
@@ -395,25 +444,51 @@ Res<> LoadSprites(Str path) {
 				.uv2       = { (x + w) / imageWidth, (y + h) / imageHeight },
 				.size      = { w, h },
 				.texelSize = { 1.f / imageWidth, 1.f / imageHeight },
-				.name      = spriteDef->name,	// Json interns this for us
+				.name      = spriteDef->name,
 			})
 		);
 	}
 	return Ok();
 }
 
+Asset::Load LoadSpritesAsync(Str path) {
+	bool const loaded = IsAtlasLoaded(path);
+	Asset::LoadDesc const desc = {
+		.path      = path,
+		.stateSize = sizeof(SpritesLoad),
+		.prepareFn = loaded ? nullptr : PrepareSprites,
+		.finishFn  = loaded ? nullptr : FinishSprites,
+		.dropFn    = loaded ? nullptr : DropSprites,
+	};
+	return Asset::Start(&desc);
+}
+
+Res<> LoadSprites(Str path) {
+	return Asset::Wait(LoadSpritesAsync(path));
+}
+
 //--------------------------------------------------------------------------------------------------
 
-Res<Sprite> GetSprite(Str name) {
+Res<Sprite> GetSprite(Sym name) {
 	SpriteObj* spriteObj = spriteObjsByName.FindOrZero(name);
 	if (!spriteObj) {
-		return Err_SpriteNotFound("name", name);
+		return Err_SpriteNotFound("name", StrDb::GetStr(name));
 	}
 	return Sprite { .handle = (U64)(spriteObj - spriteObjs.data) };
 }
 
 //--------------------------------------------------------------------------------------------------
 
+Res<Sprite> GetSprite(Str name) {
+	Sym const sym = StrDb::FindSym(name);	// never interned means never loaded
+	if (!sym) {
+		return Err_SpriteNotFound("name", name);
+	}
+	return GetSprite(sym);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Vec2 GetSpriteSize(Sprite sprite) {
 	Assert(sprite.handle > 0 && sprite.handle < spriteObjs.len);
 	return spriteObjs[sprite.handle].size;
@@ -421,28 +496,48 @@ Vec2 GetSpriteSize(Sprite sprite) {
 
 //--------------------------------------------------------------------------------------------------
 
-Res<> LoadFont(Str path) {
-	if (!fontObjs.HasCapacity()) { return Err_Max("type", "fonts", "max", Cfg_MaxFonts); }
+struct FontLoad {
+	FontDef      fontDef;
+	DecodedImage decodedImage;
+};
 
-	Str json; TryTo(File::ReadAllStr(tempMem, path), json);
-	FontDef fontDef; Try(Json::JsonToObject(tempMem, json, &fontDef));
+static Res<> PrepareFont(Mem mem, Str path, void* state) {
+	FontLoad* const load = (FontLoad*)state;
+	Span<U8 const> data; TryTo(File::Map(path), data);
+	Defer { File::Unmap(data); };
+	Try(Json::JsonToObject(mem, Str((char const*)data.data, (U32)data.len), &load->fontDef));
+	TryTo(DecodeImage(load->fontDef.imagePath), load->decodedImage);
+	return Ok();
+}
+
+// Only when FinishFont() won't run, which frees the pixels itself
+static void DropFont(Mem, Str, void* state) {
+	stbi_image_free(((FontLoad*)state)->decodedImage.pixels);	// null if prepare failed before decoding
+}
 
+static Res<> FinishFont(Mem, Str, void* state) {
+	FontLoad* const load = (FontLoad*)state;
+	FontDef const* const fontDef = &load->fontDef;
+	if (!fontObjs.HasCapacity()) {
+		stbi_image_free(load->decodedImage.pixels);
+		return Err_Max("type", "fonts", "max", Cfg_MaxFonts);
+	}
 
-	Gpu::Image image; TryTo(LoadImage(fontDef.imagePath), image);
+	Gpu::Image image; TryTo(UploadImage(fontDef->imagePath, &load->decodedImage), image);
 	U32 const imageIdx    = Gpu::GetImageBindIdx(image);
 	F32 const imageWidth  = (F32)Gpu::GetImageWidth(image);
 	F32 const imageHeight = (F32)Gpu::GetImageHeight(image);
 
 	FontObj* const fontObj = fontObjs.Add();
-	fontObj->name       = fontDef.name;
+	fontObj->name       = fontDef->name;
 	fontObj->image      = image;
 	fontObj->imageIdx   = imageIdx;
-	fontObj->lineHeight = (F32)fontDef.lineHeight;
-	fontObj->base       = (F32)fontDef.base;
+	fontObj->lineHeight = (F32)fontDef->lineHeight;
+	fontObj->base       = (F32)fontDef->base;
 	fontObj->texelSize  = { 1.f / imageWidth, 1.f / imageHeight };
 
-	for (U64 i = 0; i < fontDef.glyphs.len; i++) {
-		GlyphDef const* const glyphDef = &fontDef.glyphs[i];
+	for (U64 i = 0; i < fontDef->glyphs.len; i++) {
+		GlyphDef const* const glyphDef = &fontDef->glyphs[i];
 		// TODO: more validation, here and in sprite
 		if (glyphDef->ch >= MaxGlyphs) {
 			//Errorf("Ignoring out-of-range font character '%c' (%u) in %s", (char)glyphJson->ch, glyphJson->ch, fontPath);
@@ -488,6 +583,21 @@ Res<> LoadFont(Str path) {
 	return Ok();
 }
 
+Asset::Load LoadFontAsync(Str path) {
+	Asset::LoadDesc const desc = {
+		.path      = path,
+		.stateSize = sizeof(FontLoad),
+		.prepareFn = PrepareFont,
+		.finishFn  = FinishFont,
+		.dropFn    = DropFont,
+	};
+	return Asset::Start(&desc);
+}
+
+Res<> LoadFont(Str path) {
+	return Asset::Wait(LoadFontAsync(path));
+}
+
 //--------------------------------------------------------------------------------------------------
 
 Res<Font> GetFont(Str name) {
@@ -724,7 +834,7 @@ void DrawRect(DrawRectDesc drawRectDesc) {
 void DrawSprite(DrawSpriteDesc drawSpriteDesc) {
 }
 
-void DrawSprites(Span<DrawSpriteDesc> drawSpriteDescs) {
+void DrawSprites(Span<DrawSpriteDesc const> drawSpriteDescs) {
 	DrawCmd* const drawCmds = AllocDrawCmds(drawSpriteDescs.len);
 
 	for (U64 i = 0; i < drawSpriteDescs.len; i++) {
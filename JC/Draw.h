@@ -1,6 +1,8 @@
 #pragma once
 
 #include "JC/Common.h"
+#include "JC/Asset.h"
+#include "JC/StrDb.h"
 
 namespace JC::Gpu { struct FrameData; };
 
@@ -81,9 +83,12 @@ struct DrawCanvasDesc {
 Res<>       Init(InitDesc const* initDesc);
 void        Shutdown();
 Res<>       ResizeWindow(U32 width, U32 height);
-Res<>       LoadSprites(Str path);
+Asset::Load LoadSpritesAsync(Str path);	// decodes on a worker, uploads and registers from Asset::Update()
+Res<>       LoadSprites(Str path);	// Asset::Wait(LoadSpritesAsync(path))
+Res<Sprite> GetSprite(Sym name);
 Res<Sprite> GetSprite(Str name);
 Vec2        GetSpriteSize(Sprite sprite);
+Asset::Load LoadFontAsync(Str path);
 Res<>       LoadFont(Str path);
 Res<Font>   GetFont(Str name);
 F32         GetFontLineHeight(Font font);
@@ -96,7 +101,7 @@ void        SetCamera(Camera camera);
 void        ClearCamera();
 void        DrawRect(DrawRectDesc drawRectDesc);
 void        DrawSprite(DrawSpriteDesc drawSpriteDesc);
-void        DrawSprites(Span<DrawSpriteDesc> drawSpriteDescs);
+void        DrawSprites(Span<DrawSpriteDesc const> drawSpriteDescs);
 void        DrawStr(DrawStrDesc drawStrDesc);
 void        DrawCanvas(DrawCanvasDesc drawCanvasDesc);
 
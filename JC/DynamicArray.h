@@ -28,6 +28,14 @@ template <class T> struct DynamicArray {
 		data   = Mem::AllocT<T>(mem, maxLenIn, sl);
 	}
 
+	// Only returns memory to heap arenas: see Mem::Free()
+	void Shutdown() {
+		Mem::Free(mem, data);
+		len    = 0;
+		maxLen = 0;
+		data   = 0;
+	}
+
 	constexpr T      & operator[](U64 i)       { Assert(i < len); return data[i]; }
 	constexpr T const& operator[](U64 i) const { Assert(i < len); return data[i]; }
 
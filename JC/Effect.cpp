@@ -2,7 +2,10 @@
 
 #include "JC/Draw.h"
 #include "JC/Log.h"
+#include "JC/Pool.h"
+#include "JC/Queue.h"
 #include "JC/StrDb.h"
+#include "JC/Task.h"
 
 namespace JC::Effect {
 
@@ -13,58 +16,70 @@ static constexpr U32 MaxFloatingStrs = 256;
 struct FloatingStr {
 	Draw::Font font;
 	Str        str;
-	F32        sec;
-	F32        durSec;
-	F32        t;
+	F32        t;	// written by its task
 	F32        x;
 	F32        yStart;
 	F32        yEnd;
 };
 
-static FloatingStr* floatingStrs;
-static U32          floatingStrsLen;
+static Pool<FloatingStr, true> floatingStrs;	// the tasks' thread only
+
+// All Draw() looks at, copied out by Publish(). Pipelined, the tasks run on the sim thread and may
+// free a string while the main thread is still drawing the last frame.
+struct Frame {
+	U32         floatingStrsLen;
+	FloatingStr floatingStrs[MaxFloatingStrs];
+};
+
+static TripleBuffer<Frame> frames;
 
 //--------------------------------------------------------------------------------------------------
 
-void Init(Mem permMem) {
-	floatingStrs = Mem::AllocT<FloatingStr>(permMem, MaxFloatingStrs);
+void Init() {
+	floatingStrs.Init(MaxFloatingStrs);
+	frames.Init();
 }
 
 //--------------------------------------------------------------------------------------------------
 
+static Task::Task AnimateFloatingStr(FloatingStr* fs, F32 durSec) {
+	for (F32 sec = 0.f; sec < durSec; sec += co_await Task::NextFrame()) {
+		fs->t = sec / durSec;
+	}
+	floatingStrs.Free(fs);
+}
+
 void CreateFloatingStr(FloatingStrDef def) {
-	Assert(floatingStrsLen < MaxFloatingStrs);
-	FloatingStr* const fs = &floatingStrs[floatingStrsLen++];
+	FloatingStr* const fs = floatingStrs.Alloc();
 	fs->font   = def.font;
 	fs->str    = StrDb::Intern(def.str);
-	fs->sec    = 0.f;
-	fs->durSec = def.durSec;
 	fs->t      = 0.f;
 	fs->x      = def.x;
 	fs->yStart = def.yStart;
 	fs->yEnd   = def.yEnd;
+	Task::Run(AnimateFloatingStr(fs, def.durSec));
 }
 
 //--------------------------------------------------------------------------------------------------
 
-void Update(F32 sec) {
-	for (U32 i = 0; i < floatingStrsLen;) {
-		FloatingStr* const fs = &floatingStrs[i];
-		fs->sec += sec;
-		if (fs->sec >= fs->durSec) {
-			floatingStrs[i] = floatingStrs[--floatingStrsLen];
-			continue;	// no i++
-		}
-		fs->t = fs->sec / fs->durSec;
-		i++;
-	}
+void Publish() {
+	Frame* const frame = frames.Back();
+	frame->floatingStrsLen = 0;
+	floatingStrs.ForEach([frame](FloatingStr* fs) {
+		frame->floatingStrs[frame->floatingStrsLen++] = *fs;
+	});
+	frames.Publish();
 }
 
 //--------------------------------------------------------------------------------------------------
 
 void Draw(F32 z) {
-	for (U32 i = 0; i < floatingStrsLen; i++) {
-		FloatingStr* const fs = &floatingStrs[i];
+	Frame const* const frame = frames.Acquire();
+	if (!frame) {
+		return;	// nothing published yet
+	}
+	for (U32 i = 0; i < frame->floatingStrsLen; i++) {
+		FloatingStr const* const fs = &frame->floatingStrs[i];
 		F32 const y = fs->yStart - fs->t * (fs->yStart - fs->yEnd);
 		Draw::DrawStr({
 			.font = fs->font,
@@ -77,7 +92,7 @@ void Draw(F32 z) {
 			.outlineWidth = 0.f,
 			.outlineColor = Vec4(0.f, 0.f, 0.f, 0.f),
 		});
-		//Logf("text %s at (%.1f, %.1f) (%.2f=%.2f/%.2f)", fs->str, fs->x, y, fs->t, fs->sec, fs->durSec);
+		//Logf("text %s at (%.1f, %.1f) (%.2f)", fs->str, fs->x, y, fs->t);
 	}
 }
 
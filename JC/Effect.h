@@ -17,9 +17,9 @@ struct FloatingStrDef {
 	F32        yEnd;
 };
 
-void Init(Mem permMem);
-void CreateFloatingStr(FloatingStrDef def);
-void Update(F32 sec);
+void Init();
+void CreateFloatingStr(FloatingStrDef def);	// animates on its own Task, from the thread that runs Task::Update()
+void Publish();	// at the end of each Update(): what Draw() shows from then on
 void Draw(F32 z);
 
 //--------------------------------------------------------------------------------------------------
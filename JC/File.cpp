@@ -0,0 +1,203 @@
+#include "JC/File.h"
+
+#include "JC/UnitTest.h"
+
+#include <stdio.h>	// the Async test writes its files: File has no write API
+
+namespace JC::File {
+
+//--------------------------------------------------------------------------------------------------
+
+Res<Span<U8>> ReadAllBytes(Mem mem, Str path) {
+	File file; TryTo(Open(path), file);
+	Defer { Close(file); };
+	U64 len = 0; TryTo(Len(file), len);
+	U8* buf = (U8*)Mem::AllocUninit(mem, len);
+	if (Res<> r = Read(file, buf, len); !r) {
+		return r.err;
+	}
+	return Span<U8>(buf, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<Str> ReadAllStr(Mem mem, Str path) {
+	Span<U8> bytes; TryTo(ReadAllBytes(mem, path), bytes);
+	Assert(bytes.len <= (U64)U32Max);
+	return Str((char const*)bytes.data, (U32)bytes.len);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Takes a file path and removes the extension, including the dot, if any
+Str RemoveExt(Str path) {
+	if (path.len == 0) {
+		return path;
+	}
+	char const* iter = path.data + path.len - 1;
+	char const* const begin = path.data;
+	while (iter >= begin && *iter != '/' && *iter != '\\') {
+		if (*iter == '.') {
+			return Str(begin, (U32)(iter - begin));
+		}
+		iter--;
+	}
+	return path;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// returns true if `path` has extension `ext`. Extension may include multiple dots, like ".sprites.def"
+// `ext` may either have a preceding dot '.' or not. It should function the same in both cases:
+// HasExt(path, ".exe") equivalent to HasExt(path, "exe")
+bool HasExt(Str path, Str ext) {
+	if (ext.len > 0 && ext[0] == '.') {
+		ext = Str(ext.data + 1, ext.len - 1);
+	}
+	if (ext.len == 0 || path.len <= ext.len) {
+		return false;
+	}
+	if (path.data[path.len - ext.len - 1] != '.') {
+		return false;
+	}
+	char const* suffix = path.data + path.len - ext.len;
+	for (U32 i = 0; i < ext.len; i++) {
+		if (suffix[i] != ext.data[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Returns maximum extension: GetMaxExt("foo.bar.baz.qux") -> "bar.baz.qux"
+Str GetMaxExt(Str path) {
+	U32 nameStart = 0;
+	for (U32 i = 0; i < path.len; i++) {
+		if (path[i] == '/' || path[i] == '\\') { nameStart = i + 1; }
+	}
+	for (U32 i = nameStart; i < path.len; i++) {
+		if (path[i] == '.') { return Str(path.data + i + 1, path.len - i - 1); }
+	}
+	return Str();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("File") {
+	Unit_SubTest("RemoveExt") {
+		Unit_CheckEq(RemoveExt(""), "");
+		Unit_CheckEq(RemoveExt("a"), "a");
+		Unit_CheckEq(RemoveExt("a."), "a");
+		Unit_CheckEq(RemoveExt("a.a"), "a");
+		Unit_CheckEq(RemoveExt("a.abc123"), "a");
+		Unit_CheckEq(RemoveExt("a.foo/b.bar/c.qux/d"), "a.foo/b.bar/c.qux/d");
+		Unit_CheckEq(RemoveExt("a.foo/b.bar/c.qux/d.bat"), "a.foo/b.bar/c.qux/d");
+		Unit_CheckEq(RemoveExt("a.foo\\b.bar\\c.qux\\d"), "a.foo\\b.bar\\c.qux\\d");
+		Unit_CheckEq(RemoveExt("a.foo\\b.bar\\c.qux\\d.bat"), "a.foo\\b.bar\\c.qux\\d");
+		Unit_CheckEq(RemoveExt("file.tar.gz"), "file.tar");
+		Unit_CheckEq(RemoveExt(".hidden"), "");
+		Unit_CheckEq(RemoveExt("path/.hidden"), "path/");
+	}
+
+	Unit_SubTest("GetMaxExt") {
+		Unit_CheckEq(GetMaxExt(""),                        "");
+		Unit_CheckEq(GetMaxExt("a"),                       "");
+		Unit_CheckEq(GetMaxExt("a."),                      "");
+		Unit_CheckEq(GetMaxExt("a.b"),                     "b");
+		Unit_CheckEq(GetMaxExt("a.b.c"),                   "b.c");
+		Unit_CheckEq(GetMaxExt("foo.bar.baz.qux"),         "bar.baz.qux");
+		Unit_CheckEq(GetMaxExt(".hidden"),                 "hidden");
+		Unit_CheckEq(GetMaxExt("a.foo/b.bar/c.qux/d"),    "");
+		Unit_CheckEq(GetMaxExt("a.foo/b.bar/c.qux/d.e"),  "e");
+		Unit_CheckEq(GetMaxExt("a.foo\\b.bar\\c.qux\\d"), "");
+		Unit_CheckEq(GetMaxExt("dir/file.tar.gz"),         "tar.gz");
+		Unit_CheckEq(GetMaxExt("path/.hidden"),            "hidden");
+	}
+
+	Unit_SubTest("HasExt") {
+		// Basic matching, with and without leading dot
+		Unit_CheckEq(HasExt("foo.exe",            "exe"),          true);
+		Unit_CheckEq(HasExt("foo.exe",            ".exe"),         true);
+		Unit_CheckEq(HasExt("foo.exe",            "png"),          false);
+		Unit_CheckEq(HasExt("foo",                "exe"),          false);
+		Unit_CheckEq(HasExt("",                   "exe"),          false);
+
+		// Multi-dot extensions
+		Unit_CheckEq(HasExt("foo.sprites.def",    ".sprites.def"), true);
+		Unit_CheckEq(HasExt("foo.sprites.def",    "sprites.def"),  true);
+		Unit_CheckEq(HasExt("foo.sprites.def",    ".def"),         true);
+		Unit_CheckEq(HasExt("foo.def",            ".sprites.def"), false);
+
+		// Path with directory components
+		Unit_CheckEq(HasExt("a.foo/b.bar/c.exe",  "exe"),          true);
+		Unit_CheckEq(HasExt("a.exe/b",            "exe"),          false);
+
+		// Hidden files (dot-prefixed names)
+		Unit_CheckEq(HasExt(".hidden",            "hidden"),       true);
+		Unit_CheckEq(HasExt("path/.hidden",       "hidden"),       true);
+
+		// Case sensitive
+		Unit_CheckEq(HasExt("foo.EXE",            "exe"),          false);
+		Unit_CheckEq(HasExt("foo.EXE",            "EXE"),          true);
+
+		// Just the extension
+		Unit_CheckEq(HasExt(".exe",               "exe"),          true);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DefErr(FileTest, Decoy);
+
+// Both backends: every file's bytes, an empty file, a missing one, and errors that are still intact
+// when the Errs made around the submit have been recycled, as Err::Update() does every frame
+Unit_Test("File.Async") {
+	constexpr U32 FilesLen = 8;
+	Str paths[FilesLen + 1];
+	for (U32 i = 0; i < FilesLen; i++) {
+		char* const pathZ = Mem::AllocT<char>(testMem, 64);
+		*SPrintf(pathZ, pathZ + 63, "JC_FileAsyncTest_%u.bin", i) = '\0';
+		paths[i] = pathZ;
+		FILE* const f = fopen(pathZ, "wb");
+		Unit_Check(f);
+		U64 const len = (U64)i * 10000;	// includes an empty file
+		U8* const buf = Mem::AllocUninitT<U8>(testMem, len);
+		for (U64 j = 0; j < len; j++) {
+			buf[j] = (U8)(i + j);
+		}
+		Unit_CheckEq((U64)fwrite(buf, 1, len, f), len);
+		fclose(f);
+	}
+	paths[FilesLen] = "JC_FileAsyncTest_missing.bin";
+	Defer {
+		for (U32 i = 0; i < FilesLen; i++) {
+			remove(paths[i].data);
+		}
+	};
+
+	ErrMark const errMark = Err::Mark();
+	Span<AsyncRead> const asyncReads = ReadAllBytesAsync(testMem, Span<Str>(paths, FilesLen + 1));
+	Err::Reset(errMark);
+	Err const* const decoy = Err_Decoy();	// lands where any Err made by the submit was
+	for (U32 i = 0; i < FilesLen; i++) {
+		Span<U8> data;
+		Unit_Check(Wait(asyncReads[i]).To(data));
+		Unit_CheckEq(data.len, (U64)i * 10000);
+		bool eq = true;
+		for (U64 j = 0; j < data.len; j++) {
+			eq &= data[j] == (U8)(i + j);
+		}
+		Unit_Check(eq);
+	}
+	Span<U8> data;
+	Res<> const r = Wait(asyncReads[FilesLen]).To(data);
+	Unit_Check(!r);
+	Unit_Check(r.err != decoy && !(r.err == Err_Decoy));
+	Unit_Check(r.err->uCode != 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::File
\ No newline at end of file
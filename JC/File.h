@@ -7,19 +7,32 @@ namespace JC::File {
 //--------------------------------------------------------------------------------------------------
 
 DefHandle(File);
+DefHandle(AsyncRead);
 
-void           Init(Mem tempMem);
-Res<File>      Open(Str path);
-void           Close(File file);
-Res<U64>       Len(File file);
-Res<>          Read(File file, void* out, U64 outLen);
-Res<Span<U8>>  ReadAllBytes(Mem mem, Str path);
-Res<Str>       ReadAllStr(Mem mem, Str path);
-Res<Span<Str>> EnumFiles(Str dir, Str ext);
-Str            RemoveExt(Str path);
-bool           PathsEq(Str path1, Str path2);
-bool           HasExt(Str path, Str ext);
-Str            GetMaxExt(Str path);
+void                Init(Mem tempMem);
+Res<File>           Open(Str path);
+void                Close(File file);
+Res<U64>            Len(File file);
+Res<>               Read(File file, void* out, U64 outLen);
+Res<Span<U8>>       ReadAllBytes(Mem mem, Str path);
+Res<Str>            ReadAllStr(Mem mem, Str path);
+Res<Span<U8 const>> Map(Str path);	// safe from any thread
+void                Unmap(Span<U8 const> data);
+Res<Span<Str>>      EnumFiles(Str dir, Str ext);
+Str                 RemoveExt(Str path);
+bool                PathsEq(Str path1, Str path2);
+bool                HasExt(Str path, Str ext);
+Str                 GetMaxExt(Str path);
+void                Shutdown();
+
+// Batched async whole-file reads. All reads in the batch are queued before any is waited on, so
+// disk latency overlaps instead of serializing. Each path gets a handle; buffers come from mem.
+// Open/read errors surface from Wait(), which also releases the handle: every handle must be waited on.
+// Linux uses io_uring, falling back to a thread pool when the kernel refuses it; Windows uses overlapped I/O.
+// Submit, poll and wait from one thread.
+Span<AsyncRead>     ReadAllBytesAsync(Mem mem, Span<Str> paths);
+bool                IsDone(AsyncRead asyncRead);
+Res<Span<U8>>       Wait(AsyncRead asyncRead);
 
 //--------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,783 @@
+#include "JC/File.h"
+
+#include "JC/Bench.h"
+#include "JC/DynamicArray.h"
+#include "JC/Sys.h"
+#include "JC/Sys_Linux.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace JC::File {
+
+//--------------------------------------------------------------------------------------------------
+
+static constexpr U32 MaxFiles = 64;
+
+struct FileObj {
+	int  fd;
+	bool open;
+};
+
+static Mem     tempMem;
+static FileObj fileObjs[MaxFiles];
+
+//--------------------------------------------------------------------------------------------------
+
+void Init(Mem tempMemIn) {
+	tempMem = tempMemIn;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static char const* PathZ(Mem mem, Str path) {
+	char* const pathZ = Mem::AllocUninitT<char>(mem, path.len + 1);
+	memcpy(pathZ, path.data, path.len);
+	pathZ[path.len] = '\0';
+	return pathZ;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<File> Open(Str path) {
+	FileObj* fileObj = 0;
+	for (U32 i = 1; i < MaxFiles; i++) {	// reserve 0 for invalid
+		if (!fileObjs[i].open) {
+			fileObj = &fileObjs[i];
+			break;
+		}
+	}
+	Assert(fileObj);
+	int const fd = open(PathZ(tempMem, path), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return Linux_Errno("open", "path", path);
+	}
+	fileObj->fd   = fd;
+	fileObj->open = true;
+	return File { .handle = (U64)(fileObj - fileObjs) };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Close(File file) {
+	if (file) {
+		Assert(file.handle < MaxFiles);
+		FileObj* const fileObj = &fileObjs[file.handle];
+		close(fileObj->fd);
+		fileObj->open = false;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<U64> Len(File file) {
+	Assert(file.handle);
+	Assert(file.handle < MaxFiles);
+	FileObj* const fileObj = &fileObjs[file.handle];
+	Assert(fileObj->open);
+	struct stat st;
+	if (fstat(fileObj->fd, &st)) {
+		return Linux_Errno("fstat");
+	}
+	return (U64)st.st_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<> Read(File file, void* out, U64 outLen) {
+	Assert(file.handle);
+	Assert(file.handle < MaxFiles);
+	FileObj* const fileObj = &fileObjs[file.handle];
+	Assert(fileObj->open);
+	U64 offset = 0;
+	while (offset < outLen) {
+		ssize_t const bytesRead = read(fileObj->fd, (U8*)out + offset, outLen - offset);
+		if (bytesRead < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return Linux_Errno("read");
+		}
+		if (bytesRead == 0) {
+			return Linux_Errno("read", "desc", "unexpected end of file");
+		}
+		offset += (U64)bytesRead;
+	}
+	return Ok();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Maps the whole file read-only: no arena copy, pages come straight from the page cache.
+// The mapping stays valid until Unmap(), independent of any File handle. Empty files map to an empty span.
+Res<Span<U8 const>> Map(Str path) {
+	Mem const scratch = Mem::GetScratch();
+	MemScope(scratch);
+	int const fd = open(PathZ(scratch, path), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return Linux_Errno("open", "path", path);
+	}
+	Defer { close(fd); };	// the mapping holds its own reference
+
+	struct stat st;
+	if (fstat(fd, &st)) {
+		return Linux_Errno("fstat", "path", path);
+	}
+	if (st.st_size == 0) {
+		return Span<U8 const>();
+	}
+
+	void* const p = mmap(nullptr, (U64)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED) {
+		return Linux_Errno("mmap", "path", path);
+	}
+	return Span<U8 const>((U8 const*)p, (U64)st.st_size);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Unmap(Span<U8 const> data) {
+	if (data.data) {
+		munmap((void*)data.data, data.len);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<Span<Str>> EnumFiles(Str dir, Str ext) {
+	// Strip dir of any trailing slash
+	if (dir.len > 0 && dir[dir.len - 1] == '/') {
+		dir.len--;
+	}
+
+	DIR* const d = opendir(dir.len ? PathZ(tempMem, dir) : ".");
+	if (!d) {
+		if (errno == ENOENT) {
+			return Span<Str>();
+		}
+		return Linux_Errno("opendir", "dir", dir, "ext", ext);
+	}
+	Defer { closedir(d); };
+
+	DynamicArray<Str> resultPaths(tempMem, 128);
+	while (dirent const* const entry = readdir(d)) {
+		if (entry->d_type == DT_DIR) {
+			continue;
+		}
+		Str const name = entry->d_name;
+		if (ext.len && !HasExt(name, ext)) {
+			continue;
+		}
+		resultPaths.Add(dir.len ? SPrintf(tempMem, "%s/%s", dir, name) : SPrintf(tempMem, "%s", name));
+	}
+
+	return Span<Str>(resultPaths.data, resultPaths.len);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// returns true if path1 and path2 name the same file, resolving ".", ".." and symlinks.
+// Paths that don't exist compare as strings.
+bool PathsEq(Str path1, Str path2) {
+	char buf1[PATH_MAX];
+	char buf2[PATH_MAX];
+	if (!realpath(PathZ(tempMem, path1), buf1) || !realpath(PathZ(tempMem, path2), buf2)) {
+		return path1 == path2;
+	}
+	return !strcmp(buf1, buf2);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Async reads: the caller thread opens, sizes and allocates, then queues the read itself.
+// io_uring takes the whole batch in one io_uring_enter(); if the kernel refuses a ring (too old,
+// seccomp, io_uring_disabled) a small pool of threads runs blocking pread()s instead.
+
+static constexpr U32 MaxAsyncReads  = 1024;
+static constexpr U32 UringEntries   = 256;
+static constexpr U32 MaxPoolThreads = 8;
+
+struct AsyncReadObj {
+	Str         path;
+	int         fd;
+	U8*         data;
+	U64         len;
+	U64         offset;	// bytes read so far
+	char const* errFn;	// the Err itself is made by Wait(): an Err belongs to the thread and frame that made it
+	int         errNo;
+	bool        done;
+	bool        pooled;
+	Sys::Sem    doneSem;	// pooled only
+	U32         nextFree;
+};
+
+struct Uring {
+	int           fd;
+	void*         ring;
+	U64           ringSize;
+	io_uring_sqe* sqes;
+	U64           sqesSize;
+	U32*          sqHead;
+	U32*          sqTail;
+	U32           sqMask;
+	U32*          sqArray;
+	U32*          cqHead;
+	U32*          cqTail;
+	U32           cqMask;
+	io_uring_cqe* cqes;
+	U32           toSubmit;
+	U32           inFlight;
+};
+
+static AsyncReadObj asyncReadObjs[MaxAsyncReads];
+static U32          asyncReadsFree;	// 0 is reserved for invalid, so 0 also means empty
+static U32          asyncReadsLen = 1;
+static bool         asyncInit;
+static bool         useUring;
+static Uring        uring;
+
+static Sys::Mutex    poolMutex;
+static Sys::Sem      poolSem;
+static Sys::Thread   poolThreads[MaxPoolThreads];
+static U32           poolThreadsLen;
+static AsyncReadObj* poolQueue[MaxAsyncReads];
+static U32           poolQueueHead;
+static U32           poolQueueTail;
+static bool          poolExit;
+
+//--------------------------------------------------------------------------------------------------
+
+static bool InitUring() {
+	io_uring_params params = {};
+	int const fd = (int)syscall(SYS_io_uring_setup, UringEntries, &params);
+	if (fd < 0) {
+		return false;
+	}
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {	// pre-5.4: not worth a second code path
+		close(fd);
+		return false;
+	}
+
+	U64 const sqRingSize = params.sq_off.array + params.sq_entries * sizeof(U32);
+	U64 const cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	uring.ringSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+	uring.ring = mmap(nullptr, uring.ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (uring.ring == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+	uring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	uring.sqes = (io_uring_sqe*)mmap(nullptr, uring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (uring.sqes == MAP_FAILED) {
+		munmap(uring.ring, uring.ringSize);
+		close(fd);
+		return false;
+	}
+
+	U8* const ring = (U8*)uring.ring;
+	uring.fd       = fd;
+	uring.sqHead   = (U32*)(ring + params.sq_off.head);
+	uring.sqTail   = (U32*)(ring + params.sq_off.tail);
+	uring.sqMask   = *(U32*)(ring + params.sq_off.ring_mask);
+	uring.sqArray  = (U32*)(ring + params.sq_off.array);
+	uring.cqHead   = (U32*)(ring + params.cq_off.head);
+	uring.cqTail   = (U32*)(ring + params.cq_off.tail);
+	uring.cqMask   = *(U32*)(ring + params.cq_off.ring_mask);
+	uring.cqes     = (io_uring_cqe*)(ring + params.cq_off.cqes);
+	uring.toSubmit = 0;
+	uring.inFlight = 0;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void ShutdownUring() {
+	munmap(uring.sqes, uring.sqesSize);
+	munmap(uring.ring, uring.ringSize);
+	close(uring.fd);
+	uring = {};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void SetReadErr(AsyncReadObj* obj, int errNo) {
+	obj->errFn = "read";
+	obj->errNo = errNo;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void PoolThreadFn(void*) {
+	for (;;) {
+		Sys::WaitSem(&poolSem);
+		Sys::LockMutex(&poolMutex);
+		if (poolExit) {
+			Sys::UnlockMutex(&poolMutex);
+			return;
+		}
+		Assert(poolQueueHead != poolQueueTail);
+		AsyncReadObj* const obj = poolQueue[poolQueueHead % MaxAsyncReads];
+		poolQueueHead++;
+		Sys::UnlockMutex(&poolMutex);
+
+		int err = 0;
+		while (obj->offset < obj->len) {
+			ssize_t const n = pread(obj->fd, obj->data + obj->offset, obj->len - obj->offset, (off_t)obj->offset);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				err = errno;
+				break;
+			}
+			if (n == 0) {
+				err = EIO;	// file shrank underneath us
+				break;
+			}
+			obj->offset += (U64)n;
+		}
+
+		Sys::LockMutex(&poolMutex);
+		if (err) {
+			SetReadErr(obj, err);
+		}
+		obj->done = true;
+		Sys::UnlockMutex(&poolMutex);
+		Sys::PostSem(&obj->doneSem);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void InitPool() {
+	Sys::InitMutex(&poolMutex);
+	Sys::InitSem(&poolSem, 0);
+	U32 const cpus = Sys::CpuCount();
+	poolThreadsLen = cpus < MaxPoolThreads ? cpus : MaxPoolThreads;
+	poolExit = false;
+	for (U32 i = 0; i < poolThreadsLen; i++) {
+		poolThreads[i] = Sys::StartThread(PoolThreadFn, nullptr);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void ShutdownPool() {
+	Sys::LockMutex(&poolMutex);
+	poolExit = true;
+	Sys::UnlockMutex(&poolMutex);
+	Sys::PostSem(&poolSem, poolThreadsLen);
+	for (U32 i = 0; i < poolThreadsLen; i++) {
+		Sys::JoinThread(poolThreads[i]);
+	}
+	poolThreadsLen = 0;
+	Sys::ShutdownSem(&poolSem);
+	Sys::ShutdownMutex(&poolMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void InitAsync() {
+	useUring  = InitUring();
+	asyncInit = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Shutdown() {
+	if (!asyncInit) {
+		return;
+	}
+	Assert(!uring.inFlight);
+	if (uring.ring) {
+		ShutdownUring();
+	}
+	if (poolThreadsLen) {
+		ShutdownPool();
+	}
+	useUring  = false;
+	asyncInit = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static int UringEnter(U32 toSubmit, U32 minComplete) {
+	for (;;) {
+		int const r = (int)syscall(SYS_io_uring_enter, uring.fd, toSubmit, minComplete, minComplete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+		if (r >= 0 || errno != EINTR) {
+			return r;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void UringFlush() {
+	if (uring.toSubmit) {
+		int const r = UringEnter(uring.toSubmit, 0);
+		if (r < 0) {
+			Panic("io_uring_enter failed: errno=%i", errno);
+		}
+		uring.toSubmit -= (U32)r;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void UringReap(U32 minComplete);
+
+static void UringPush(AsyncReadObj* obj) {
+	// Never have more in flight than the ring has sq slots: the cq (2x) can then never overflow
+	while (uring.inFlight == UringEntries) {
+		UringFlush();
+		UringReap(1);
+	}
+	U32 const tail = *uring.sqTail;
+	U32 const idx  = tail & uring.sqMask;
+	io_uring_sqe* const sqe = &uring.sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode    = IORING_OP_READ;
+	sqe->fd        = obj->fd;
+	sqe->off       = obj->offset;
+	sqe->addr      = (U64)(obj->data + obj->offset);
+	U64 const rem  = obj->len - obj->offset;
+	sqe->len       = rem > 0x7ffff000 ? 0x7ffff000 : (U32)rem;	// read() caps a single transfer here anyway
+	sqe->user_data = (U64)(obj - asyncReadObjs);
+	uring.sqArray[idx] = idx;
+	__atomic_store_n(uring.sqTail, tail + 1, __ATOMIC_RELEASE);
+	uring.toSubmit++;
+	uring.inFlight++;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void UringReap(U32 minComplete) {
+	if (minComplete) {
+		if (UringEnter(uring.toSubmit, minComplete) < 0) {
+			Panic("io_uring_enter failed: errno=%i", errno);
+		}
+		uring.toSubmit = 0;
+	}
+	U32 head = *uring.cqHead;
+	U32 const tail = __atomic_load_n(uring.cqTail, __ATOMIC_ACQUIRE);
+	bool resubmitted = false;
+	for (; head != tail; head++) {
+		io_uring_cqe const* const cqe = &uring.cqes[head & uring.cqMask];
+		Assert(cqe->user_data > 0 && cqe->user_data < MaxAsyncReads);
+		AsyncReadObj* const obj = &asyncReadObjs[cqe->user_data];
+		uring.inFlight--;
+		if (cqe->res < 0) {
+			SetReadErr(obj, -cqe->res);
+			obj->done = true;
+		} else if (cqe->res == 0) {
+			SetReadErr(obj, EIO);	// file shrank underneath us
+			obj->done = true;
+		} else {
+			obj->offset += (U64)cqe->res;
+			if (obj->offset < obj->len) {
+				__atomic_store_n(uring.cqHead, head + 1, __ATOMIC_RELEASE);	// free the slot before pushing
+				UringPush(obj);	// short read: queue the rest
+				resubmitted = true;
+			} else {
+				obj->done = true;
+			}
+		}
+	}
+	__atomic_store_n(uring.cqHead, head, __ATOMIC_RELEASE);
+	if (resubmitted) {
+		UringFlush();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static AsyncReadObj* AllocAsyncReadObj() {
+	U32 i = 0;
+	if (asyncReadsFree) {
+		i = asyncReadsFree;
+		asyncReadsFree = asyncReadObjs[i].nextFree;
+	} else {
+		Assert(asyncReadsLen < MaxAsyncReads);
+		i = asyncReadsLen++;
+	}
+	AsyncReadObj* const obj = &asyncReadObjs[i];
+	*obj = {};
+	return obj;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void FreeAsyncReadObj(AsyncReadObj* obj) {
+	U32 const i = (U32)(obj - asyncReadObjs);
+	obj->nextFree  = asyncReadsFree;
+	asyncReadsFree = i;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Span<AsyncRead> ReadAllBytesAsync(Mem mem, Span<Str> paths) {
+	if (!asyncInit) {
+		InitAsync();
+	}
+	if (!useUring && !poolThreadsLen) {
+		InitPool();
+	}
+
+	Span<AsyncRead> asyncReads = Mem::AllocSpan<AsyncRead>(mem, paths.len);
+	U32 pooledLen = 0;
+	for (U64 i = 0; i < paths.len; i++) {
+		AsyncReadObj* const obj = AllocAsyncReadObj();
+		asyncReads[i] = AsyncRead { .handle = (U64)(obj - asyncReadObjs) };
+		obj->path = paths[i];
+		obj->fd   = open(PathZ(tempMem, paths[i]), O_RDONLY | O_CLOEXEC);
+		if (obj->fd < 0) {
+			obj->errFn = "open";
+			obj->errNo = errno;
+			obj->done  = true;
+			continue;
+		}
+		struct stat st;
+		if (fstat(obj->fd, &st)) {
+			obj->errFn = "fstat";
+			obj->errNo = errno;
+			obj->done  = true;
+			continue;
+		}
+		obj->len  = (U64)st.st_size;
+		obj->data = (U8*)Mem::AllocUninit(mem, obj->len);
+		if (obj->len == 0) {
+			obj->done = true;
+		} else if (useUring) {
+			UringPush(obj);
+		} else {
+			obj->pooled = true;
+			Sys::InitSem(&obj->doneSem, 0);
+			Sys::LockMutex(&poolMutex);
+			poolQueue[poolQueueTail % MaxAsyncReads] = obj;
+			poolQueueTail++;
+			Sys::UnlockMutex(&poolMutex);
+			pooledLen++;
+		}
+	}
+
+	if (useUring) {
+		UringFlush();
+	} else if (pooledLen) {
+		Sys::PostSem(&poolSem, pooledLen);
+	}
+	return asyncReads;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static AsyncReadObj* GetAsyncReadObj(AsyncRead asyncRead) {
+	Assert(asyncRead.handle > 0 && asyncRead.handle < asyncReadsLen);
+	return &asyncReadObjs[asyncRead.handle];
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool IsDone(AsyncRead asyncRead) {
+	AsyncReadObj* const obj = GetAsyncReadObj(asyncRead);
+	if (obj->pooled) {
+		Sys::LockMutex(&poolMutex);
+		bool const done = obj->done;
+		Sys::UnlockMutex(&poolMutex);
+		return done;
+	}
+	if (!obj->done && uring.inFlight) {
+		UringReap(0);
+	}
+	return obj->done;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Res<Span<U8>> Wait(AsyncRead asyncRead) {
+	AsyncReadObj* const obj = GetAsyncReadObj(asyncRead);
+	if (obj->pooled) {
+		Sys::WaitSem(&obj->doneSem);
+		Sys::ShutdownSem(&obj->doneSem);
+		Sys::LockMutex(&poolMutex);	// pairs with the worker's unlock: its writes to obj are visible
+		Sys::UnlockMutex(&poolMutex);
+	} else {
+		while (!obj->done) {
+			UringReap(1);
+		}
+	}
+	if (obj->fd >= 0) {
+		close(obj->fd);
+	}
+	char const* const errFn = obj->errFn;
+	int         const errNo = obj->errNo;
+	Str         const path  = obj->path;
+	Span<U8>    const data(obj->data, obj->len);
+	FreeAsyncReadObj(obj);
+	if (errFn) {
+		errno = errNo;
+		return Linux_Errno(errFn, "path", path);
+	}
+	return data;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("File.Async.Linux") {
+	Str const dir = "/tmp/JC_FileAsyncTest";
+	mkdir(dir.data, 0700);
+
+	constexpr U32 FilesLen = 40;
+	Str paths[FilesLen + 1];
+	for (U32 i = 0; i < FilesLen; i++) {
+		paths[i] = SPrintf(testMem, "%s/%u.bin", dir, i);
+		int const fd = open(PathZ(tempMem, paths[i]), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+		Unit_Check(fd >= 0);
+		U64 const len = (U64)i * 10000;	// includes an empty file
+		U8* const buf = Mem::AllocUninitT<U8>(testMem, len);
+		for (U64 j = 0; j < len; j++) {
+			buf[j] = (U8)(i + j);
+		}
+		Unit_CheckEq((U64)write(fd, buf, len), len);
+		close(fd);
+	}
+	paths[FilesLen] = SPrintf(testMem, "%s/missing.bin", dir);
+	Defer {
+		for (U32 i = 0; i < FilesLen; i++) {
+			unlink(PathZ(tempMem, paths[i]));
+		}
+		rmdir(dir.data);
+	};
+
+	auto Check = [&]() {
+		Span<AsyncRead> const asyncReads = ReadAllBytesAsync(testMem, Span<Str>(paths, FilesLen + 1));
+		for (U32 i = 0; i < FilesLen; i++) {
+			Span<U8> data;
+			Unit_Check(Wait(asyncReads[i]).To(data));
+			Unit_CheckEq(data.len, (U64)i * 10000);
+			bool eq = true;
+			for (U64 j = 0; j < data.len; j++) {
+				eq &= data[j] == (U8)(i + j);
+			}
+			Unit_Check(eq);
+		}
+		Span<U8> data;
+		Res<> const r = Wait(asyncReads[FilesLen]).To(data);
+		Unit_Check(!r && r.err->uCode == ENOENT);
+	};
+
+	if (!asyncInit) {
+		InitAsync();
+	}
+	bool const hasUring = useUring;
+	Unit_SubTest("Default") { Check(); }
+	Unit_SubTest("Pool") {
+		useUring = false;
+		Check();
+		useUring = hasUring;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void EnumTree(Mem mem, Str dir, DynamicArray<Str>* paths) {
+	DIR* const d = opendir(PathZ(tempMem, dir));
+	if (!d) {
+		return;
+	}
+	while (dirent const* const entry = readdir(d)) {
+		Str const name = entry->d_name;
+		if (name == "." || name == "..") {
+			continue;
+		}
+		Str const path = SPrintf(mem, "%s/%s", dir, name);
+		if (entry->d_type == DT_DIR) {
+			EnumTree(mem, path, paths);
+		} else if (entry->d_type == DT_REG) {
+			paths->Add(path);
+		}
+	}
+	closedir(d);
+}
+
+// Drop the files' clean pages so the next read has to go to disk: no root needed, unlike drop_caches
+static void EvictFromPageCache(Span<Str> paths) {
+	for (U64 i = 0; i < paths.len; i++) {
+		int const fd = open(PathZ(tempMem, paths[i]), O_RDONLY | O_CLOEXEC);
+		if (fd >= 0) {
+			posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+			close(fd);
+		}
+	}
+}
+
+// Loads every file under Assets/ (run from the repo root):
+// one blocking ReadAllBytes() at a time vs one async batch, cold and warm page cache
+Bench_Def("File: Assets/ blocking vs batched async") {
+	DynamicArray<Str> pathsArr(benchMem, 64);
+	EnumTree(benchMem, "Assets", &pathsArr);
+	Span<Str> const paths(pathsArr.data, pathsArr.len);
+	if (!paths.len) {
+		Bench::Report("no Assets/ dir: skipped", 0, 1);
+		return;
+	}
+
+	if (!asyncInit) {
+		InitAsync();
+	}
+	bool const hasUring = useUring;
+
+	constexpr U32 Iters = 20;
+	for (U32 pass = 0; pass < 2; pass++) {
+		bool const cold = pass == 0;
+		for (U32 mode = 0; mode < 3; mode++) {
+			if (mode == 1 && !hasUring) {
+				continue;
+			}
+			useUring = mode == 1;
+			U64 ticks = 0;
+			U64 bytes = 0;
+			for (U32 iter = 0; iter < Iters; iter++) {
+				if (cold) {
+					EvictFromPageCache(paths);
+				}
+				MemMark const mark = Mem::Mark(benchMem);
+				U64 const start = Time::Now();
+				if (mode == 0) {
+					for (U64 i = 0; i < paths.len; i++) {
+						Span<U8> data;
+						if (ReadAllBytes(benchMem, paths[i]).To(data)) {
+							bytes += data.len;
+						}
+					}
+				} else {
+					Span<AsyncRead> const asyncReads = ReadAllBytesAsync(benchMem, paths);
+					for (U64 i = 0; i < asyncReads.len; i++) {
+						Span<U8> data;
+						if (Wait(asyncReads[i]).To(data)) {
+							bytes += data.len;
+						}
+					}
+				}
+				ticks += Time::Now() - start;
+				Mem::Reset(benchMem, mark);
+			}
+			Bench::Consume(bytes);
+			static constexpr char const* modeNames[] = { "blocking", "io_uring", "thread pool" };
+			Bench::Report(SPrintf(benchMem, "%s, %s: %u files", cold ? "cold" : "warm", modeNames[mode], paths.len), ticks, Iters * paths.len);
+		}
+	}
+	useUring = hasUring;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::File
\ No newline at end of file
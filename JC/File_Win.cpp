@@ -9,6 +9,9 @@ namespace JC::File {
 
 //--------------------------------------------------------------------------------------------------
 
+DefErr(File, TooBig);
+DefErr(File, ShortRead);
+
 static constexpr U32 MaxFiles = 64;
 
 struct FileObj {
@@ -90,23 +93,44 @@ Res<> Read(File file, void* out, U64 outLen) {
 
 //--------------------------------------------------------------------------------------------------
 
-Res<Span<U8>> ReadAllBytes(Mem mem, Str path) {
-	File file; TryTo(Open(path), file);
-	Defer { Close(file); };
-	U64 len = 0; TryTo(Len(file), len);
-	U8* buf = (U8*)Mem::Alloc(mem, len);
-	if (Res<> r = Read(file, buf, len); !r) {
-		return r.err;
+// Maps the whole file read-only: no arena copy, pages come straight from the OS file cache.
+// The view stays valid until Unmap(), independent of any File handle. Empty files map to an empty span.
+Res<Span<U8 const>> Map(Str path) {
+	Mem const scratch = Mem::GetScratch();
+	MemScope(scratch);
+	HANDLE const hfile = CreateFileW(Unicode::Utf8ToWtf16z(scratch, path).data, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+	if (!Sys::IsValidHandle(hfile)) {
+		return Win_LastErr("CreateFileW", "path", path);
 	}
-	return Span<U8>(buf, len);
+	Defer { CloseHandle(hfile); };
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(hfile, &fileSize) == 0) {
+		return Win_LastErr("GetFileSizeEx", "path", path);
+	}
+	if (fileSize.QuadPart == 0) {
+		return Span<U8 const>();
+	}
+
+	HANDLE const hmap = CreateFileMappingW(hfile, 0, PAGE_READONLY, 0, 0, 0);
+	if (!hmap) {
+		return Win_LastErr("CreateFileMappingW", "path", path);
+	}
+	Defer { CloseHandle(hmap); };	// the view holds its own reference
+
+	void const* const p = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+	if (!p) {
+		return Win_LastErr("MapViewOfFile", "path", path);
+	}
+	return Span<U8 const>((U8 const*)p, (U64)fileSize.QuadPart);
 }
 
 //--------------------------------------------------------------------------------------------------
 
-Res<Str> ReadAllStr(Mem mem, Str path) {
-	Span<U8> bytes; TryTo(ReadAllBytes(mem, path), bytes);
-	Assert(bytes.len <= (U64)U32Max);
-	return Str((char const*)bytes.data, (U32)bytes.len);
+void Unmap(Span<U8 const> data) {
+	if (data.data) {
+		UnmapViewOfFile(data.data);
+	}
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -153,24 +177,6 @@ Res<Span<Str>> EnumFiles(Str dir, Str ext) {
 
 //--------------------------------------------------------------------------------------------------
 
-// Takes a file path and removes the extension, including the dot, if any
-Str RemoveExt(Str path) {
-	if (path.len == 0) {
-		return path;
-	}
-	char const* iter = path.data + path.len - 1;
-	char const* const begin = path.data;
-	while (iter >= begin && *iter != '/' && *iter != '\\') {
-		if (*iter == '.') {
-			return Str(begin, (U32)(iter - begin));
-		}
-		iter--;
-	}
-	return path;
-}
-
-//--------------------------------------------------------------------------------------------------
-
 // returns true if path1 and path2 are the same windows path
 // both can be relative
 // both can be absolute
@@ -202,120 +208,142 @@ bool PathsEq(Str path1, Str path2) {
 	return CompareStringOrdinal(buf1, (int)len1, buf2, (int)len2, TRUE) == CSTR_EQUAL;
 }
 
+// Async reads are plain overlapped I/O: the kernel queues every ReadFile() in the batch at once,
+// so there's nothing to pump and no thread pool to run.
+
+static constexpr U32 MaxAsyncReads = 1024;
+
+// A failure is kept as its raw parts and only made into an Err in Wait(): Errs live in the thread's
+// store until the next Err::Update(), and a read may be waited on frames after it was queued
+struct AsyncReadObj {
+	Str         path;
+	HANDLE      hfile;
+	OVERLAPPED  overlapped;
+	U8*         data;
+	U64         len;
+	U64         tooBigLen;	// nonzero: more than one ReadFile() can read
+	char const* errFn;	// the call that failed, if any
+	DWORD       errCode;	// its GetLastError()
+	U32         nextFree;
+};
+
+static AsyncReadObj asyncReadObjs[MaxAsyncReads];
+static U32          asyncReadsFree;	// 0 is reserved for invalid, so 0 also means empty
+static U32          asyncReadsLen = 1;
+
 //--------------------------------------------------------------------------------------------------
 
-// returns true if `path` has extension `ext`. Extension may include multiple dots, like ".sprites.def"
-// `ext` may either have a preceding dot '.' or not. It should function the same in both cases:
-// HasExt(path, ".exe") equivalent to HasExt(path, "exe")
-bool HasExt(Str path, Str ext) {
-	if (ext.len > 0 && ext[0] == '.') {
-		ext = Str(ext.data + 1, ext.len - 1);
-	}
-	if (ext.len == 0 || path.len <= ext.len) {
-		return false;
-	}
-	if (path.data[path.len - ext.len - 1] != '.') {
-		return false;
-	}
-	char const* suffix = path.data + path.len - ext.len;
-	for (U32 i = 0; i < ext.len; i++) {
-		if (suffix[i] != ext.data[i]) {
-			return false;
+void Shutdown() {
+	// nothing to tear down: every AsyncRead closes its own handle in Wait()
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static AsyncReadObj* GetAsyncReadObj(AsyncRead asyncRead) {
+	Assert(asyncRead.handle > 0 && asyncRead.handle < asyncReadsLen);
+	return &asyncReadObjs[asyncRead.handle];
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Span<AsyncRead> ReadAllBytesAsync(Mem mem, Span<Str> paths) {
+	Span<AsyncRead> asyncReads = Mem::AllocSpan<AsyncRead>(mem, paths.len);
+	for (U64 i = 0; i < paths.len; i++) {
+		U32 idx = 0;
+		if (asyncReadsFree) {
+			idx = asyncReadsFree;
+			asyncReadsFree = asyncReadObjs[idx].nextFree;
+		} else {
+			Assert(asyncReadsLen < MaxAsyncReads);
+			idx = asyncReadsLen++;
+		}
+		AsyncReadObj* const obj = &asyncReadObjs[idx];
+		*obj = {};
+		obj->path = paths[i];
+		asyncReads[i] = AsyncRead { .handle = idx };
+
+		obj->hfile = CreateFileW(Unicode::Utf8ToWtf16z(tempMem, paths[i]).data, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+		if (!Sys::IsValidHandle(obj->hfile)) {
+			obj->hfile   = 0;
+			obj->errFn   = "CreateFileW";
+			obj->errCode = GetLastError();
+			continue;
+		}
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(obj->hfile, &fileSize) == 0) {
+			obj->errFn   = "GetFileSizeEx";
+			obj->errCode = GetLastError();
+			continue;
+		}
+		if ((U64)fileSize.QuadPart > U32Max) {
+			obj->tooBigLen = (U64)fileSize.QuadPart;	// one overlapped ReadFile() per file
+			continue;
+		}
+		obj->len  = (U64)fileSize.QuadPart;
+		obj->data = (U8*)Mem::AllocUninit(mem, obj->len);
+		if (obj->len && ReadFile(obj->hfile, obj->data, (DWORD)obj->len, 0, &obj->overlapped) == FALSE && GetLastError() != ERROR_IO_PENDING) {
+			obj->errFn   = "ReadFile";
+			obj->errCode = GetLastError();
 		}
 	}
-	return true;
+	return asyncReads;
 }
 
 //--------------------------------------------------------------------------------------------------
 
-// Returns maximum extension: GetMaxExt("foo.bar.baz.qux") -> "bar.baz.qux"
-Str GetMaxExt(Str path) {
-	U32 nameStart = 0;
-	for (U32 i = 0; i < path.len; i++) {
-		if (path[i] == '/' || path[i] == '\\') { nameStart = i + 1; }
-	}
-	for (U32 i = nameStart; i < path.len; i++) {
-		if (path[i] == '.') { return Str(path.data + i + 1, path.len - i - 1); }
-	}
-	return Str();
+bool IsDone(AsyncRead asyncRead) {
+	AsyncReadObj* const obj = GetAsyncReadObj(asyncRead);
+	return obj->errFn || obj->tooBigLen || !obj->len || HasOverlappedIoCompleted(&obj->overlapped);
 }
 
 //--------------------------------------------------------------------------------------------------
 
-Unit_Test("File") {
-	Unit_SubTest("RemoveExt") {
-		Unit_CheckEq(RemoveExt(""), "");
-		Unit_CheckEq(RemoveExt("a"), "a");
-		Unit_CheckEq(RemoveExt("a."), "a");
-		Unit_CheckEq(RemoveExt("a.a"), "a");
-		Unit_CheckEq(RemoveExt("a.abc123"), "a");
-		Unit_CheckEq(RemoveExt("a.foo/b.bar/c.qux/d"), "a.foo/b.bar/c.qux/d");
-		Unit_CheckEq(RemoveExt("a.foo/b.bar/c.qux/d.bat"), "a.foo/b.bar/c.qux/d");
-		Unit_CheckEq(RemoveExt("a.foo\\b.bar\\c.qux\\d"), "a.foo\\b.bar\\c.qux\\d");
-		Unit_CheckEq(RemoveExt("a.foo\\b.bar\\c.qux\\d.bat"), "a.foo\\b.bar\\c.qux\\d");
-		Unit_CheckEq(RemoveExt("file.tar.gz"), "file.tar");
-		Unit_CheckEq(RemoveExt(".hidden"), "");
-		Unit_CheckEq(RemoveExt("path/.hidden"), "path/");
+Res<Span<U8>> Wait(AsyncRead asyncRead) {
+	AsyncReadObj* const obj = GetAsyncReadObj(asyncRead);
+	DWORD bytesRead = 0;
+	if (!obj->errFn && !obj->tooBigLen && obj->len) {
+		if (GetOverlappedResult(obj->hfile, &obj->overlapped, &bytesRead, TRUE) == FALSE) {
+			obj->errFn   = "GetOverlappedResult";
+			obj->errCode = GetLastError();
+		}
 	}
-
-	Unit_SubTest("GetMaxExt") {
-		Unit_CheckEq(GetMaxExt(""),                        "");
-		Unit_CheckEq(GetMaxExt("a"),                       "");
-		Unit_CheckEq(GetMaxExt("a."),                      "");
-		Unit_CheckEq(GetMaxExt("a.b"),                     "b");
-		Unit_CheckEq(GetMaxExt("a.b.c"),                   "b.c");
-		Unit_CheckEq(GetMaxExt("foo.bar.baz.qux"),         "bar.baz.qux");
-		Unit_CheckEq(GetMaxExt(".hidden"),                 "hidden");
-		Unit_CheckEq(GetMaxExt("a.foo/b.bar/c.qux/d"),    "");
-		Unit_CheckEq(GetMaxExt("a.foo/b.bar/c.qux/d.e"),  "e");
-		Unit_CheckEq(GetMaxExt("a.foo\\b.bar\\c.qux\\d"), "");
-		Unit_CheckEq(GetMaxExt("dir/file.tar.gz"),         "tar.gz");
-		Unit_CheckEq(GetMaxExt("path/.hidden"),            "hidden");
+	if (obj->hfile) {
+		CloseHandle(obj->hfile);
 	}
-
-	Unit_SubTest("PathsEq") {
-		Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/bar.txt"),          true);
-		Unit_CheckEq(PathsEq("foo/bar.txt",          "foo\\bar.txt"),         true);
-		Unit_CheckEq(PathsEq("foo/./bar.txt",        "foo/bar.txt"),          true);
-		Unit_CheckEq(PathsEq("foo/baz/../bar.txt",   "foo/bar.txt"),          true);
-		Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/BAR.TXT"),          true);
-		Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/baz.txt"),          false);
-		Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "C:\\foo\\bar.txt"),     true);
-		Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "c:\fOo/BaR.TXT"),       true);
-		Unit_CheckEq(PathsEq("C:/foo/baz/../bar.txt","C:/foo/bar.txt"),       true);
-		Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "foo/bar.txt"),          false);  // abs vs rel
-		Unit_CheckEq(PathsEq("C:",                   "c:/"),                  true);
+	char const* const errFn     = obj->errFn;
+	DWORD       const errCode   = obj->errCode;
+	U64         const tooBigLen = obj->tooBigLen;
+	Str         const path      = obj->path;
+	Span<U8>    const data(obj->data, obj->len);
+	obj->nextFree  = asyncReadsFree;
+	asyncReadsFree = (U32)(obj - asyncReadObjs);
+	if (errFn) {
+		SetLastError(errCode);
+		return Win_LastErr(errFn, "path", path);
 	}
-
-	Unit_SubTest("HasExt") {
-		// Basic matching, with and without leading dot
-		Unit_CheckEq(HasExt("foo.exe",            "exe"),          true);
-		Unit_CheckEq(HasExt("foo.exe",            ".exe"),         true);
-		Unit_CheckEq(HasExt("foo.exe",            "png"),          false);
-		Unit_CheckEq(HasExt("foo",                "exe"),          false);
-		Unit_CheckEq(HasExt("",                   "exe"),          false);
-
-		// Multi-dot extensions
-		Unit_CheckEq(HasExt("foo.sprites.def",    ".sprites.def"), true);
-		Unit_CheckEq(HasExt("foo.sprites.def",    "sprites.def"),  true);
-		Unit_CheckEq(HasExt("foo.sprites.def",    ".def"),         true);
-		Unit_CheckEq(HasExt("foo.def",            ".sprites.def"), false);
-
-		// Path with directory components
-		Unit_CheckEq(HasExt("a.foo/b.bar/c.exe",  "exe"),          true);
-		Unit_CheckEq(HasExt("a.exe/b",            "exe"),          false);
-
-		// Hidden files (dot-prefixed names)
-		Unit_CheckEq(HasExt(".hidden",            "hidden"),       true);
-		Unit_CheckEq(HasExt("path/.hidden",       "hidden"),       true);
-
-		// Case sensitive
-		Unit_CheckEq(HasExt("foo.EXE",            "exe"),          false);
-		Unit_CheckEq(HasExt("foo.EXE",            "EXE"),          true);
-
-		// Just the extension
-		Unit_CheckEq(HasExt(".exe",               "exe"),          true);
+	if (tooBigLen) {
+		return Err_TooBig("path", path, "len", tooBigLen);
+	}
+	if (bytesRead != data.len) {
+		return Err_ShortRead("path", path, "len", data.len, "read", (U64)bytesRead);
 	}
+	return data;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("File.PathsEq") {
+	Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/bar.txt"),          true);
+	Unit_CheckEq(PathsEq("foo/bar.txt",          "foo\\bar.txt"),         true);
+	Unit_CheckEq(PathsEq("foo/./bar.txt",        "foo/bar.txt"),          true);
+	Unit_CheckEq(PathsEq("foo/baz/../bar.txt",   "foo/bar.txt"),          true);
+	Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/BAR.TXT"),          true);
+	Unit_CheckEq(PathsEq("foo/bar.txt",          "foo/baz.txt"),          false);
+	Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "C:\\foo\\bar.txt"),     true);
+	Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "c:\fOo/BaR.TXT"),       true);
+	Unit_CheckEq(PathsEq("C:/foo/baz/../bar.txt","C:/foo/bar.txt"),       true);
+	Unit_CheckEq(PathsEq("C:/foo/bar.txt",       "foo/bar.txt"),          false);  // abs vs rel
+	Unit_CheckEq(PathsEq("C:",                   "c:/"),                  true);
 }
 
 //--------------------------------------------------------------------------------------------------
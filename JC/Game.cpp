@@ -1,10 +1,13 @@
 #include "JC/App.h"
+#include "JC/Asset.h"
 #include "JC/Battle.h"
+#include "JC/Battle_Map.h"
 #include "JC/Cfg.h"
 #include "JC/Draw.h"
 #include "JC/File.h"
 #include "JC/Gpu.h"
 #include "JC/Hash.h"
+#include "JC/Task.h"
 #include "JC/Window.h"
 
 namespace JC::Game {
@@ -40,47 +43,92 @@ static Str ToLower(Mem mem, Str str) {
 	return Str(lower, str.len);
 }
 
-using LoadFn = Res<> (Str path);
+using LoadFn = Asset::Load (Str path);
 
 struct Loader {
 	Str     ext;
+	U32     phase;	// a phase's loads run together: a later phase may look up what earlier ones loaded
 	LoadFn* loadFn;
 };
 
+static constexpr U32 LoadPhases = 2;
+static constexpr U32 MaxLoads   = 64;
+
 static constexpr Loader loaders[] = {
-	{ "sprites.def", Draw::LoadSprites },
-	{ "font.def", Draw::LoadFont },
-	{ "map.def", Battle::LoadMap },
+	{ "sprites.def", 0, Draw::LoadSpritesAsync },
+	{ "font.def",    0, Draw::LoadFontAsync },
+	{ "map.def",     1, Battle::Map::LoadAsync },
+};
+
+struct Def {
+	Str path;	// permMem
+	U64 extHash;
 };
 
-static Res<> Load() {
+static Array<Def>         defs;
+static Array<Asset::Load> loads;	// the current phase's
+static bool               loaded;	// everything is in and the battle generated
+static Err const*         loadErr;	// set by LoadAll() in Task::Update(), returned by the Update() right after it
+
+// Once, from Init(): File and tempMem are the main thread's, and the loads start from Update()
+static Res<> FindDefs() {
 	Span<Str> paths; TryTo(File::EnumFiles("Assets", "def"), paths);
-	Span<U64> extHashes = Mem::AllocSpan<U64>(tempMem, paths.len);
+	defs.Init(permMem, paths.len);
 	for (U64 i = 0; i < paths.len; i++) {
-		extHashes[i] = Hash(ToLower(tempMem, File::GetMaxExt(paths[i])));
+		defs.Add({
+			.path    = SPrintf(permMem, "%s", paths[i]),
+			.extHash = Hash(ToLower(tempMem, File::GetMaxExt(paths[i]))),
+		});
 	}
+	return Ok();
+}
 
-	for (U64 i = 0; i < LenOf(loaders); i++) {
-		U64 extHash = Hash(loaders[i].ext);
-		for (U64 i = 0; i < extHashes.len; i++) {
-			if (extHashes[i] == extHash) {
-				Try(loaders[i].loadFn(paths[i]));
+static void StartLoadPhase(U32 phase) {
+	loads.len = 0;
+	for (U64 i = 0; i < defs.len; i++) {
+		for (U64 j = 0; j < LenOf(loaders); j++) {
+			if (loaders[j].phase == phase && Hash(loaders[j].ext) == defs[i].extHash) {
+				loads.Add(loaders[j].loadFn(defs[i].path));
 			}
 		}
 	}
-};
+}
+
+// Sleeps in the scheduler until each load is done, so the window keeps pumping while the workers
+// decode. By then the App has finished every load on the main thread, so WaitAll() just collects
+// errors and releases handles, safe from the sim thread.
+static Task::Task LoadAll() {
+	for (U32 phase = 0; phase < LoadPhases; phase++) {
+		StartLoadPhase(phase);
+		for (U64 i = 0; i < loads.len; i++) {
+			co_await Task::WaitLoad(loads[i]);
+		}
+		if (Res<> r = Asset::WaitAll(Span<Asset::Load const>(loads.data, loads.len)); !r) {
+			loadErr = r.err;
+			co_return;
+		}
+	}
+
+	Battle::Map::GenerateRandomMap(16, 16);
+	Battle::GenerateRandomArmies();
+	loaded = true;
+}
 
 //--------------------------------------------------------------------------------------------------
 
 Res<> Init(Window::State const* windowState) {
 	Battle::Init(permMem, tempMem, windowState);
-	//Effect::Init(permMem);
-
-	Try(Load());
+	//Effect::Init();
 	Try(Gpu::ImmediateWait());
 
-	Battle::GenerateRandomMap(16, 16);
-	Battle::GenerateRandomArmies();
+	loads.Init(permMem, MaxLoads);
+	loaded  = false;
+	loadErr = nullptr;
+	Try(FindDefs());
+	Task::Run(LoadAll());	// starts the first phase's loads here
+	if (loadErr) {
+		return loadErr;
+	}
 
 	return Ok();
 }
@@ -91,11 +139,20 @@ Res<> Update(App::UpdateData const* updateData) {
 	if (updateData->exit) {
 		return App::Err_Exit();
 	}
+	if (loadErr) {
+		Err const* const err = loadErr;
+		loadErr = nullptr;
+		return err;
+	}
+	if (!loaded) {
+		return Ok();
+	}
 	return Battle::Update(updateData);
 }
 
 //--------------------------------------------------------------------------------------------------
 
+// Nothing to show until the assets are in: Battle publishes its first frame once they are
 Res<> Draw() {
 	Battle::Draw();
 	return Ok();
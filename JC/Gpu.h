@@ -133,6 +133,8 @@ void           DestroyPipeline(Pipeline pipeline);
 Res<>          ImmediateCopyToBuffer(void const* data, U64 len, Buffer buffer, U64 offset);
 Res<>          ImmediateCopyToImage(void const* data, Image image, BarrierStage::Flags finalBarrierStageFlags, ImageLayout finalImageLayout);
 Res<>          ImmediateWait();
+U64            GetFrameNum();	// frameNum the next BeginFrame() will return
+Res<>          WaitFrame(U64 frameNum);	// blocks until the GPU has retired frameNum
 Res<FrameData> BeginFrame();
 Res<>          EndFrame();
 void           WaitIdle();
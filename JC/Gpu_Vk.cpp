@@ -98,8 +98,8 @@ struct PipelineObj {
 
 //--------------------------------------------------------------------------------------------------
 
-using BufferPool   = HandlePool<Buffer,   BufferObj>;
-using ImagePool    = HandlePool<Image,    ImageObj>;
+using BufferPool   = SlotMap<Buffer, BufferObj>;	// dense, so Shutdown() can sweep up leaks without walking dead slots
+using ImagePool    = SlotMap<Image,  ImageObj>;
 using ShaderPool   = HandlePool<Shader,   ShaderObj>;
 using PipelinePool = HandlePool<Pipeline, PipelineObj>;
 
@@ -730,15 +730,15 @@ static Res<> InitSwapchain(U32 width, U32 height, VkSwapchainKHR oldSwapchain) {
 		TryVk(vkCreateImageView(vkDevice, &vkImageViewCreateInfo, vkAllocationCallbacks, &vkSwapchainImageView));
 		VkNamef(vkSwapchainImageView, "vkSwapchainImageView#%u", i);
 
-		auto* const entry = imageObjs.Alloc();
-		swapchainImages[i] = entry->Handle();
-		entry->obj.vkImage       = vkSwapchainImages[i];
-		entry->obj.vkImageView   = vkSwapchainImageView;
-		entry->obj.allocation    = {};
-		entry->obj.width         = vkSwapchainExtent.width;
-		entry->obj.height        = vkSwapchainExtent.height;
-		entry->obj.vkFormat      = physicalDevice->vkSwapchainFormat;
-		entry->obj.bindlessIdx   = 0;
+		swapchainImages[i] = imageObjs.Alloc(ImageObj {
+			.vkImage     = vkSwapchainImages[i],
+			.vkImageView = vkSwapchainImageView,
+			.allocation  = {},
+			.width       = vkSwapchainExtent.width,
+			.height      = vkSwapchainExtent.height,
+			.vkFormat    = physicalDevice->vkSwapchainFormat,
+			.bindlessIdx = 0,
+		});
 	}
 
 	vkDeviceWaitIdle(vkDevice);
@@ -997,8 +997,8 @@ Res<> Init(InitDesc const* initDesc) {
 
 	Sys::InitMutex(&mutex);
 
-	bufferObjs.Init(permMem, MaxBuffers);
-	imageObjs.Init(permMem, MaxImages);
+	bufferObjs.Init(MaxBuffers);
+	imageObjs.Init(MaxImages);
 	shaderObjs.Init(permMem, MaxShaders);
 	pipelineObjs.Init(permMem, MaxPipelines);
 
@@ -1074,6 +1074,16 @@ void Shutdown() {
 	swapchainImages.len = 0;
 	DestroyVk(vkSwapchain, vkDestroySwapchainKHR);
 
+	// Whatever is still live was leaked by the caller
+	for (U32 i = imageObjs.Len(); i > 0; i--) {
+		DestroyImage(imageObjs.HandleAt(i - 1));
+	}
+	for (U32 i = bufferObjs.Len(); i > 0; i--) {
+		DestroyBuffer(bufferObjs.HandleAt(i - 1));
+	}
+	imageObjs.Shutdown();
+	bufferObjs.Shutdown();
+
 	if (vkFrameCommandPool != VK_NULL_HANDLE) {
 		vkFreeCommandBuffers(vkDevice, vkFrameCommandPool, MaxFrames, vkFrameCommandBuffers);
 	}
@@ -1341,9 +1351,7 @@ Res<Buffer> CreateBuffer(U64 size, BufferUsage::Flags bufferUsageFlags, MemoryLo
 		vkMemoryAllocateFlags
 	).To(bufferObj));
 
-	BufferPool::Entry* const entry = bufferObjs.Alloc();
-	entry->obj = bufferObj;
-	return entry->Handle();
+	return bufferObjs.Alloc(bufferObj);
 }
 
 //----------------------------------------------------------------------------------------------
@@ -1469,16 +1477,15 @@ Res<Image> CreateImage(U32 width, U32 height, ImageFormat format, ImageUsage::Fl
 		vkUpdateDescriptorSets(vkDevice, 1, &vkWriteDescriptorSet, 0, 0);
 	}
 
-	ImagePool::Entry* const entry = imageObjs.Alloc();
-	entry->obj.vkImage           = vkImage;
-	entry->obj.vkImageView       = vkImageView;
-	entry->obj.allocation        = allocation;
-	entry->obj.width             = width;
-	entry->obj.height            = height;
-	entry->obj.vkFormat          = vkFormat;
-	entry->obj.bindlessIdx       = bindlessIdx;
-
-	return entry->Handle();
+	return imageObjs.Alloc(ImageObj {
+		.vkImage     = vkImage,
+		.vkImageView = vkImageView,
+		.allocation  = allocation,
+		.width       = width,
+		.height      = height,
+		.vkFormat    = vkFormat,
+		.bindlessIdx = bindlessIdx,
+	});
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1980,6 +1987,27 @@ Res<> ImmediateCopyToImage(void const* data, Image image, BarrierStage::Flags fi
 
 //-------------------------------------------------------------------------------------------------
 
+U64 GetFrameNum() {
+	return frameNum;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+// Frame n signals the frame timeline to n + MaxFrames when it completes
+Res<> WaitFrame(U64 waitFrameNum) {
+	U64 const value = waitFrameNum + MaxFrames;
+	VkSemaphoreWaitInfo const vkSemaphoreWaitInfo = {
+		.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+		.pNext          = 0,
+		.flags          = 0,
+		.semaphoreCount = 1,
+		.pSemaphores    = &vkFrameTimelineSemaphore,
+		.pValues        = &value,
+	};
+	TryVk(vkWaitSemaphores(vkDevice, &vkSemaphoreWaitInfo, U64Max));
+	return Ok();
+}
+
 Res<FrameData> BeginFrame() {
 	VkSemaphoreWaitInfo const vkSemaphoreWaitInfo = {
 		.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
@@ -1,4 +1,8 @@
 #include "JC/HandlePool.h"
+
+#include "JC/Bench.h"
+#include "JC/Rng.h"
+#include "JC/Time.h"
 #include "JC/UnitTest.h"
 
 namespace JC {
@@ -59,4 +63,134 @@ Unit_Test("HandlePool") {
 
 //--------------------------------------------------------------------------------------------------
 
+Unit_Test("SlotMap") {
+	using FooMap = SlotMap<Foo, U64>;
+
+	Unit_SubTest("Alloc/Free") {
+		FooMap m;
+		m.Init(1024);
+		Defer { m.Shutdown(); };
+
+		Foo const h0 = m.Alloc(10);
+		Foo const h1 = m.Alloc(11);
+		Foo const h2 = m.Alloc(12);
+		Unit_Check(h0 && h1 && h2);
+		Unit_CheckEq(m.Len(), 3u);
+		Unit_CheckEq(*m.Get(h1), (U64)11);
+
+		m.Free(h0);	// 12 moves into the hole
+		Unit_CheckEq(m.Len(), 2u);
+		Unit_CheckEq(m.Objs()[0], (U64)12);
+		Unit_CheckEq(*m.Get(h2), (U64)12);
+		Unit_CheckEq(*m.Get(h1), (U64)11);
+		Unit_Check(m.TryGet(h0) == nullptr);
+		Unit_Check(m.HandleAt(0) == h2);
+
+		Foo const h3 = m.Alloc(13);	// reuses h0's slot with a new gen
+		Unit_CheckEq((U32)h3.handle, (U32)h0.handle);
+		Unit_Check(!(h3 == h0));
+		Unit_Check(m.TryGet(h0) == nullptr);
+		Unit_CheckEq(*m.TryGet(h3), (U64)13);
+
+		m.Free(h3);	// the last one: nothing moves
+		m.Free(h1);
+		m.Free(h2);
+		Unit_CheckEq(m.Len(), 0u);
+		Unit_Check(m.TryGet(h2) == nullptr);
+	}
+
+	Unit_SubTest("Churn") {
+		// Random alloc/free against a model: every live handle must resolve to its value, and Objs()
+		// must hold exactly the live values
+		constexpr U32 N = 2000;
+		FooMap m;
+		m.Init(N);
+		Defer { m.Shutdown(); };
+		Foo* const handles = Mem::AllocT<Foo>(testMem, N);	// handles[v % N] holds value v while live
+		Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+		U64 errors = 0;
+		for (U32 i = 0; i < 100000; i++) {
+			U64 const v = Rng::NextU64(&gen) % N;
+			if (handles[v]) {
+				errors += *m.Get(handles[v]) != v;
+				m.Free(handles[v]);
+				errors += m.TryGet(handles[v]) != nullptr;
+				handles[v] = Foo();
+			} else {
+				handles[v] = m.Alloc(v);
+			}
+		}
+		U32 live = 0;
+		for (U32 v = 0; v < N; v++) {
+			if (handles[v]) {
+				live++;
+				errors += *m.Get(handles[v]) != v;
+			}
+		}
+		Span<U64> const objs = m.Objs();
+		for (U32 i = 0; i < objs.len; i++) {
+			errors += !(handles[objs[i]] == m.HandleAt(i));
+		}
+		Unit_CheckEq(errors, (U64)0);
+		Unit_CheckEq(m.Len(), live);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Visiting every live object with a quarter of capacity live: HandlePool has to walk every slot
+// and check its gen, SlotMap walks only the dense array.
+Bench_Def("HandlePool vs SlotMap: iterate live") {
+	constexpr U32 Cap   = 64 * 1024;
+	constexpr U32 Iters = 200;
+
+	struct Obj { U64 val; U64 pad[3]; };
+
+	HandlePool<Foo, Obj> pool;
+	pool.Init(benchMem, Cap + 1);
+	SlotMap<Foo, Obj> slotMap;
+	slotMap.Init(Cap);
+	Defer { slotMap.Shutdown(); };
+	Foo* const poolHandles = Mem::AllocT<Foo>(benchMem, Cap);
+	Foo* const mapHandles  = Mem::AllocT<Foo>(benchMem, Cap);
+	for (U32 i = 0; i < Cap; i++) {
+		auto* const entry = pool.Alloc();
+		entry->obj.val = i;
+		poolHandles[i] = entry->Handle();
+		mapHandles[i]  = slotMap.Alloc(Obj { .val = i });
+	}
+	for (U32 i = 0; i < Cap; i++) {
+		if (i % 4) {
+			pool.Free(poolHandles[i]);
+			slotMap.Free(mapHandles[i]);
+		}
+	}
+
+	U64 sum = 0;
+	U64 start = Time::Now();
+	for (U32 iter = 0; iter < Iters; iter++) {
+		for (U32 i = 1; i < pool.len; i++) {
+			if (pool.entries[i].gen) {
+				sum += pool.entries[i].obj.val;
+			}
+		}
+	}
+	U64 const poolTicks = Time::Now() - start;
+	start = Time::Now();
+	for (U32 iter = 0; iter < Iters; iter++) {
+		Span<Obj> const objs = slotMap.Objs();
+		for (U64 i = 0; i < objs.len; i++) {
+			sum += objs[i].val;
+		}
+	}
+	U64 const mapTicks = Time::Now() - start;
+
+	U64 const visits = (U64)Iters * slotMap.Len();
+	Bench::Report("HandlePool", poolTicks, visits);
+	Bench::Report("SlotMap",    mapTicks,  visits);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 }	// namespace JC
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "JC/Common.h"
+#include "JC/VArray.h"
 
 namespace JC {
 
@@ -87,4 +88,102 @@ template <class H, class T> struct HandlePool {
 
 //--------------------------------------------------------------------------------------------------
 
+// HandlePool with the objects kept packed: handles index a sparse slot table, each live slot points
+// at the object's place in a dense array, and Free() swap-removes from that array. Objs() is every
+// live object and nothing else, so iterating touches only live data.
+// Object addresses are not stable: Free() moves the last object into the hole. Hold handles.
+// Slot gens are odd while live and even while free, so a stale handle never matches.
+// Grows within a virtual reservation of maxLen, so nothing is copied when it does.
+// H must be declared using DefHandle(H)
+template <class H, class T> struct SlotMap {
+	struct Slot {
+		U32 gen;
+		U32 idx;	// dense index while live, next free slot + 1 while free
+	};
+
+	VArray<Slot> slots;
+	VArray<T>    objs;
+	VArray<U32>  objSlots;	// dense index -> slot index
+	U32          free = 0;	// free slot + 1: 0 is an empty list
+
+	void Init(U32 maxLen) {
+		slots.Init(maxLen);
+		objs.Init(maxLen);
+		objSlots.Init(maxLen);
+		free = 0;
+	}
+
+	void Shutdown() {
+		slots.Shutdown();
+		objs.Shutdown();
+		objSlots.Shutdown();
+		free = 0;
+	}
+
+	U32     Len()  const { return (U32)objs.len; }
+	Span<T> Objs()       { return Span<T>(objs.data, objs.len); }
+
+	H HandleAt(U32 i) const {
+		Assert(i < objs.len);
+		U32 const s = objSlots.data[i];
+		return H { .handle = ((U64)slots.data[s].gen << 32) | (U64)s };
+	}
+
+	T* Get(H h) {
+		U32 const s = (U32)h.handle;
+		Assert(s < slots.len);
+		Slot const* const slot = &slots.data[s];
+		Assert(slot->gen == (U32)(h.handle >> 32));
+		return &objs.data[slot->idx];
+	}
+
+	T* TryGet(H h) {
+		U32 const s = (U32)h.handle;
+		if (s >= slots.len) { return nullptr; }
+		Slot const* const slot = &slots.data[s];
+		if (slot->gen != (U32)(h.handle >> 32) || !(slot->gen & 1)) { return nullptr; }
+		return &objs.data[slot->idx];
+	}
+
+	H Alloc(T obj) {
+		U32 s = 0;
+		if (free) {
+			s = free - 1;
+			free = slots.data[s].idx;
+		} else {
+			s = (U32)slots.len;
+			slots.Add(Slot { .gen = 0, .idx = 0 });
+		}
+		Slot* const slot = &slots.data[s];
+		slot->gen++;	// even -> odd: live
+		slot->idx = (U32)objs.len;
+		objs.Add(obj);
+		objSlots.Add(s);
+		return H { .handle = ((U64)slot->gen << 32) | (U64)s };
+	}
+
+	void Free(H h) {
+		U32 const s = (U32)h.handle;
+		Assert(s < slots.len);
+		Slot* const slot = &slots.data[s];
+		Assert(slot->gen == (U32)(h.handle >> 32) && (slot->gen & 1));
+
+		U32 const i    = slot->idx;
+		U32 const last = (U32)objs.len - 1;
+		if (i != last) {
+			objs.data[i]     = objs.data[last];
+			objSlots.data[i] = objSlots.data[last];
+			slots.data[objSlots.data[i]].idx = i;
+		}
+		objs.Remove();
+		objSlots.Remove();
+
+		slot->gen++;	// odd -> even: free
+		slot->idx = free;
+		free = s + 1;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
 }	// namespace JC
\ No newline at end of file
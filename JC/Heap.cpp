@@ -0,0 +1,503 @@
+#include "JC/Heap.h"
+
+#include "JC/Bit.h"
+#include "JC/DynamicArray.h"
+#include "JC/Rng.h"
+#include "JC/Sys.h"
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Blocks are binned by size into FlCount power-of-two first levels, each split linearly into
+// SlCount second levels. Sizes below SmallSize all live in first level 0.
+// Every block is preceded by a 16-byte header; free blocks overlay their list links on the payload.
+// A zero-size used sentinel block sits at the end of committed memory so there's always a next block.
+
+static constexpr U32 MaxHeaps    = 16;
+static constexpr U32 AlignLog2   = 4;
+static constexpr U32 SlLog2      = 5;
+static constexpr U32 SlCount     = 1 << SlLog2;
+static constexpr U32 FlShift     = SlLog2 + AlignLog2;
+static constexpr U64 SmallSize   = (U64)1 << FlShift;
+static constexpr U32 FlMaxLog2   = 40;	// blocks up to 1TB
+static constexpr U32 FlCount     = FlMaxLog2 - FlShift + 1;
+static constexpr U64 HeaderSize  = 16;
+static constexpr U64 MinSize     = 16;	// room for the free list links
+static constexpr U64 MinCommit   = 64 * KB;
+
+static constexpr U64 FreeBit     = 1;
+static constexpr U64 PrevFreeBit = 2;
+static constexpr U64 FlagsMask   = FreeBit | PrevFreeBit;
+
+static_assert(Heap::Align == (U64)1 << AlignLog2);
+
+struct Block {
+	Block* prevPhys;
+	U64    sizeFlags;	// payload size | flags
+	Block* nextFree;	// free blocks only
+	Block* prevFree;	// free blocks only
+};
+
+static_assert(OffsetOf(Block, nextFree) == HeaderSize);
+
+struct HeapObj {
+	U8*    begin;
+	U8*    endCommit;
+	U8*    endReserve;
+	Block* sentinel;
+	U64    used;
+	U64    flBits;
+	U32    slBits[FlCount];
+	Block* freeLists[FlCount][SlCount];
+};
+
+static HeapObj    heapObjs[MaxHeaps];
+static Sys::Mutex heapObjsMutex;	// Create/Destroy only
+
+//--------------------------------------------------------------------------------------------------
+
+static U64    BlockSize(Block const* b) { return b->sizeFlags & ~FlagsMask; }
+static Block* NextPhys(Block* b)        { return (Block*)((U8*)b + HeaderSize + BlockSize(b)); }
+static void*  BlockToPtr(Block* b)      { return (U8*)b + HeaderSize; }
+static Block* PtrToBlock(void* p)       { return (Block*)((U8*)p - HeaderSize); }
+static U64    AdjustSize(U64 size)      { return Max(Bit::AlignUp(size, Heap::Align), MinSize); }
+
+static HeapObj* GetHeapObj(Heap heap) {
+	Assert(heap);
+	Assert(heap.handle < MaxHeaps);
+	HeapObj* const heapObj = &heapObjs[heap.handle];
+	Assert(heapObj->begin);
+	return heapObj;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void Mapping(U64 size, U32* fl, U32* sl) {
+	if (size < SmallSize) {
+		*fl = 0;
+		*sl = (U32)(size / (SmallSize / SlCount));
+	} else {
+		U32 const b = Bit::Bsr64(size);
+		*fl = b - (FlShift - 1);
+		*sl = (U32)(size >> (b - SlLog2)) ^ SlCount;
+	}
+	Assert(*fl < FlCount);
+}
+
+// Rounds up to the next bin boundary so any block in the resulting bin is large enough
+static void MappingSearch(U64 size, U32* fl, U32* sl) {
+	if (size >= SmallSize) {
+		size += ((U64)1 << (Bit::Bsr64(size) - SlLog2)) - 1;
+	}
+	Mapping(size, fl, sl);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void InsertFree(HeapObj* h, Block* b) {
+	U32 fl, sl;
+	Mapping(BlockSize(b), &fl, &sl);
+	Block* const head = h->freeLists[fl][sl];
+	b->nextFree = head;
+	b->prevFree = 0;
+	if (head) {
+		head->prevFree = b;
+	}
+	h->freeLists[fl][sl] = b;
+	h->flBits     |= (U64)1 << fl;
+	h->slBits[fl] |= (U32)1 << sl;
+}
+
+static void RemoveFree(HeapObj* h, Block* b) {
+	U32 fl, sl;
+	Mapping(BlockSize(b), &fl, &sl);
+	if (b->prevFree) {
+		b->prevFree->nextFree = b->nextFree;
+	} else {
+		Assert(h->freeLists[fl][sl] == b);
+		h->freeLists[fl][sl] = b->nextFree;
+	}
+	if (b->nextFree) {
+		b->nextFree->prevFree = b->prevFree;
+	}
+	if (!h->freeLists[fl][sl]) {
+		h->slBits[fl] &= ~((U32)1 << sl);
+		if (!h->slBits[fl]) {
+			h->flBits &= ~((U64)1 << fl);
+		}
+	}
+}
+
+// Finds and unlinks a free block with at least size bytes, or returns null
+static Block* FindFree(HeapObj* h, U64 size) {
+	U32 fl, sl;
+	MappingSearch(size, &fl, &sl);
+	if (fl >= FlCount) {
+		return 0;
+	}
+	U32 slBits = h->slBits[fl] & (U32Max << sl);
+	if (!slBits) {
+		U64 const flBits = (fl + 1 < 64) ? (h->flBits & (U64Max << (fl + 1))) : 0;
+		if (!flBits) {
+			return 0;
+		}
+		fl = Bit::Bsf64(flBits);
+		slBits = h->slBits[fl];
+	}
+	sl = Bit::Bsf64(slBits);
+	Block* const b = h->freeLists[fl][sl];
+	Assert(b && BlockSize(b) >= size);
+	RemoveFree(h, b);
+	return b;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Marks b free, coalesces it with free neighbors and puts the result on a free list
+static void ReleaseBlock(HeapObj* h, Block* b) {
+	b->sizeFlags |= FreeBit;
+	if (b->sizeFlags & PrevFreeBit) {
+		Block* const prev = b->prevPhys;
+		RemoveFree(h, prev);
+		prev->sizeFlags += HeaderSize + BlockSize(b);
+		b = prev;
+	}
+	Block* next = NextPhys(b);
+	if (next->sizeFlags & FreeBit) {
+		RemoveFree(h, next);
+		b->sizeFlags += HeaderSize + BlockSize(next);
+		next = NextPhys(b);
+	}
+	next->prevPhys   = b;
+	next->sizeFlags |= PrevFreeBit;
+	InsertFree(h, b);
+}
+
+static void MarkUsed(Block* b) {
+	b->sizeFlags &= ~FreeBit;
+	NextPhys(b)->sizeFlags &= ~PrevFreeBit;
+}
+
+// Trims a used block down to size, releasing the tail if it's big enough to be a block
+static void SplitBlock(HeapObj* h, Block* b, U64 size) {
+	U64 const blockSize = BlockSize(b);
+	Assert(blockSize >= size);
+	if (blockSize - size < HeaderSize + MinSize) {
+		return;
+	}
+	Block* const rest = (Block*)((U8*)b + HeaderSize + size);
+	rest->prevPhys  = b;
+	rest->sizeFlags = blockSize - size - HeaderSize;	// used, prev used
+	b->sizeFlags    = size | (b->sizeFlags & FlagsMask);
+	NextPhys(rest)->prevPhys = rest;
+	ReleaseBlock(h, rest);
+}
+
+// Commits more memory at the end of the heap: the old sentinel becomes the header of the new block
+static void Grow(HeapObj* h, U64 size) {
+	U64 need = size + HeaderSize;
+	if (size >= SmallSize) {
+		need += (U64)1 << (Bit::Bsr64(size) - SlLog2);	// so the new block lands in a bin MappingSearch will find
+	}
+	need = Bit::AlignUp(need, Sys::VirtualPageSize);
+	U64 const curCommit = (U64)(h->endCommit - h->begin);
+	U64 growBy = Max(need, curCommit);	// double
+	if (h->endCommit + growBy > h->endReserve) {
+		growBy = need;
+	}
+	Assert(h->endCommit + growBy <= h->endReserve);
+	Sys::VirtualCommit(h->endCommit, growBy);
+	h->endCommit += growBy;
+
+	Block* const b = h->sentinel;
+	b->sizeFlags = (growBy - HeaderSize) | (b->sizeFlags & PrevFreeBit);
+
+	h->sentinel = (Block*)(h->endCommit - HeaderSize);
+	h->sentinel->prevPhys  = b;
+	h->sentinel->sizeFlags = 0;
+	Assert(NextPhys(b) == h->sentinel);
+
+	ReleaseBlock(h, b);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Heap Heap::Create(U64 reserveSize) {
+	Assert(reserveSize >= MinCommit);
+	reserveSize = Bit::AlignUp(reserveSize, 64 * KB);
+	U8* const begin = (U8*)Sys::VirtualReserve(reserveSize);
+
+	Sys::LockMutex(&heapObjsMutex);
+	HeapObj* h = 0;
+	for (U32 i = 1; i < MaxHeaps; i++) {	// reserve zero
+		if (!heapObjs[i].begin) {
+			h = &heapObjs[i];
+			break;
+		}
+	}
+	Assert(h);
+	h->begin = begin;
+	Sys::UnlockMutex(&heapObjsMutex);
+
+	Sys::VirtualCommit(begin, MinCommit);
+	h->endCommit  = begin + MinCommit;
+	h->endReserve = begin + reserveSize;
+	h->used       = 0;
+	h->flBits     = 0;
+	memset(h->slBits, 0, sizeof(h->slBits));
+	memset(h->freeLists, 0, sizeof(h->freeLists));
+
+	Block* const first = (Block*)begin;
+	first->prevPhys  = 0;
+	first->sizeFlags = MinCommit - 2 * HeaderSize;
+	h->sentinel = NextPhys(first);
+	h->sentinel->prevPhys  = first;
+	h->sentinel->sizeFlags = 0;
+	ReleaseBlock(h, first);
+
+	return Heap { .handle = (U64)(h - heapObjs) };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Heap::Destroy(Heap heap) {
+	HeapObj* const h = GetHeapObj(heap);
+	Sys::VirtualFree(h->begin);
+	Sys::LockMutex(&heapObjsMutex);
+	h->begin = 0;
+	Sys::UnlockMutex(&heapObjsMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void* Heap::Alloc(Heap heap, U64 size) {
+	HeapObj* const h = GetHeapObj(heap);
+	U64 const adjustedSize = AdjustSize(size);
+	Block* b = FindFree(h, adjustedSize);
+	if (!b) {
+		Grow(h, adjustedSize);
+		b = FindFree(h, adjustedSize);
+		Assert(b);
+	}
+	MarkUsed(b);
+	SplitBlock(h, b, adjustedSize);
+	h->used += BlockSize(b);
+	return BlockToPtr(b);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Over-allocates by align plus room for a leading free block, then gives the leading gap back
+void* Heap::AllocAligned(Heap heap, U64 size, U64 align) {
+	Assert(Bit::IsPow2(align));
+	if (align <= Align) {
+		return Alloc(heap, size);
+	}
+	HeapObj* const h = GetHeapObj(heap);
+	U64 const adjustedSize = AdjustSize(size);
+	U64 const minGap = HeaderSize + MinSize;
+	U64 const searchSize = adjustedSize + align + minGap;
+	Block* b = FindFree(h, searchSize);
+	if (!b) {
+		Grow(h, searchSize);
+		b = FindFree(h, searchSize);
+		Assert(b);
+	}
+
+	U8* const p = (U8*)BlockToPtr(b);
+	U8* aligned = (U8*)Bit::AlignPtrUp(p, align);
+	if (aligned != p && (U64)(aligned - p) < minGap) {
+		aligned = (U8*)Bit::AlignPtrUp(p + minGap, align);
+	}
+	if (aligned != p) {
+		U64 const gap = (U64)(aligned - p);
+		Block* const alignedBlock = (Block*)(aligned - HeaderSize);
+		alignedBlock->prevPhys  = b;
+		alignedBlock->sizeFlags = BlockSize(b) - gap;
+		NextPhys(alignedBlock)->prevPhys = alignedBlock;
+		b->sizeFlags = (gap - HeaderSize) | (b->sizeFlags & PrevFreeBit);
+		ReleaseBlock(h, b);
+		b = alignedBlock;
+	}
+
+	MarkUsed(b);
+	SplitBlock(h, b, adjustedSize);
+	h->used += BlockSize(b);
+	return BlockToPtr(b);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void* Heap::Realloc(Heap heap, void* p, U64 newSize) {
+	if (!p) {
+		return Alloc(heap, newSize);
+	}
+	HeapObj* const h = GetHeapObj(heap);
+	Block* const b = PtrToBlock(p);
+	Assert(!(b->sizeFlags & FreeBit));
+	U64 const adjustedSize = AdjustSize(newSize);
+	U64 const oldSize = BlockSize(b);
+
+	if (adjustedSize <= oldSize) {
+		SplitBlock(h, b, adjustedSize);
+		h->used -= oldSize - BlockSize(b);
+		return p;
+	}
+
+	// Grow in place by absorbing a free next block
+	Block* const next = NextPhys(b);
+	if ((next->sizeFlags & FreeBit) && oldSize + HeaderSize + BlockSize(next) >= adjustedSize) {
+		RemoveFree(h, next);
+		b->sizeFlags += HeaderSize + BlockSize(next);
+		NextPhys(b)->prevPhys = b;
+		NextPhys(b)->sizeFlags &= ~PrevFreeBit;
+		SplitBlock(h, b, adjustedSize);
+		h->used += BlockSize(b) - oldSize;
+		return p;
+	}
+
+	void* const newP = Alloc(heap, newSize);
+	memcpy(newP, p, oldSize);
+	Free(heap, p);
+	return newP;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Heap::Free(Heap heap, void* p) {
+	if (!p) {
+		return;
+	}
+	HeapObj* const h = GetHeapObj(heap);
+	Block* const b = PtrToBlock(p);
+	Assert((U8*)b >= h->begin && (U8*)b < h->endCommit);
+	Assert(!(b->sizeFlags & FreeBit));	// double free
+	h->used -= BlockSize(b);
+	ReleaseBlock(h, b);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+U64 Heap::Size(void* p) {
+	Assert(p);
+	return BlockSize(PtrToBlock(p));
+}
+
+U64 Heap::UsedBytes(Heap heap) {
+	return GetHeapObj(heap)->used;
+}
+
+U64 Heap::CommitBytes(Heap heap) {
+	HeapObj const* const h = GetHeapObj(heap);
+	return (U64)(h->endCommit - h->begin);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Heap") {
+	Heap const heap = Heap::Create(1 * GB);
+	Defer { Heap::Destroy(heap); };
+
+	Unit_SubTest("Alloc/Free") {
+		U8* const p1 = (U8*)Heap::Alloc(heap, 1);
+		U8* const p2 = (U8*)Heap::Alloc(heap, 100);
+		U8* const p3 = (U8*)Heap::Alloc(heap, 5000);
+		Unit_CheckEq((U64)p1 % Heap::Align, (U64)0);
+		Unit_CheckEq((U64)p2 % Heap::Align, (U64)0);
+		Unit_CheckEq((U64)p3 % Heap::Align, (U64)0);
+		Unit_Check(Heap::Size(p1) >= 1);
+		Unit_Check(Heap::Size(p2) >= 100);
+		Unit_Check(Heap::Size(p3) >= 5000);
+		Unit_Check(p1 + Heap::Size(p1) <= p2);
+		Unit_Check(p2 + Heap::Size(p2) <= p3);
+
+		Heap::Free(heap, p2);
+		U8* const p4 = (U8*)Heap::Alloc(heap, 64);
+		Unit_CheckEq(p4, p2);	// reuses the hole
+
+		Heap::Free(heap, p1);
+		Heap::Free(heap, p3);
+		Heap::Free(heap, p4);
+		Unit_CheckEq(Heap::UsedBytes(heap), (U64)0);
+		Unit_CheckEq((U8*)Heap::Alloc(heap, 16), p1);	// everything coalesced back into one block
+	}
+
+	Unit_SubTest("Realloc") {
+		U8* const p = (U8*)Heap::Alloc(heap, 64);
+		for (U32 i = 0; i < 64; i++) { p[i] = (U8)i; }
+		U8* const q = (U8*)Heap::Realloc(heap, p, 4096);
+		Unit_CheckEq(q, p);	// next block was free: grows in place
+		U8* const blocker = (U8*)Heap::Alloc(heap, 16);
+		U8* const r = (U8*)Heap::Realloc(heap, q, 64 * KB);
+		Unit_CheckNeq(r, q);
+		bool same = true;
+		for (U32 i = 0; i < 64; i++) { same &= (r[i] == (U8)i); }
+		Unit_Check(same);
+		U8* const s = (U8*)Heap::Realloc(heap, r, 32);
+		Unit_CheckEq(s, r);
+		Unit_Check(Heap::Size(s) < 64 * KB);
+		Heap::Free(heap, s);
+		Heap::Free(heap, blocker);
+		Unit_CheckEq(Heap::UsedBytes(heap), (U64)0);
+	}
+
+	Unit_SubTest("AllocAligned") {
+		U8* const pad = (U8*)Heap::Alloc(heap, 16);
+		U8* const p64 = (U8*)Heap::AllocAligned(heap, 100, 64);
+		U8* const p4k = (U8*)Heap::AllocAligned(heap, 10, 4096);
+		Unit_CheckEq((U64)p64 % 64, (U64)0);
+		Unit_CheckEq((U64)p4k % 4096, (U64)0);
+		Unit_Check(Heap::Size(p64) >= 100);
+		memset(p64, 0xaa, 100);
+		memset(p4k, 0xbb, 10);
+		Heap::Free(heap, p64);
+		Heap::Free(heap, p4k);
+		Heap::Free(heap, pad);
+		Unit_CheckEq(Heap::UsedBytes(heap), (U64)0);
+	}
+
+	Unit_SubTest("Stress") {
+		constexpr U32 MaxLive = 512;
+		U8* ptrs[MaxLive] = {};
+		U64 sizes[MaxLive] = {};
+		Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+		bool ok = true;
+		for (U32 iter = 0; iter < 20000; iter++) {
+			U64 const rng = Rng::NextU64(&gen);
+			U32 const i = (U32)(rng % MaxLive);
+			if (ptrs[i]) {
+				for (U64 j = 0; j < sizes[i]; j++) {
+					ok &= ptrs[i][j] == (U8)i;
+				}
+				Heap::Free(heap, ptrs[i]);
+				ptrs[i] = 0;
+			} else {
+				sizes[i] = (rng >> 20) % ((rng & 0x100) ? 64 * KB : 512) + 1;
+				ptrs[i] = (U8*)Heap::Alloc(heap, sizes[i]);
+				memset(ptrs[i], (int)i, sizes[i]);
+			}
+		}
+		Unit_Check(ok);
+		for (U32 i = 0; i < MaxLive; i++) {
+			Heap::Free(heap, ptrs[i]);
+		}
+		Unit_CheckEq(Heap::UsedBytes(heap), (U64)0);
+	}
+
+	Unit_SubTest("Mem") {
+		Mem const mem = Mem::CreateHeap(1 * GB);
+		Defer { Mem::Destroy(mem); };
+		DynamicArray<U64> arr(mem, 0);
+		for (U64 i = 0; i < 100000; i++) {
+			arr.Add(i);
+		}
+		Unit_CheckEq(arr[99999], (U64)99999);
+		arr.Shutdown();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "JC/Common.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Two-level segregated fit (TLSF) heap over a single virtual reservation.
+// O(1) alloc/free with bounded fragmentation, for memory with independent lifetimes.
+// Like Mem, a Heap has a single owner and is not thread-safe.
+// Most code should use Mem::CreateHeap() rather than calling this directly.
+struct Heap {
+	U64 handle = 0;
+	operator bool() const { return handle != 0; }
+
+	static constexpr U64 Align = 16;
+
+	static Heap  Create(U64 reserveSize);
+	static void  Destroy(Heap heap);
+	static void* Alloc(Heap heap, U64 size);
+	static void* AllocAligned(Heap heap, U64 size, U64 align);
+	static void* Realloc(Heap heap, void* p, U64 newSize);	// result is only Align aligned
+	static void  Free(Heap heap, void* p);
+	static U64   Size(void* p);	// usable size of an allocation, >= the requested size
+	static U64   UsedBytes(Heap heap);
+	static U64   CommitBytes(Heap heap);
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "JC/Job.h"
+
+#include "JC/Bench.h"
+#include "JC/Queue.h"
+#include "JC/Sys.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC::Job {
+
+//--------------------------------------------------------------------------------------------------
+
+static constexpr U32 MaxThreads = 64;
+static constexpr U64 DequeLen   = 4096;	// a full deque runs new jobs inline instead of pushing them
+static constexpr U64 DequeMask  = DequeLen - 1;
+static constexpr U32 NoThread   = U32Max;
+static constexpr U32 SpinsBeforeSleep = 64;
+
+struct JobObj {
+	Fn*      fn;
+	void*    userData;
+	Counter* counter;
+};
+
+// top and bottom only ever grow: their difference is the length, and slots are [idx & DequeMask].
+// The owner pushes and pops at bottom, thieves CAS top forward.
+struct Deque {
+	alignas(CacheLineSize) U64    top;
+	alignas(CacheLineSize) U64    bottom;
+	alignas(CacheLineSize) JobObj jobs[DequeLen];
+};
+
+static bool              init;
+static U32               threadsLen;	// workers + the Init() thread, which is thread 0
+static Deque*            deques;	// [threadsLen]
+static Sys::Thread       workers[MaxThreads];
+static U32               exiting;
+static U32               sleepers;
+static Sys::Sem          wakeSem;
+static Mem               mem;
+static MpmcQueue<JobObj> sharedJobs;	// Run() from threads that aren't ours
+static thread_local U32  threadIdx = NoThread;
+static thread_local U64  stealRng;
+
+//--------------------------------------------------------------------------------------------------
+
+static bool Push(Deque* d, JobObj job) {
+	U64 const b = d->bottom;	// only we write bottom
+	U64 const t = Atomic::Load(&d->top);
+	if (b - t >= DequeLen) {
+		return false;
+	}
+	d->jobs[b & DequeMask] = job;
+	Atomic::Store(&d->bottom, b + 1);
+	return true;
+}
+
+// The Exchange is the full barrier between claiming the bottom slot and reading top: without it a
+// thief and the owner can both take the last job
+static bool Pop(Deque* d, JobObj* jobOut) {
+	U64 const b = d->bottom - 1;
+	Atomic::Exchange(&d->bottom, b);
+	U64 const t = Atomic::Load(&d->top);
+	if ((I64)(b - t) < 0) {
+		Atomic::Store(&d->bottom, t);
+		return false;
+	}
+	*jobOut = d->jobs[b & DequeMask];
+	if (b != t) {
+		return true;
+	}
+	bool const won = Atomic::CompareExchange(&d->top, t, t + 1);	// last one: race the thieves for it
+	Atomic::Store(&d->bottom, t + 1);
+	return won;
+}
+
+// The job is copied before the CAS: once top moves past it the owner may overwrite the slot
+static bool Steal(Deque* d, JobObj* jobOut) {
+	U64 const t = Atomic::Load(&d->top);
+	Atomic::Fence();
+	U64 const b = Atomic::Load(&d->bottom);
+	if ((I64)(b - t) <= 0) {
+		return false;
+	}
+	*jobOut = d->jobs[t & DequeMask];
+	return Atomic::CompareExchange(&d->top, t, t + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void RunJob(JobObj job) {
+	job.fn(job.userData);
+	if (job.counter) {
+		Atomic::FetchAdd(&job.counter->val, U32Max);	// -1
+	}
+}
+
+// Own deque first, then the shared queue, then steal starting from a random victim
+static bool RunOne() {
+	JobObj job;
+	if (threadIdx != NoThread && Pop(&deques[threadIdx], &job)) {
+		RunJob(job);
+		return true;
+	}
+	if (sharedJobs.Pop(&job)) {
+		RunJob(job);
+		return true;
+	}
+	stealRng ^= stealRng << 13; stealRng ^= stealRng >> 7; stealRng ^= stealRng << 17;
+	U32 const start = (U32)(stealRng % threadsLen);
+	for (U32 i = 0; i < threadsLen; i++) {
+		U32 const victim = (start + i) % threadsLen;
+		if (victim != threadIdx && Steal(&deques[victim], &job)) {
+			RunJob(job);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool AnyJobs() {
+	if (!sharedJobs.IsEmpty()) {
+		return true;
+	}
+	for (U32 i = 0; i < threadsLen; i++) {
+		if ((I64)(Atomic::Load(&deques[i].bottom) - Atomic::Load(&deques[i].top)) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Spin a little, then sleep. A sleeper counts itself before its last look for work and a pusher
+// publishes before it looks for sleepers, so one of the two always sees the other.
+static void WorkerFn(void* userData) {
+	threadIdx = (U32)(U64)userData;
+	stealRng  = 0x9e3779b97f4a7c15 * (threadIdx + 1);
+	U32 spins = 0;
+	while (!Atomic::Load(&exiting)) {
+		if (RunOne()) {
+			spins = 0;
+			continue;
+		}
+		if (++spins < SpinsBeforeSleep) {
+			Atomic::Pause();
+			continue;
+		}
+		Atomic::FetchAdd(&sleepers, 1);
+		if (!AnyJobs() && !Atomic::Load(&exiting)) {
+			Sys::WaitSem(&wakeSem);
+		}
+		Atomic::FetchAdd(&sleepers, U32Max);
+		spins = 0;
+	}
+	Mem::ShutdownScratch();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Init(U32 workersIn) {
+	Assert(!init);
+	U32 workersLen = workersIn;
+	if (workersLen == U32Max) {
+		U32 const cpus = Sys::CpuCount();
+		workersLen = cpus > 1 ? cpus - 1 : 0;
+	}
+	if (workersLen > MaxThreads - 1) {
+		workersLen = MaxThreads - 1;
+	}
+	threadsLen = workersLen + 1;
+	mem        = Mem::Create(Bit::AlignPow2(MaxThreads * sizeof(Deque) + 1 * MB));
+	deques     = Mem::AllocT<Deque>(mem, threadsLen);
+	sharedJobs.Init(mem, DequeLen);
+	exiting    = 0;
+	sleepers   = 0;
+	Sys::InitSem(&wakeSem, 0);
+	threadIdx = 0;
+	stealRng  = 0x9e3779b97f4a7c15;
+	init      = true;
+	for (U32 i = 1; i < threadsLen; i++) {
+		workers[i] = Sys::StartThread(WorkerFn, (void*)(U64)i);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Anything still queued is dropped: callers Wait() on what they Run()
+void Shutdown() {
+	if (!init) {
+		return;
+	}
+	Atomic::Store(&exiting, 1);
+	Sys::PostSem(&wakeSem, threadsLen);
+	for (U32 i = 1; i < threadsLen; i++) {
+		Sys::JoinThread(workers[i]);
+	}
+	Sys::ShutdownSem(&wakeSem);
+	Mem::Destroy(mem);
+	deques     = 0;
+	threadsLen = 0;
+	threadIdx  = NoThread;
+	init       = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+U32 ThreadCount() {
+	return init ? threadsLen : 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Run(Fn* fn, void* userData, Counter* counter) {
+	JobObj const job = { .fn = fn, .userData = userData, .counter = counter };
+	if (!init) {
+		fn(userData);
+		return;
+	}
+	if (counter) {
+		Atomic::FetchAdd(&counter->val, 1);
+	}
+	bool const pushed = threadIdx != NoThread ? Push(&deques[threadIdx], job) : sharedJobs.Push(job);
+	if (!pushed) {
+		RunJob(job);	// full: running it here is the back-pressure
+		return;
+	}
+	Atomic::Fence();
+	if (Atomic::Load(&sleepers)) {
+		Sys::PostSem(&wakeSem);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Wait(Counter* counter) {
+	if (threadIdx == NoThread && !stealRng) {
+		stealRng = (U64)&counter | 1;	// any nonzero seed will do for a thread we didn't start
+	}
+	while (Atomic::Load(&counter->val)) {
+		if (!RunOne()) {
+			Atomic::Pause();
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void AddOne(void* userData) {
+	Atomic::FetchAdd((U64*)userData, 1);
+}
+
+struct TreeData {
+	U32  depth;
+	U64* leaves;
+};
+
+// Each node runs its children as jobs and waits on them from inside a job
+static void Tree(void* userData) {
+	TreeData const* const data = (TreeData const*)userData;
+	if (data->depth == 0) {
+		Atomic::FetchAdd(data->leaves, 1);
+		return;
+	}
+	TreeData children[4];
+	Counter counter;
+	for (U32 i = 0; i < 4; i++) {
+		children[i] = { .depth = data->depth - 1, .leaves = data->leaves };
+		Run(Tree, &children[i], &counter);
+	}
+	Wait(&counter);
+}
+
+struct OutsideData {
+	U64 sum;
+};
+
+static void OutsideThreadFn(void* userData) {
+	OutsideData* const data = (OutsideData*)userData;
+	Counter counter;
+	for (U32 i = 0; i < 1000; i++) {
+		Run(AddOne, &data->sum, &counter);
+	}
+	Wait(&counter);
+}
+
+Unit_Test("Job") {
+	Init(3);
+	Defer { Shutdown(); };
+	Unit_CheckEq(ThreadCount(), 4u);
+
+	Unit_SubTest("Run/Wait") {
+		U64 sum = 0;
+		Counter counter;
+		for (U32 i = 0; i < 10000; i++) {	// more than a deque holds: the overflow runs inline
+			Run(AddOne, &sum, &counter);
+		}
+		Wait(&counter);
+		Unit_CheckEq(Atomic::Load(&sum), (U64)10000);
+		Unit_CheckEq(counter.val, 0u);
+	}
+
+	Unit_SubTest("Nested") {
+		U64 leaves = 0;
+		TreeData root = { .depth = 5, .leaves = &leaves };
+		Counter counter;
+		Run(Tree, &root, &counter);
+		Wait(&counter);
+		Unit_CheckEq(Atomic::Load(&leaves), (U64)(4 * 4 * 4 * 4 * 4));
+	}
+
+	Unit_SubTest("Outside thread") {
+		OutsideData data = {};
+		Sys::Thread const thread = Sys::StartThread(OutsideThreadFn, &data);
+		Sys::JoinThread(thread);
+		Unit_CheckEq(Atomic::Load(&data.sum), (U64)1000);
+	}
+
+	Unit_SubTest("ParallelFor") {
+		constexpr U32 N = 100000;
+		U32* const vals = Mem::AllocT<U32>(testMem, N);
+		for (U32 i = 0; i < N; i++) {
+			vals[i] = i;
+		}
+		ParallelFor(Span<U32>(vals, N), 1000, [](U32& v) { v = v * 2 + 1; });
+		U32 errors = 0;
+		for (U32 i = 0; i < N; i++) {
+			errors += vals[i] != i * 2 + 1;
+		}
+		Unit_CheckEq(errors, 0u);
+
+		ParallelFor(Span<U32>(vals, 0), 16, [&](U32&) { errors++; });
+		Unit_CheckEq(errors, 0u);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// A particle-update-sized loop body over 4M floats, from one thread up to every core
+Bench_Def("Job: ParallelFor scaling") {
+	constexpr U64 N     = 4 * 1024 * 1024;
+	constexpr U64 Grain = 16 * 1024;
+	constexpr U32 Iters = 10;
+
+	F32* const vals = Mem::AllocT<F32>(benchMem, N);
+	U32 const cpus = Sys::CpuCount();
+	for (U32 threads = 1; threads <= cpus; threads *= 2) {
+		Init(threads - 1);
+		U64 const start = Time::Now();
+		for (U32 iter = 0; iter < Iters; iter++) {
+			ParallelFor(Span<F32>(vals, N), Grain, [](F32& v) { v = v * 0.99f + 1.f; });
+		}
+		U64 const ticks = Time::Now() - start;
+		Shutdown();
+		Bench::Report(SPrintf(benchMem, "%u threads", threads), ticks, N * Iters);
+	}
+	Bench::Consume((U64)vals[N / 2]);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Job
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Atomic.h"
+
+namespace JC::Job {
+
+//--------------------------------------------------------------------------------------------------
+
+// Work-stealing job system: one worker thread per core besides the thread that calls Init(), each
+// with a Chase-Lev deque. A thread pushes and pops its own deque at the bottom, LIFO, so a job's
+// children run hot in cache; idle threads steal from the top of everyone else's.
+// There are no fibers: a thread blocked in Wait() runs other jobs until its counter drains, so
+// nested Run()/Wait() from inside a job is fine.
+// Threads that aren't workers may Run() and Wait() too: their jobs go on a shared MpmcQueue.
+// Before Init(), Run() just calls the job, so code written against Job works unthreaded.
+
+struct Counter {
+	U32 val = 0;	// jobs started and not yet finished
+};
+
+using Fn = void (void* userData);
+
+void Init(U32 workers = U32Max);	// U32Max: Sys::CpuCount() - 1
+void Shutdown();
+U32  ThreadCount();	// workers + the Init() thread, so always >= 1
+void Run(Fn* fn, void* userData, Counter* counter);	// counter may be null
+void Wait(Counter* counter);
+
+//--------------------------------------------------------------------------------------------------
+
+// Calls fn(T&) for every element of span, handing out grainSize elements at a time to as many
+// threads as there are chunks. The caller works too and returns once every element is done.
+template <class T, class F> void ParallelFor(Span<T> span, U64 grainSize, F&& fn) {
+	struct Ctx {
+		T*  data;
+		U64 len;
+		U64 grainSize;
+		U64 next;
+		F*  fn;
+	};
+	auto const Work = [](void* userData) {
+		Ctx* const ctx = (Ctx*)userData;
+		for (;;) {
+			U64 const begin = Atomic::FetchAdd(&ctx->next, ctx->grainSize);
+			if (begin >= ctx->len) {
+				return;
+			}
+			U64 const end = begin + ctx->grainSize < ctx->len ? begin + ctx->grainSize : ctx->len;
+			for (U64 i = begin; i < end; i++) {
+				(*ctx->fn)(ctx->data[i]);
+			}
+		}
+	};
+
+	Assert(grainSize > 0);
+	Ctx ctx = { .data = span.data, .len = span.len, .grainSize = grainSize, .next = 0, .fn = &fn };
+	U64 const chunks = (span.len + grainSize - 1) / grainSize;
+	U64 const jobs   = chunks < ThreadCount() ? chunks : ThreadCount();
+	Counter counter;
+	for (U64 i = 1; i < jobs; i++) {
+		Run(Work, &ctx, &counter);
+	}
+	Work(&ctx);
+	Wait(&counter);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Job
\ No newline at end of file
@@ -3,10 +3,10 @@
 
 #include "JC/Json.h"
 
-#include "JC/Array.h"
 #include "JC/File.h"
 #include "JC/StrDb.h"
 #include "JC/UnitTest.h"
+#include "JC/VArray.h"
 #include <math.h>	// TODO: add Pow() to math.h so we can remove this (only thing we use)
 
 namespace JC::Json {
@@ -81,6 +81,17 @@ static constexpr bool IsDigit(char c) {
 }
 //--------------------------------------------------------------------------------------------------
 
+// Every byte is at most one element, except a quote which can be three ("" is quote, empty, quote).
+// A parse whose worst case fits reuses its thread's reservation, and the pages an earlier parse
+// committed: every .def we load fits. A bigger one reserves for its own worst case and releases it
+// at the end. Either way growth never copies, and a thread holds at most ReuseMaxElems' worth:
+// 16MB of address space, committed only as far as its biggest reusing parse went.
+static constexpr U64 ReuseMaxElems = 1024 * 1024;	// a ~700KB input
+
+static constexpr U64 MaxElems(U64 jsonLen) { return jsonLen * 3 / 2 + 1; }
+
+static thread_local VArray<Str> reuseElems;
+
 struct Ctx {
 	Mem         mem;
 	char const* data;
@@ -91,7 +102,7 @@ struct Ctx {
 
 //--------------------------------------------------------------------------------------------------
 
-static Res<Ctx> CreateCtx(Mem mem, Str json) {
+static Res<Ctx> CreateCtx(Mem mem, Str json, VArray<Str>* elems) {
 	Ctx ctx = {
 		.mem      = mem,
 		.data     = json.data,
@@ -100,8 +111,6 @@ static Res<Ctx> CreateCtx(Mem mem, Str json) {
 		.elemEnd  = nullptr,
 	};
 
-	DArray<Str> elems(mem, 256);
-
 	// TODO: Replace with SIMD scanning
 	// Use vpshufb-based vectorized classification
 	// Can classify 32 bytes per instruction into: structural, whitespace, quote, backslash, other
@@ -134,20 +143,20 @@ static Res<Ctx> CreateCtx(Mem mem, Str json) {
 				break;
 
 			case CharType::Operator:
-				elems.Add(Str(iter, 1));
+				elems->Add(Str(iter, 1));
 				iter++;
 				break;
 
 			case CharType::Quote: {
-				elems.Add(Str(iter, 1));
+				elems->Add(Str(iter, 1));
 				iter++;
 				char const* begin = iter;
 				for (;;) {
 					if (iter >= ctx.end) { return Err_MissingClosingQuote("pos", iter - ctx.data); }
 					char const c = *iter;
 					if (c == '"') {
-						elems.Add(Str(begin, (U32)(iter - begin)));
-						elems.Add(Str(iter, 1));
+						elems->Add(Str(begin, (U32)(iter - begin)));
+						elems->Add(Str(iter, 1));
 						iter++;
 						break;
 					}
@@ -168,14 +177,14 @@ static Res<Ctx> CreateCtx(Mem mem, Str json) {
 				do {
 					iter++;
 				} while (iter < ctx.end && !IsStructural(*iter));
-				elems.Add(Str(begin, (U32)(iter - begin)));
+				elems->Add(Str(begin, (U32)(iter - begin)));
 				break;
 			}
 		}
 	}
 
-	ctx.elemIter = elems.data;
-	ctx.elemEnd  = elems.data + elems.len;
+	ctx.elemIter = elems->data;
+	ctx.elemEnd  = elems->data + elems->len;
 
 	return ctx;
 }
@@ -313,11 +322,11 @@ static Res<F32> ParseF32(Ctx* ctx) { F64 val; TryTo(ParseF64(ctx), val); return
 
 //--------------------------------------------------------------------------------------------------
 
-static Res<Str> UnescapeAndIntern(Ctx* ctx, Str str) {
-	if (str.len == 0) { return Str(); }
+static Res<Sym> UnescapeAndIntern(Ctx* ctx, Str str) {
+	if (str.len == 0) { return Sym(); }
 
 	MemScope(ctx->mem);
-	char*       unescaped     = Mem::AllocT<char>(ctx->mem, str.len);
+	char*       unescaped     = Mem::AllocUninitT<char>(ctx->mem, str.len);
 	char*       unescapedIter = unescaped;
 	char const* iter          = str.data;
 	char const* end           = str.data + str.len;
@@ -340,17 +349,24 @@ static Res<Str> UnescapeAndIntern(Ctx* ctx, Str str) {
 		}
 		iter++;
 	}
-	return StrDb::Intern(Str(unescaped, (U32)(unescapedIter - unescaped)));
+	return StrDb::InternSym(Str(unescaped, (U32)(unescapedIter - unescaped)));
 }
 
 //--------------------------------------------------------------------------------------------------
 
-static Res<Str> ParseStr(Ctx* ctx) {
+static Res<Sym> ParseSym(Ctx* ctx) {
 	Try(Expect(ctx, '"'));
 	Str str; TryTo(Read(ctx), str);
-	TryTo(UnescapeAndIntern(ctx, str), str);
+	Sym sym; TryTo(UnescapeAndIntern(ctx, str), sym);
 	Try(Expect(ctx, '"'));
-	return str;
+	return sym;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static Res<Str> ParseStr(Ctx* ctx) {
+	Sym sym; TryTo(ParseSym(ctx), sym);
+	return StrDb::GetStr(sym);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -359,9 +375,9 @@ static Res<Str> ParseName(Ctx* ctx) {
 	Str str; TryTo(Read(ctx), str);
 	if (str[0] == '"') {
 		TryTo(Read(ctx), str);
-		TryTo(UnescapeAndIntern(ctx, str), str);
+		Sym sym; TryTo(UnescapeAndIntern(ctx, str), sym);
 		Try(Expect(ctx, '"'));
-		return str;
+		return StrDb::GetStr(sym);
 
 	} else {
 		char const* iter = str.data;
@@ -452,6 +468,7 @@ static Res<> ParseVal(Ctx* ctx, Traits const* traits, U8* out) {
 		case Type::F32:  return ParseF32 (ctx).To(*(F32 *)out);
 		case Type::F64:  return ParseF64 (ctx).To(*(F64 *)out);
 		case Type::Str:  return ParseStr (ctx).To(*(Str *)out);
+		case Type::Sym:  return ParseSym (ctx).To(*(Sym *)out);
 		case Type::Obj:  return ParseObject(ctx, traits, out);
 		default: Panic("Unhandled Json::Type: %u", (U32)traits->type);
 	}
@@ -497,7 +514,19 @@ static Res<> ParseObject(Ctx* ctx, Traits const* traits, U8* out) {
 //--------------------------------------------------------------------------------------------------
 
 Res<> JsonToObjectImpl(Mem mem, Str json, Traits const* traits, U8* out) {
-	Ctx ctx; TryTo(CreateCtx(mem, json), ctx);
+	U64 const maxElems = MaxElems(json.len);
+	if (maxElems <= ReuseMaxElems) {
+		if (!reuseElems.data) {
+			reuseElems.Init(ReuseMaxElems);
+		}
+		reuseElems.Clear();
+		Ctx ctx; TryTo(CreateCtx(mem, json, &reuseElems), ctx);
+		return ParseObject(&ctx, traits, out);
+	}
+
+	VArray<Str> elems(maxElems);
+	Defer { elems.Shutdown(); };
+	Ctx ctx; TryTo(CreateCtx(mem, json, &elems), ctx);
 	return ParseObject(&ctx, traits, out);
 }
 
@@ -505,8 +534,9 @@ Res<> JsonToObjectImpl(Mem mem, Str json, Traits const* traits, U8* out) {
 
 Res<> LoadImpl(Mem mem, Str path, Traits const* traits, U8* out) {
 	ErrScope("path", path);
-	Str json; TryTo(File::ReadAllStr(mem, path), json);
-	return JsonToObjectImpl(mem, json, traits, out);
+	Span<U8 const> data; TryTo(File::Map(path), data);
+	Defer { File::Unmap(data); };	// every string we hand back is interned, none point into the view
+	return JsonToObjectImpl(mem, Str((char const*)data.data, (U32)data.len), traits, out);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -536,6 +566,9 @@ Json_Begin(JT_F64)   Json_Member("x", x) Json_End(JT_F64)
 struct JT_Str   { Str  x; };
 Json_Begin(JT_Str)   Json_Member("x", x) Json_End(JT_Str)
 
+struct JT_Sym   { Sym  x; };
+Json_Begin(JT_Sym)   Json_Member("x", x) Json_End(JT_Sym)
+
 struct JT_IntArr { Span<I32> items; };
 Json_Begin(JT_IntArr) Json_Member("items", items) Json_End(JT_IntArr)
 
@@ -699,6 +732,15 @@ Unit_Test("Json") {
 		Unit_CheckEq(obj.x.len, (U32)0);
 	}
 
+	Unit_SubTest("Sym") {
+		JT_Sym obj{};
+		Unit_CheckRes(JsonToObject(testMem, Str(R"({ x: "hello" })"), &obj));
+		Unit_Check(obj.x == StrDb::InternSym("hello"));
+		Unit_CheckEq(StrDb::GetStr(obj.x), Str("hello"));
+		Unit_CheckRes(JsonToObject(testMem, Str(R"({ x: "" })"), &obj));
+		Unit_Check(!obj.x);
+	}
+
 	Unit_SubTest("String escape newline") {
 		JT_Str obj{};
 		Unit_CheckRes(JsonToObject(testMem, Str(R"({ x: "a\nb" })"), &obj));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "JC/Common.h"
+#include "JC/StrDb.h"
 
 // Json will automatically intern all strings in the sources file
 namespace JC::Json {
@@ -17,6 +18,7 @@ enum struct Type {
 	F32,
 	F64,
 	Str,
+	Sym,
 	Obj,
 };
 
@@ -44,6 +46,7 @@ constexpr Traits I64Traits  = { .type = Type::I64,  .size = 8,           .arrayD
 constexpr Traits F32Traits  = { .type = Type::F32,  .size = 4,           .arrayDepth = 0, .members = {} };
 constexpr Traits F64Traits  = { .type = Type::F64,  .size = 8,           .arrayDepth = 0, .members = {} };
 constexpr Traits StrTraits  = { .type = Type::Str,  .size = sizeof(Str), .arrayDepth = 0, .members = {} };
+constexpr Traits SymTraits  = { .type = Type::Sym,  .size = sizeof(Sym), .arrayDepth = 0, .members = {} };
 
 constexpr Traits const* GetJsonTraits(bool) { return &BoolTraits; }
 constexpr Traits const* GetJsonTraits(U32)  { return &U32Traits; }
@@ -53,6 +56,7 @@ constexpr Traits const* GetJsonTraits(I64)  { return &I64Traits; }
 constexpr Traits const* GetJsonTraits(F32)  { return &F32Traits; }
 constexpr Traits const* GetJsonTraits(F64)  { return &F64Traits; }
 constexpr Traits const* GetJsonTraits(Str)  { return &StrTraits; }
+constexpr Traits const* GetJsonTraits(Sym)  { return &SymTraits; }
 
 template <class T> constexpr Traits MakeSpanTraits() {
 	constexpr Traits const* elemTraits = GetTraitsHelper<T>();
@@ -1,5 +1,9 @@
 #include "JC/Map.h"
 
+#include "JC/Bench.h"
+#include "JC/Rng.h"
+#include "JC/Sys.h"
+#include "JC/Time.h"
 #include "JC/UnitTest.h"
 
 namespace JC {
@@ -135,4 +139,304 @@ Unit_Test("Map") {
 
 //--------------------------------------------------------------------------------------------------
 
+Unit_Test("Map.Grow") {
+	// Churn against a reference from a tiny table, checking every live key while old buckets and elems are still draining
+	constexpr U64 RefLen = 4096;
+	Mem const heapMem = Mem::CreateHeap(64 * MB);	// as a growing Map should have: the old tables go back
+	Defer { Mem::Destroy(heapMem); };
+	Map<U64, U64> map(heapMem, 4);
+	U64* const live = Mem::AllocT<U64>(testMem, RefLen);	// live[k % RefLen] == k if k is in the map
+	Rng::Gen gen = Rng::MakeGen(0x243f6a8885a308d3);
+	U64 errors = 0;
+	U64 midGrowChecks = 0;
+	for (U64 i = 0; i < 20000; i++) {
+		U64 const rng = Rng::NextU64(&gen);
+		U64 const k = rng | 1;
+		U64* const l = &live[k % RefLen];
+		if (*l && (rng & 0x100)) {
+			map.Remove(*l);
+			*l = 0;
+		} else {
+			map.Put(k, k);
+			if (*l) {
+				map.Remove(*l);
+			}
+			*l = k;
+		}
+		if ((map.oldBuckets || map.oldElems) && midGrowChecks < 64) {
+			midGrowChecks++;
+			for (U64 j = 0; j < RefLen; j++) {
+				if (live[j]) {
+					errors += map.FindOrZero(live[j]) != live[j];
+				}
+			}
+		}
+	}
+	U64 liveLen = 0;
+	for (U64 j = 0; j < RefLen; j++) {
+		if (live[j]) {
+			errors += map.FindOrZero(live[j]) != live[j];
+			liveLen++;
+		}
+	}
+	Unit_CheckEq(errors, (U64)0);
+	Unit_CheckEq(map.elemsLen, liveLen);
+	Unit_Check(midGrowChecks > 0);
+	Unit_Check(map.cap >= 4096);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Map.CacheHash") {
+	// Str keys through growth and swap-removes: both only ever see the cached hashes
+	constexpr U64 KeysLen = 2000;
+	Map<Str, U64, true> map(testMem, 4);
+	Set<Str, true>      set(testMem, 4);
+	Str* const keys = Mem::AllocT<Str>(testMem, KeysLen);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = SPrintf(testMem, "key %u", i);
+		map.Put(keys[i], i + 1);
+		set.Add(keys[i]);
+	}
+	for (U64 i = 0; i < KeysLen; i += 3) {
+		map.Remove(keys[i]);
+		set.Remove(keys[i]);
+	}
+	U64 errors = 0;
+	for (U64 i = 0; i < KeysLen; i++) {
+		bool const live = i % 3 != 0;
+		errors += map.FindOrZero(SPrintf(testMem, "key %u", i)) != (live ? i + 1 : 0);
+		errors += set.Has(SPrintf(testMem, "key %u", i)) != live;
+	}
+	for (U64 i = 0; i < map.elemsLen; i++) {
+		errors += map.elems[i].hash != Hash(map.elems[i].key);
+	}
+	Unit_CheckEq(errors, (U64)0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Set") {
+	Set<U64> set(testMem, 16);
+	Unit_Check(!set.Has(1));
+	for (U64 i = 1; i <= 100; i++) {
+		Unit_Check(set.Add(i * 3));
+	}
+	Unit_Check(!set.Add(3));
+	Unit_CheckEq(set.elemsLen, (U64)100);
+	for (U64 i = 1; i <= 300; i++) {
+		Unit_CheckEq(set.Has(i), i % 3 == 0);
+	}
+	Unit_CheckEq(set.FindOrZero(9), (U64)9);
+	Unit_CheckEq(set.FindOrZero(10), (U64)0);
+	set.Remove(9);
+	Unit_Check(!set.Has(9));
+	Unit_CheckEq(set.elemsLen, (U64)99);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Map.FindMany") {
+	Map<U64, U64> map(testMem, 16);
+	Set<U64>      set(testMem, 16);
+	for (U64 i = 1; i <= 500; i++) {
+		map.Put(i * 2, i);
+		set.Add(i * 2);
+	}
+	constexpr U64 KeysLen = 1000;	// not a multiple of FindBatch: the last pass is partial
+	U64* const keys = Mem::AllocT<U64>(testMem, KeysLen);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = i + 1;
+	}
+	Span<U64>  vals = Mem::AllocSpan<U64>(testMem, KeysLen);
+	Span<bool> has  = Mem::AllocSpan<bool>(testMem, KeysLen);
+	map.FindMany(Span<U64 const>(keys, KeysLen), vals);
+	set.FindMany(Span<U64 const>(keys, KeysLen), has);
+	U64 errors = 0;
+	for (U64 i = 0; i < KeysLen; i++) {
+		errors += vals[i] != map.FindOrZero(keys[i]);
+		errors += has[i] != ((keys[i] & 1) == 0);
+	}
+	Unit_CheckEq(errors, (U64)0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Worst single Put() while growing from 16 buckets to 2M, against a table sized up front and
+// against draining each grow in one go, as a stop-the-world rehash would
+Bench_Def("Map grow: worst Put") {
+	constexpr U64 KeysLen = 1024 * 1024;
+
+	U64* const keys = Mem::AllocUninitT<U64>(benchMem, KeysLen);
+	Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = Rng::NextU64(&gen) | 1;
+	}
+
+	struct Case { Str label; U64 initialCap; bool drain; };
+	Case const cases[] = {
+		{ "presized",        2 * 1024 * 1024, false },
+		{ "incremental",     16,              false },
+		{ "stop-the-world",  16,              true  },
+	};
+	for (U32 c = 0; c < LenOf(cases); c++) {
+		MemMark const mark = Mem::Mark(benchMem);
+		Map<U64, U64> map(benchMem, cases[c].initialCap);
+		U64 worst = 0;
+		U64 const start = Time::Now();
+		for (U64 i = 0; i < KeysLen; i++) {
+			U64 const putStart = Time::Now();
+			map.Put(keys[i], i);
+			if (cases[c].drain) {
+				while (map.oldBuckets || map.oldElems) {
+					map.Migrate();
+				}
+			}
+			U64 const putTicks = Time::Now() - putStart;
+			worst = putTicks > worst ? putTicks : worst;
+		}
+		U64 const total = Time::Now() - start;
+		Bench::Report(SPrintf(benchMem, "%s: all", cases[c].label), total, KeysLen);
+		Bench::Report(SPrintf(benchMem, "%s: worst", cases[c].label), worst, 1);
+		Bench::Consume(map.FindOrZero(keys[KeysLen / 2]));
+		Mem::Reset(benchMem, mark);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Random lookups over a table much larger than the TLB's reach: with 4KB pages nearly every probe
+// misses the TLB, with 2MB pages the page walks mostly hit the paging-structure caches.
+Bench_Def("Map lookup: page sizes") {
+	constexpr U64 Cap     = 8 * 1024 * 1024;
+	constexpr U64 KeysLen = Cap / 2;
+	constexpr U64 Lookups = 8 * 1024 * 1024;
+
+	U64* const keys = Mem::AllocT<U64>(benchMem, KeysLen);
+	Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = Rng::NextU64(&gen) | 1;	// never zero: FindOrZero() can't tell a zero value from a miss
+	}
+
+	struct Case { Str label; PageKind pageKind; };
+	Case const cases[] = {
+		{ "normal pages",     PageKind::Normal },
+		{ "transparent huge", PageKind::Huge },
+		{ "explicit huge",    PageKind::HugeExplicit },
+	};
+	for (U32 c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		U64 const fallbacks = Sys::HugePageFallbacks();
+		Mem const mem = Mem::Create(4 * GB, cases[c].pageKind);
+		Map<U64, U64> map(mem, Cap);
+		for (U64 i = 0; i < KeysLen; i++) {
+			map.Put(keys[i], keys[i]);
+		}
+
+		U64 sum = 0;
+		U64 idx = 0;
+		U64 const start = Time::Now();
+		for (U64 i = 0; i < Lookups; i++) {
+			idx = (idx + 0x9e3779b97f4a7c15) & (KeysLen - 1);	// odd stride visits every key in scrambled order
+			sum += map.FindOrZero(keys[idx]);
+		}
+		U64 const ticks = Time::Now() - start;
+		if (cases[c].pageKind == PageKind::HugeExplicit) {
+			Bench::Report(SPrintf(benchMem, "%s: %u THP fallbacks", cases[c].label, Sys::HugePageFallbacks() - fallbacks), ticks, Lookups);
+		} else {
+			Bench::Report(cases[c].label, ticks, Lookups);
+		}
+		Bench::Consume(sum);
+
+		Mem::Destroy(mem);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Str keys as in sprite or terrain name resolution: each lookup costs a bucket miss, an elems miss and
+// a miss on the key's chars. One at a time those serialize, FindMany() overlaps a batch of them.
+Bench_Def("Map FindMany vs FindOrZero") {
+	constexpr U64 KeysLen = 1024 * 1024;
+	constexpr U64 Lookups = 4 * 1024 * 1024;
+
+	Str* const keys = Mem::AllocT<Str>(benchMem, KeysLen);
+	Map<Str, U64> map(benchMem, 16);
+	Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = SPrintf(benchMem, "sprite_%x", Rng::NextU64(&gen));
+		map.Put(keys[i], i + 1);
+	}
+	Str* const lookupKeys = Mem::AllocT<Str>(benchMem, Lookups);
+	U64 idx = 0;
+	for (U64 i = 0; i < Lookups; i++) {
+		idx = (idx + 0x9e3779b97f4a7c15) & (KeysLen - 1);
+		lookupKeys[i] = keys[idx];
+	}
+
+	U64 sum = 0;
+	U64 start = Time::Now();
+	for (U64 i = 0; i < Lookups; i++) {
+		sum += map.FindOrZero(lookupKeys[i]);
+	}
+	Bench::Report("FindOrZero", Time::Now() - start, Lookups);
+
+	Span<U64> const out = Mem::AllocSpan<U64>(benchMem, Lookups);
+	start = Time::Now();
+	map.FindMany(Span<Str const>(lookupKeys, Lookups), out);
+	Bench::Report("FindMany", Time::Now() - start, Lookups);
+	for (U64 i = 0; i < Lookups; i++) {
+		sum += out[i];
+	}
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Str-keyed churn from a small table: every grow rehashes what it migrates and every Remove() rehashes
+// the element it swaps into the hole. Keys share a long prefix, so a key compare reads most of the string.
+Bench_Def("Map Str churn: CacheHash") {
+	constexpr U64 KeysLen = 256 * 1024;
+	constexpr U64 Rounds  = 4;
+
+	Str* const keys = Mem::AllocT<Str>(benchMem, KeysLen);
+	for (U64 i = 0; i < KeysLen; i++) {
+		keys[i] = SPrintf(benchMem, "Assets/Sprites/Units/Infantry/Spearman/Animations/Walk_%08x", i * 0x9e3779b1);
+	}
+
+	auto Churn = [&](auto* map) {
+		U64 sum = 0;
+		for (U64 round = 0; round < Rounds; round++) {
+			for (U64 i = 0; i < KeysLen; i++) {
+				map->Put(keys[i], i);
+			}
+			for (U64 i = 0; i < KeysLen; i++) {
+				sum += map->FindOrZero(keys[(i * 7) & (KeysLen - 1)]);
+			}
+			for (U64 i = 0; i < KeysLen; i++) {
+				map->Remove(keys[(i * 13) & (KeysLen - 1)]);
+			}
+		}
+		return sum;
+	};
+
+	{
+		MemMark const mark = Mem::Mark(benchMem);
+		Map<Str, U64> map(benchMem, 16);
+		U64 const start = Time::Now();
+		Bench::Consume(Churn(&map));
+		Bench::Report("Map<Str, U64>", Time::Now() - start, Rounds * KeysLen * 3);
+		Mem::Reset(benchMem, mark);
+	}
+	{
+		MemMark const mark = Mem::Mark(benchMem);
+		Map<Str, U64, true> map(benchMem, 16);
+		U64 const start = Time::Now();
+		Bench::Consume(Churn(&map));
+		Bench::Report("Map<Str, U64, CacheHash>", Time::Now() - start, Rounds * KeysLen * 3);
+		Mem::Reset(benchMem, mark);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
 }	// namespace JC
\ No newline at end of file
@@ -1,139 +1,368 @@
 #pragma once
 
 #include "JC/Common.h"
+#include "JC/Hash.h"
+
+#include <xmmintrin.h>
 
 namespace JC {
 
 //-------------------------------------------------------------------------------------------------
 
-template <class K, class V> struct Map {
+// Robin Hood table over a dense elems array, shared by Map and Set. E is the element type and
+// must have a K key member.
+// CacheHash stores each key's full 64-bit hash in its element (E then needs a U64 hash member):
+// growth and Remove() stop rehashing keys, and a full hash compare screens out nearly every
+// mismatched key before the key compare. Worth it for keys that are slow to hash or compare, like Str.
+// Grows by doubling once 3/4 full, so Init(cap) holds cap * 3/4 elems before it grows: size a Map
+// for an exact count with MapCapFor(). Growing is spread across the following Put()/Remove()
+// calls: the old buckets and old elems stay live and are drained MigrateSteps at a time each, so
+// no single call pays for copying the whole table. Elems move, so pointers into them last until
+// the next Put().
+// The old elems and buckets go back through Mem::Free(), which only reclaims memory in a heap
+// arena (Mem::CreateHeap()). In a bump arena they stay until the arena resets, which for a Map
+// that only grows is as much again as its final table: give a long-lived growing Map a heap.
+// The smallest cap for which Init(cap) holds len elems without growing
+constexpr U64 MapCapFor(U64 len) {
+	U64 cap = 1;
+	while (cap - cap / 4 < len) {
+		cap *= 2;
+	}
+	return cap;
+}
+
+template <class K, class E, bool CacheHash> struct MapCore {
+	static constexpr U64 MigrateSteps = 8;	// old buckets and old elems moved per Put()/Remove() while growing
+	static constexpr U64 FindBatch    = 16;	// keys in flight per FindMany() pass
+
 	struct Bucket {
 		U32 df;	// top 3 bytes are distance, bottom byte is fingerprint
 		U64 idx;
 	};
 
-	struct Elem {
-		K key;
-		V val;
-	};
-
+	Mem      mem;
 	Bucket*  buckets;
-	Elem*    elems;
+	E*       elems;
 	U64      elemsLen;
+	U64      elemsCap;
 	U64      cap;
+	Bucket*  oldBuckets;	// non-null while growing
+	U64      oldCap;
+	U64      migrateIdx;	// oldBuckets below this are empty: everything homed there has moved
+	E*       oldElems;	// non-null while growing: elems [elemsMoved, oldElemsLen) still live here
+	U64      oldElemsLen;
+	U64      elemsMoved;
 
-	Map() = default;
-
-	Map(Mem mem, U64 capIn) { Init(mem, capIn); }
-
-	void Init(Mem mem, U64 capIn) {
-		Assert((capIn & (capIn - 1)) == 0);
+	void Init(Mem memIn, U64 capIn) {
+		Assert(capIn > 0 && (capIn & (capIn - 1)) == 0);
+		mem        = memIn;
 		buckets    = Mem::AllocT<Bucket>(mem, capIn);
-		elems      = Mem::AllocT<Elem>(mem, capIn);
+		elemsCap   = capIn - capIn / 4;
+		elems      = Mem::AllocT<E>(mem, elemsCap);
 		elemsLen   = 0;
 		cap        = capIn;
+		oldBuckets  = 0;
+		oldCap      = 0;
+		migrateIdx  = 0;
+		oldElems    = 0;
+		oldElemsLen = 0;
+		elemsMoved  = 0;
 	}
 
-	V FindOrZero(K k) const {
-		U64 h = Hash(k);
-		U32 df = 0x100 | (h & 0xff);
-		U64 i = h & (cap - 1);
-		Bucket* bucket = &buckets[i];
-		if (df == bucket->df && elems[bucket->idx].key == k) {
-			return elems[bucket->idx].val;
-		}
-
-		df += 0x100;
-		i = (i + 1 == cap) ? 0 : i + 1;
-		bucket = &buckets[i];
-		if (df == bucket->df && elems[bucket->idx].key == k) {
-			return elems[bucket->idx].val;
-		}
+	E* ElemAt(U64 idx) const {
+		return (oldElems && idx >= elemsMoved && idx < oldElemsLen) ? &oldElems[idx] : &elems[idx];
+	}
 
-		df += 0x100;
-		i = (i + 1 == cap) ? 0 : i + 1;
-		bucket = &buckets[i];
+	Bucket* FindIn(Bucket* bs, U64 c, K k, U64 h) const {
+		U32 df = 0x100 | (h & 0xff);
+		U64 i = h & (c - 1);
 		while (true) {
+			Bucket* const bucket = &bs[i];
 			if (df == bucket->df) {
-				if (elems[bucket->idx].key == k) {
-					return elems[bucket->idx].val;
+				if (Match(*ElemAt(bucket->idx), k, h)) {
+					return bucket;
 				}
 			} else if (df > bucket->df) {
-				return (V)0;
+				return nullptr;
 			}
 			df += 0x100;
-			i = (i + 1 == cap) ? 0 : i + 1;
-			bucket = &buckets[i];
+			i = (i + 1 == c) ? 0 : i + 1;
 		}
 	}
 
-	V* Put(K k, V v) {
-		U64 h = Hash(k);
-		U32 df = 0x100 | (h & 0xff);
-		U64 i = h & (cap - 1);
-		while (true) {
-			Bucket* bucket = &buckets[i];
-			if (df == bucket->df) {
-				if (k == elems[bucket->idx].key) {
-					elems[bucket->idx].val = (V)v;
-					return &elems[bucket->idx].val;
+	// Keys homed below migrateIdx have moved, and FindIn() stops at their (empty) home bucket
+	Bucket* Find(K k, U64 h) const {
+		if (Bucket* const bucket = FindIn(buckets, cap, k, h); bucket) {
+			return bucket;
+		}
+		return oldBuckets ? FindIn(oldBuckets, oldCap, k, h) : nullptr;
+	}
+
+	E* FindElem(K k) const {
+		Bucket const* const bucket = Find(k, Hash(k));
+		return bucket ? ElemAt(bucket->idx) : nullptr;
+	}
+
+	// Calls fn(i, E* or nullptr) for each key. Each pass hashes a batch and prefetches the home
+	// buckets, then prefetches the elems those buckets point at, then resolves: the cache misses
+	// of a whole batch overlap instead of each lookup waiting on its own.
+	template <class F> void FindManyImpl(Span<K const> keys, F&& fn) const {
+		U64 hashes[FindBatch];
+		for (U64 base = 0; base < keys.len; base += FindBatch) {
+			U64 const n = keys.len - base < FindBatch ? keys.len - base : FindBatch;
+			for (U64 i = 0; i < n; i++) {
+				hashes[i] = Hash(keys[base + i]);
+				Prefetch(&buckets[hashes[i] & (cap - 1)]);
+			}
+			for (U64 i = 0; i < n; i++) {
+				Bucket const* const bucket = &buckets[hashes[i] & (cap - 1)];
+				if (bucket->df) {
+					Prefetch(ElemAt(bucket->idx));
 				}
-			} else if (df > bucket->df) {
-				Assert(elemsLen < cap);
-				elems[elemsLen++] = Elem { .key = k, .val = v };
-				Bucket b = { .df = df, .idx = elemsLen - 1 };
-				while (buckets[i].df != 0) {
-					Bucket t = buckets[i];
-					buckets[i] = b;
-					b = t;
-					b.df += 0x100;
-					i = (i + 1 == cap) ? 0 : i + 1;
-				};
-				buckets[i] = b;
-				return &elems[elemsLen - 1].val;
 			}
-			df += 0x100;
-			i = (i + 1 == cap) ? 0 : i + 1;
+			for (U64 i = 0; i < n; i++) {
+				Bucket const* const bucket = Find(keys[base + i], hashes[i]);
+				fn(base + i, bucket ? ElemAt(bucket->idx) : nullptr);
+			}
 		}
 	}
 
-	void Remove(K k) {
-		U64 h = Hash(k);
+	static void InsertIn(Bucket* bs, U64 c, U64 h, U64 idx) {
 		U32 df = 0x100 | (h & 0xff);
-		U64 i = h & (cap - 1);
-		while (df < buckets[i].df) {
+		U64 i = h & (c - 1);
+		while (df <= bs[i].df) {
 			df += 0x100;
-			i = (i + 1 == cap) ? 0 : i + 1;
+			i = (i + 1 == c) ? 0 : i + 1;
 		}
-		while (df == buckets[i].df && k != elems[buckets[i].idx].key) {
-			df += 0x100;
-			i = (i + 1 == cap) ? 0 : i + 1;
+		Bucket b = { .df = df, .idx = idx };
+		while (bs[i].df != 0) {
+			Bucket t = bs[i];
+			bs[i] = b;
+			b = t;
+			b.df += 0x100;
+			i = (i + 1 == c) ? 0 : i + 1;
+		};
+		bs[i] = b;
+	}
+
+	static void RemoveAt(Bucket* bs, U64 c, U64 i) {
+		U64 next = (i + 1 == c) ? 0 : i + 1;
+		while (bs[next].df >= 0x200) {
+			bs[i].df = bs[next].df - 0x100;
+			bs[i].idx = bs[next].idx;
+			i = next;
+			next = (next + 1 == c) ? 0 : next + 1;
 		}
-		if (df != buckets[i].df) {
-			return;
+		bs[i] = {};
+	}
+
+	static U64 ElemHash(E const* e) {
+		if constexpr (CacheHash) {
+			return e->hash;
+		} else {
+			return Hash(e->key);
 		}
+	}
 
-		U64 ei = buckets[i].idx;
-		U64 next = (i + 1 == cap) ? 0 : i + 1;
-		while (buckets[next].df >= 0x200) {
-			buckets[i].df = buckets[next].df - 0x100;
-			buckets[i].idx = buckets[next].idx;
-			i = next;
-			next = (next + 1 == cap) ? 0 : next + 1;
+	static bool Match(E const& e, K k, U64 h) {
+		if constexpr (CacheHash) {
+			if (e.hash != h) {
+				return false;
+			}
 		}
-		buckets[i] = {};
+		return e.key == k;
+	}
+
+	// k must not be present
+	E* Insert(U64 h, E e) {
+		if (elemsLen == elemsCap) {
+			Grow();
+		}
+		if constexpr (CacheHash) {
+			e.hash = h;
+		}
+		elems[elemsLen++] = e;	// past oldElemsLen: always in the new elems
+		InsertIn(buckets, cap, h, elemsLen - 1);
+		Migrate();
+		return &elems[elemsLen - 1];
+	}
+
+	void Remove(K k) {
+		Migrate();
+
+		U64 const h = Hash(k);
+		Bucket* bs = buckets;
+		U64 c = cap;
+		Bucket* bucket = FindIn(buckets, cap, k, h);
+		if (!bucket && oldBuckets) {
+			bs = oldBuckets;
+			c = oldCap;
+			bucket = FindIn(oldBuckets, oldCap, k, h);
+		}
+		if (!bucket) {
+			return;
+		}
+
+		U64 const ei = bucket->idx;
+		RemoveAt(bs, c, (U64)(bucket - bs));	// only ever shifts buckets at or above migrateIdx: everything below is empty
 
 		if (ei != elemsLen - 1) {
-			elems[ei] = elems[elemsLen - 1];
-			i = Hash(elems[ei].key) & (cap - 1);
-			while (buckets[i].idx != elemsLen - 1) {
-				i = (i + 1 == cap) ? 0 : i + 1;
-			}
-			buckets[i].idx = ei;
+			E* const e = ElemAt(ei);
+			*e = *ElemAt(elemsLen - 1);
+			Find(e->key, ElemHash(e))->idx = ei;	// still resolves: elem elemsLen - 1 holds the same key
 		}
 		--elemsLen;
+		if (oldElemsLen > elemsLen) {
+			oldElemsLen = elemsLen;	// the next Insert() goes to the new elems
+		}
+	}
+
+	void Grow() {
+		while (oldBuckets || oldElems) {	// outgrew the last migration before it finished
+			Migrate();
+		}
+		U64 const newCap = cap * 2;
+		U64 const newElemsCap = newCap - newCap / 4;
+		oldElems    = elems;
+		oldElemsLen = elemsLen;
+		elemsMoved  = 0;
+		elems       = Mem::AllocUninitT<E>(mem, newElemsCap);	// filled by Migrate() and Insert()
+		elemsCap    = newElemsCap;
+		oldBuckets  = buckets;
+		oldCap      = cap;
+		migrateIdx  = 0;
+		buckets     = Mem::AllocT<Bucket>(mem, newCap);
+		cap         = newCap;
+	}
+
+	// Draining a bucket backward-shifts its cluster into it, so it's only empty once everything
+	// homed at or before it has moved. Each move or skip counts as a step: a grow finishes within
+	// about 1.75 * oldCap steps, well before the new buckets fill. The old elems are copied over
+	// alongside, MigrateSteps per call, and are done after oldCap * 3/32 calls.
+	void Migrate() {
+		if (oldBuckets) {
+			for (U64 step = 0; step < MigrateSteps && migrateIdx < oldCap; step++) {
+				Bucket const bucket = oldBuckets[migrateIdx];
+				if (bucket.df) {
+					InsertIn(buckets, cap, ElemHash(ElemAt(bucket.idx)), bucket.idx);
+					RemoveAt(oldBuckets, oldCap, migrateIdx);
+				} else {
+					migrateIdx++;
+				}
+			}
+			if (migrateIdx == oldCap) {
+				Mem::Free(mem, oldBuckets);
+				oldBuckets = 0;
+				oldCap     = 0;
+				migrateIdx = 0;
+			}
+		}
+		if (oldElems) {
+			U64 const end = elemsMoved + MigrateSteps < oldElemsLen ? elemsMoved + MigrateSteps : oldElemsLen;
+			for (; elemsMoved < end; elemsMoved++) {
+				elems[elemsMoved] = oldElems[elemsMoved];
+			}
+			if (elemsMoved >= oldElemsLen) {
+				Mem::Free(mem, oldElems);
+				oldElems    = 0;
+				oldElemsLen = 0;
+				elemsMoved  = 0;
+			}
+		}
+	}
+
+	static void Prefetch(void const* p) {
+		_mm_prefetch((char const*)p, _MM_HINT_T0);
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+
+template <class K, class V, bool CacheHash> struct MapElem {
+	K key;
+	V val;
+};
+
+template <class K, class V> struct MapElem<K, V, true> {
+	K   key;
+	V   val;
+	U64 hash;
+};
+
+template <class K, class V, bool CacheHash = false> struct Map : MapCore<K, MapElem<K, V, CacheHash>, CacheHash> {
+	using Elem = MapElem<K, V, CacheHash>;
+	using Core = MapCore<K, Elem, CacheHash>;
+
+	Map() = default;
+
+	Map(Mem mem, U64 capIn) { Core::Init(mem, capIn); }
 
-		return;
+	V FindOrZero(K k) const {
+		Elem const* const elem = Core::FindElem(k);
+		return elem ? elem->val : (V)0;
+	}
+
+	// out[i] = FindOrZero(keys[i])
+	void FindMany(Span<K const> keys, Span<V> out) const {
+		Assert(out.len >= keys.len);
+		Core::FindManyImpl(keys, [&](U64 i, Elem const* elem) { out[i] = elem ? elem->val : (V)0; });
+	}
+
+	V* Put(K k, V v) {
+		U64 const h = Hash(k);
+		if (typename Core::Bucket* const bucket = Core::Find(k, h); bucket) {
+			Elem* const elem = Core::ElemAt(bucket->idx);
+			elem->val = v;
+			return &elem->val;
+		}
+		return &Core::Insert(h, Elem { .key = k, .val = v })->val;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+
+template <class K, bool CacheHash> struct SetElem {
+	K key;
+};
+
+template <class K> struct SetElem<K, true> {
+	K   key;
+	U64 hash;
+};
+
+// Map without the values: elems are just the keys
+template <class K, bool CacheHash = false> struct Set : MapCore<K, SetElem<K, CacheHash>, CacheHash> {
+	using Elem = SetElem<K, CacheHash>;
+	using Core = MapCore<K, Elem, CacheHash>;
+
+	Set() = default;
+
+	Set(Mem mem, U64 capIn) { Core::Init(mem, capIn); }
+
+	bool Has(K k) const {
+		return Core::FindElem(k) != nullptr;
+	}
+
+	// The stored key, for sets that own their keys' storage (e.g. interning)
+	K FindOrZero(K k) const {
+		Elem const* const elem = Core::FindElem(k);
+		return elem ? elem->key : K();
+	}
+
+	// out[i] = Has(keys[i])
+	void FindMany(Span<K const> keys, Span<bool> out) const {
+		Assert(out.len >= keys.len);
+		Core::FindManyImpl(keys, [&](U64 i, Elem const* elem) { out[i] = elem != nullptr; });
+	}
+
+	// Returns false if k was already present
+	bool Add(K k) {
+		U64 const h = Hash(k);
+		if (Core::Find(k, h)) {
+			return false;
+		}
+		Core::Insert(h, Elem { .key = k });
+		return true;
 	}
 };
 
@@ -1,9 +1,10 @@
 #include "JC/Particle.h"
 
-#include "JC/Array.h"
 #include "JC/Draw.h"
+#include "JC/Job.h"
 #include "JC/Math.h"
 #include "JC/Rng.h"
+#include "JC/SoA.h"
 #include "JC/Time.h"
 
 namespace JC::Particle {
@@ -13,16 +14,28 @@ namespace JC::Particle {
 static constexpr U32  MaxEmitters = 1024;
 static constexpr U32  MaxTypes    = 64;
 
-struct Particle {
-	Vec2 pos;
-	F32  size = 0.0f;
-	F32  angle = 0.0f;
-	F32  speed = 0.0f;
-	F32  rotation = 0.0f;
-	Vec4 color;
-	F32  life = 0.0f;
-	F32  lifeEnd = 0.0f;
-};
+// Particle fields, stored SoA so each update loop streams only what it touches
+namespace Field {
+	constexpr U32 Pos      = 0;
+	constexpr U32 Size     = 1;
+	constexpr U32 Angle    = 2;
+	constexpr U32 Speed    = 3;
+	constexpr U32 Rotation = 4;
+	constexpr U32 Color    = 5;
+	constexpr U32 Life     = 6;
+	constexpr U32 LifeEnd  = 7;
+}
+
+using Particles = SoA<
+	Vec2,	// pos
+	F32,	// size
+	F32,	// angle
+	F32,	// speed
+	F32,	// rotation
+	Vec4,	// color
+	F32,	// life
+	F32		// lifeEnd
+>;
 
 struct Type {
 	// animated
@@ -54,7 +67,7 @@ struct Type {
 	Vec4            color3;
 	F32             lifeMin = 0.0f;
 	F32             lifeMax = 0.0f;
-	Array<Particle> particles;
+	Particles       particles;
 };
 
 enum struct Shape {
@@ -90,24 +103,46 @@ static Array<Emitter> emitters;
 
 //--------------------------------------------------------------------------------------------------
 
+// Integrate everything, then expire: the integration loop streams a few fields and vectorizes,
+// and the ones that died this frame are a handful of swap-removes at the end
 static void UpdateParticleType(F32 sec, Type* type) {
-	for (U64 i = 0; i < type->particles.len;) {
-		Particle* const p = &type->particles[i];
-		if (p->life += sec; p->life >= p->lifeEnd) {
-			type->particles.RemoveUnordered(i);
-			continue;
-		}
-		p->size     += sec * type->scaleInc;
-		p->speed    += sec * type->speedInc;
-		p->angle    += sec * type->angleInc;
-		p->rotation += sec * type->rotationInc ;
-		p->pos.x    += sec * p->speed * Math::Cos(Math::DegToRad(p->angle));
-		p->pos.y    += sec * p->speed * Math::Sin(Math::DegToRad(p->angle));
-		F32 t = p->life / p->lifeEnd;
+	Particles* const ps = &type->particles;
+
+	U64 const   len         = ps->len;
+	F32* const  life        = ps->Data<Field::Life>();
+	F32* const  lifeEnd     = ps->Data<Field::LifeEnd>();
+	F32* const  size        = ps->Data<Field::Size>();
+	F32* const  speed       = ps->Data<Field::Speed>();
+	F32* const  angle       = ps->Data<Field::Angle>();
+	F32* const  rotation    = ps->Data<Field::Rotation>();
+	Vec2* const pos         = ps->Data<Field::Pos>();
+	Vec4* const color       = ps->Data<Field::Color>();
+	F32 const   sizeInc     = sec * type->scaleInc;
+	F32 const   speedInc    = sec * type->speedInc;
+	F32 const   angleInc    = sec * type->angleInc;
+	F32 const   rotationInc = sec * type->rotationInc;
+	for (U64 i = 0; i < len; i++) {
+		life[i]     += sec;
+		size[i]     += sizeInc;
+		speed[i]    += speedInc;
+		angle[i]    += angleInc;
+		rotation[i] += rotationInc;
+	}
+	for (U64 i = 0; i < len; i++) {
+		pos[i].x += sec * speed[i] * Math::Cos(Math::DegToRad(angle[i]));
+		pos[i].y += sec * speed[i] * Math::Sin(Math::DegToRad(angle[i]));
+		F32 t = life[i] / lifeEnd[i];
 		if (t < 0.5f) {
-			p->color = Math::Lerp(type->color1, type->color2, t * 2.0f);
+			color[i] = Math::Lerp(type->color1, type->color2, t * 2.0f);
 		} else {
-			p->color = Math::Lerp(type->color2, type->color3, (t - 0.5f) * 2.0f);
+			color[i] = Math::Lerp(type->color2, type->color3, (t - 0.5f) * 2.0f);
+		}
+	}
+
+	for (U64 i = 0; i < ps->len;) {
+		if (life[i] >= lifeEnd[i]) {
+			ps->RemoveUnordered(i);
+			continue;
 		}
 		i++;
 	}
@@ -119,11 +154,12 @@ static void UpdateParticleEmitter(F32 sec, Emitter* emitter) {
 	Type* const t = emitter->type;
 	emitter->emitAccum += emitter->emitRate * sec;
 	while (emitter->emitAccum >= 1.0f) {
-		Particle* const p = t->particles.Add();
+		U64 const p = t->particles.Add();
 		switch (emitter->shape) {
 			case Shape::Rectangle: {
-				p->pos.x = emitter->pos.x + Math::Lerp(emitter->minX, emitter->maxX, Rng::NextF32()) - (t->spriteSize.x / 2) + 0.5f;
-				p->pos.y = emitter->pos.y + Math::Lerp(emitter->minY, emitter->maxY, Rng::NextF32()) - (t->spriteSize.y / 2) + 0.5f;
+				Vec2* const pos = &t->particles.At<Field::Pos>(p);
+				pos->x = emitter->pos.x + Math::Lerp(emitter->minX, emitter->maxX, Rng::NextF32()) - (t->spriteSize.x / 2) + 0.5f;
+				pos->y = emitter->pos.y + Math::Lerp(emitter->minY, emitter->maxY, Rng::NextF32()) - (t->spriteSize.y / 2) + 0.5f;
 
 				break;
 			}
@@ -138,23 +174,22 @@ static void UpdateParticleEmitter(F32 sec, Emitter* emitter) {
 			}
 			default: Panic("Unhandled Shape %u", (U32)emitter->shape);
 		}
-		p->size     = Math::Lerp(t->scaleMin, t->scaleMax, Rng::NextF32());
-		p->angle    = Math::Lerp(t->angleMin, t->angleMax, Rng::NextF32());
-		p->speed    = Math::Lerp(t->speedMin, t->speedMax, Rng::NextF32());
-		p->rotation = Math::Lerp(t->rotationMin, t->rotationMax, Rng::NextF32());
-		p->color    = t->color1;
-		p->life     = 0.0f;
-		p->lifeEnd  = Math::Lerp(t->lifeMin, t->lifeMax, Rng::NextF32());
+		t->particles.At<Field::Size>(p)     = Math::Lerp(t->scaleMin, t->scaleMax, Rng::NextF32());
+		t->particles.At<Field::Angle>(p)    = Math::Lerp(t->angleMin, t->angleMax, Rng::NextF32());
+		t->particles.At<Field::Speed>(p)    = Math::Lerp(t->speedMin, t->speedMax, Rng::NextF32());
+		t->particles.At<Field::Rotation>(p) = Math::Lerp(t->rotationMin, t->rotationMax, Rng::NextF32());
+		t->particles.At<Field::Color>(p)    = t->color1;
+		t->particles.At<Field::Life>(p)     = 0.0f;
+		t->particles.At<Field::LifeEnd>(p)  = Math::Lerp(t->lifeMin, t->lifeMax, Rng::NextF32());
 		emitter->emitAccum -= 1.0f;
 	}
 }
 
 //---------------------------------------------------------------------------------------------
 
+// Types don't share particles, so each is a job; emitting stays serial for Rng
 void Update(F32 sec) {
-	for (U64 i = 0; i < types.len; i++) {
-		UpdateParticleType(sec, &types[i]);
-	}
+	Job::ParallelFor(Span<Type>(types.data, types.len), 1, [sec](Type& type) { UpdateParticleType(sec, &type); });
 
 	for (U64 i = 0; i < emitters.len; i++) {
 		UpdateParticleEmitter(sec, &emitters[i]);
@@ -166,13 +201,15 @@ void Update(F32 sec) {
 void Draw() {
 	for (U64 i = 0; i < types.len; i++) {
 		Type const* const type = &types[i];
-		for (U64 j = 0; j < type->particles.len; i++) {
-			Particle const* const p = &type->particles[j];
+		Vec2 const* const pos   = type->particles.Data<Field::Pos>();
+		F32 const*  const size  = type->particles.Data<Field::Size>();
+		Vec4 const* const color = type->particles.Data<Field::Color>();
+		for (U64 j = 0; j < type->particles.len; j++) {
 			Draw::DrawSprite({
 				.sprite   = type->sprite,
-				.pos      = p->pos,
-				.scale    = Vec2(p->size, p->size),
-				.color    = p->color,
+				.pos      = pos[j],
+				.scale    = Vec2(size[j], size[j]),
+				.color    = color[j],
 			});
 		}
 	}
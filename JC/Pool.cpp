@@ -0,0 +1,72 @@
+#include "JC/Pool.h"
+
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+struct PoolObj {
+	U64 id;
+	U8  payload[56];
+};
+
+Unit_Test("Pool") {
+	Unit_SubTest("Alloc/Free") {
+		Pool<PoolObj> pool;
+		pool.Init(1024);
+		Defer { pool.Shutdown(); };
+
+		PoolObj* const o1 = pool.Alloc();
+		PoolObj* const o2 = pool.Alloc();
+		Unit_CheckEq((U64)((U8*)o2 - (U8*)o1), Pool<PoolObj>::SlotSize);
+		Unit_CheckEq(pool.len, (U64)2);
+
+		memset(o2->payload, 0xab, sizeof(o2->payload));
+		pool.Free(o2);
+		Unit_CheckEq(pool.len, (U64)1);
+
+		PoolObj* const o3 = pool.Alloc();
+		Unit_CheckEq(o3, o2);	// LIFO reuse
+		Unit_CheckEq(o3->payload[sizeof(o3->payload) - 1], (U8)0xab);	// not zeroed
+
+		// Grow across several pages
+		for (U32 i = 0; i < 1000; i++) {
+			pool.Alloc()->id = i;
+		}
+		Unit_CheckEq(pool.len, (U64)1002);
+		Unit_Check(pool.slotsCommit >= 1002 * Pool<PoolObj>::SlotSize);
+	}
+
+	Unit_SubTest("ForEach") {
+		Pool<PoolObj, true> pool;
+		pool.Init(4096);
+		Defer { pool.Shutdown(); };
+
+		PoolObj* objs[200];
+		for (U32 i = 0; i < 200; i++) {
+			objs[i] = pool.Alloc();
+			objs[i]->id = i;
+		}
+		for (U32 i = 0; i < 200; i += 2) {
+			pool.Free(objs[i]);
+		}
+
+		U64 n = 0;
+		U64 sum = 0;
+		pool.ForEach([&](PoolObj* o) { n++; sum += o->id; });
+		Unit_CheckEq(n, (U64)100);
+		Unit_CheckEq(sum, (U64)(100 * 100));	// 1 + 3 + ... + 199
+
+		// Freeing inside ForEach is allowed
+		pool.ForEach([&](PoolObj* o) { if (o->id % 4 == 1) { pool.Free(o); } });
+		n = 0;
+		pool.ForEach([&](PoolObj*) { n++; });
+		Unit_CheckEq(n, (U64)50);
+		Unit_CheckEq(pool.len, (U64)50);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
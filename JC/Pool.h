@@ -0,0 +1,131 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Bit.h"
+#include "JC/Sys.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Fixed-size object pool over its own virtual reservation.
+// Slots are committed a page at a time as the pool grows, and freed slots are threaded onto an
+// intrusive free list, so Alloc and Free are O(1).
+// Alloc does not zero memory: callers initialize what they use.
+// Track = true keeps an occupancy bitmap so ForEach() visits live objects a word at a time.
+template <class T, bool Track = false> struct Pool {
+	static constexpr U64 SlotAlign = alignof(T) > 8 ? alignof(T) : 8;
+	static constexpr U64 SlotSize  = Bit::AlignUp(sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*), SlotAlign);
+
+	static_assert(SlotAlign <= Sys::VirtualPageSize);
+
+	U8*   slots       = 0;
+	U64*  bits        = 0;	// Track only: one bit per slot
+	void* free        = 0;
+	U64   len         = 0;	// live objects
+	U64   slotsLen    = 0;	// slots ever handed out: everything below this is either live or on the free list
+	U64   maxSlots    = 0;
+	U64   slotsCommit = 0;	// bytes
+	U64   bitsCommit  = 0;	// bytes
+
+	Pool() = default;
+	Pool(Pool const&) = delete;
+	Pool& operator=(Pool const&) = delete;
+
+	void Init(U64 maxObjs) {
+		Assert(maxObjs > 0);
+		maxSlots = maxObjs;
+		slots    = (U8*)Sys::VirtualReserve(Bit::AlignUp(maxObjs * SlotSize, 64 * KB));
+		if constexpr (Track) {
+			bits = (U64*)Sys::VirtualReserve(Bit::AlignUp(((maxObjs + 63) / 64) * sizeof(U64), 64 * KB));
+		}
+		free        = 0;
+		len         = 0;
+		slotsLen    = 0;
+		slotsCommit = 0;
+		bitsCommit  = 0;
+	}
+
+	void Shutdown() {
+		Sys::VirtualFree(slots);
+		Sys::VirtualFree(bits);
+		slots       = 0;
+		bits        = 0;
+		free        = 0;
+		len         = 0;
+		slotsLen    = 0;
+		maxSlots    = 0;
+		slotsCommit = 0;
+		bitsCommit  = 0;
+	}
+
+	T* Alloc() {
+		U8* p = 0;
+		if (free) {
+			p = (U8*)free;
+			free = *(void**)free;
+		} else {
+			Assert(slotsLen < maxSlots);
+			if ((slotsLen + 1) * SlotSize > slotsCommit) {
+				_Grow();
+			}
+			p = slots + slotsLen * SlotSize;
+			slotsLen++;
+		}
+		if constexpr (Track) {
+			U64 const i = (U64)(p - slots) / SlotSize;
+			bits[i >> 6] |= (U64)1 << (i & 63);
+		}
+		len++;
+		return (T*)p;
+	}
+
+	void Free(T* obj) {
+		U8* const p = (U8*)obj;
+		Assert(p >= slots && p < slots + slotsLen * SlotSize);
+		Assert((U64)(p - slots) % SlotSize == 0);
+		if constexpr (Track) {
+			U64 const i = (U64)(p - slots) / SlotSize;
+			U64 const mask = (U64)1 << (i & 63);
+			Assert(bits[i >> 6] & mask);	// double free
+			bits[i >> 6] &= ~mask;
+		}
+		*(void**)p = free;
+		free = p;
+		Assert(len > 0);
+		len--;
+	}
+
+	// fn(T*) may Free() the object it's passed
+	template <class F> void ForEach(F&& fn) {
+		static_assert(Track, "ForEach requires an occupancy-tracked Pool");
+		U64 const words = (slotsLen + 63) / 64;
+		for (U64 w = 0; w < words; w++) {
+			U64 word = bits[w];
+			while (word) {
+				U64 const i = (w << 6) + Bit::Bsf64(word);
+				word &= word - 1;
+				fn((T*)(slots + i * SlotSize));
+			}
+		}
+	}
+
+	void _Grow() {
+		U64 const commitSize = Bit::AlignUp(SlotSize, Sys::VirtualPageSize);
+		Sys::VirtualCommit(slots + slotsCommit, commitSize);
+		slotsCommit += commitSize;
+
+		if constexpr (Track) {
+			U64 const bitsNeeded = ((slotsCommit / SlotSize + 63) / 64) * sizeof(U64);
+			if (bitsNeeded > bitsCommit) {
+				U64 const bitsCommitSize = Bit::AlignUp(bitsNeeded - bitsCommit, Sys::VirtualPageSize);
+				Sys::VirtualCommit((U8*)bits + bitsCommit, bitsCommitSize);	// fresh pages are zero
+				bitsCommit += bitsCommitSize;
+			}
+		}
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
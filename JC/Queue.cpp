@@ -0,0 +1,367 @@
+#include "JC/Queue.h"
+
+#include "JC/Bench.h"
+#include "JC/Sys.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Producers push the values [begin, end) in batches of up to batchLen, spinning while full.
+// Consumers pop until they've collectively seen total values, checking order (SPSC) or tallying
+// which values arrived (MPMC)
+template <class Q> struct QueueThreadData {
+	Q*   q;
+	U64  begin;
+	U64  end;
+	U64  batchLen;
+	U64  total;
+	U64* popped;	// shared between consumers
+	U32* seen;	// [value]: how many times it arrived
+	U64  errors;
+	U64  sum;
+};
+
+template <class Q> static void ProduceFn(void* userData) {
+	QueueThreadData<Q>* const data = (QueueThreadData<Q>*)userData;
+	U64 batch[64];
+	for (U64 v = data->begin; v < data->end;) {
+		U64 n = data->end - v < data->batchLen ? data->end - v : data->batchLen;
+		for (U64 i = 0; i < n; i++) {
+			batch[i] = v + i;
+		}
+		U64 pushed = 0;
+		while (pushed < n) {
+			U64 const k = data->q->PushN(batch + pushed, n - pushed);
+			if (!k) {
+				Atomic::Pause();
+			}
+			pushed += k;
+		}
+		v += n;
+	}
+}
+
+template <class Q> static void ConsumeFn(void* userData) {
+	QueueThreadData<Q>* const data = (QueueThreadData<Q>*)userData;
+	U64 batch[64];
+	U64 expected = 0;	// SPSC only
+	while (Atomic::Load(data->popped) < data->total) {
+		U64 const n = data->q->PopN(batch, data->batchLen);
+		if (!n) {
+			Atomic::Pause();
+			continue;
+		}
+		for (U64 i = 0; i < n; i++) {
+			if (data->seen) {
+				Atomic::FetchAdd(&data->seen[batch[i]], 1);
+			} else {
+				data->errors += batch[i] != expected++;
+			}
+			data->sum += batch[i];
+		}
+		Atomic::FetchAdd(data->popped, n);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// The writer fills every field with the frame number, so a torn or half-written read shows up as a
+// mismatch, and frames must never go backwards
+struct TripleBufferFrame {
+	U64 vals[16];
+};
+
+struct TripleBufferThreadData {
+	TripleBuffer<TripleBufferFrame>* tb;
+	U64                              frames;
+	U64                              errors;
+	U64                              seen;	// distinct frames the reader got
+};
+
+static void TripleBufferWriteFn(void* userData) {
+	TripleBufferThreadData* const data = (TripleBufferThreadData*)userData;
+	for (U64 f = 1; f <= data->frames; f++) {
+		TripleBufferFrame* const frame = data->tb->Back();
+		for (U64 i = 0; i < LenOf(frame->vals); i++) {
+			frame->vals[i] = f;
+		}
+		data->tb->Publish();
+	}
+}
+
+static void TripleBufferReadFn(void* userData) {
+	TripleBufferThreadData* const data = (TripleBufferThreadData*)userData;
+	U64 last = 0;
+	while (last < data->frames) {
+		TripleBufferFrame const* const frame = data->tb->Acquire();
+		if (!frame) {
+			Atomic::Pause();
+			continue;
+		}
+		U64 const f = frame->vals[0];
+		for (U64 i = 1; i < LenOf(frame->vals); i++) {
+			data->errors += frame->vals[i] != f;
+		}
+		data->errors += f < last;
+		data->seen   += f != last;
+		last = f;
+	}
+}
+
+Unit_Test("Queue") {
+	Unit_SubTest("Spsc") {
+		SpscQueue<U32> q(testMem, 6);	// rounds up to 8
+		Unit_CheckEq(q.mask + 1, (U64)8);
+		U32 v = 0;
+		Unit_Check(!q.Pop(&v));
+		for (U32 i = 0; i < 8; i++) {
+			Unit_Check(q.Push(i));
+		}
+		Unit_Check(!q.Push(8));
+		Unit_Check(q.Pop(&v));
+		Unit_CheckEq(v, 0u);
+
+		U32 const vals[4] = { 100, 101, 102, 103 };
+		Unit_CheckEq(q.PushN(vals, 4), (U64)1);	// only one slot free
+		U32 out[16];
+		Unit_CheckEq(q.PopN(out, 16), (U64)8);
+		Unit_CheckEq(out[0], 1u);
+		Unit_CheckEq(out[6], 7u);
+		Unit_CheckEq(out[7], 100u);
+		Unit_Check(!q.Pop(&v));
+	}
+
+	Unit_SubTest("Mpmc") {
+		MpmcQueue<U32> q(testMem, 8);
+		U32 v = 0;
+		Unit_Check(!q.Pop(&v));
+		for (U32 i = 0; i < 8; i++) {
+			Unit_Check(q.Push(i));
+		}
+		Unit_Check(!q.Push(8));
+		U32 out[16];
+		Unit_CheckEq(q.PopN(out, 3), (U64)3);
+		Unit_CheckEq(out[2], 2u);
+		U32 const vals[4] = { 100, 101, 102, 103 };
+		Unit_CheckEq(q.PushN(vals, 4), (U64)3);
+		Unit_CheckEq(q.PopN(out, 16), (U64)8);
+		Unit_CheckEq(out[0], 3u);
+		Unit_CheckEq(out[7], 102u);
+		Unit_Check(!q.Pop(&v));
+	}
+
+	Unit_SubTest("Spsc stress") {
+		// A small ring so the two threads lap each other constantly: order must survive every wrap
+		using Q = SpscQueue<U64>;
+		constexpr U64 N = 20000;
+		Q q(testMem, 64);
+		U64 popped = 0;
+		QueueThreadData<Q> producer = { .q = &q, .begin = 0, .end = N, .batchLen = 7 };
+		QueueThreadData<Q> consumer = { .q = &q, .batchLen = 13, .total = N, .popped = &popped };
+		Sys::Thread const pt = Sys::StartThread(ProduceFn<Q>, &producer);
+		Sys::Thread const ct = Sys::StartThread(ConsumeFn<Q>, &consumer);
+		Sys::JoinThread(pt);
+		Sys::JoinThread(ct);
+		Unit_CheckEq(consumer.errors, (U64)0);
+		Unit_CheckEq(consumer.sum, N * (N - 1) / 2);
+	}
+
+	Unit_SubTest("Mpmc stress") {
+		// 4 producers and 4 consumers, single and batched: every value must arrive exactly once
+		using Q = MpmcQueue<U64>;
+		constexpr U32 Threads = 4;
+		constexpr U64 PerThread = 5000;
+		constexpr U64 N = Threads * PerThread;
+		Q q(testMem, 256);
+		U64 popped = 0;
+		U32* const seen = Mem::AllocT<U32>(testMem, N);
+		QueueThreadData<Q> datas[2 * Threads];
+		Sys::Thread threads[2 * Threads];
+		for (U32 t = 0; t < Threads; t++) {
+			datas[t] = { .q = &q, .begin = t * PerThread, .end = (t + 1) * PerThread, .batchLen = (t & 1) ? 16ull : 1ull };
+			datas[Threads + t] = { .q = &q, .batchLen = (t & 1) ? 1ull : 32ull, .total = N, .popped = &popped, .seen = seen };
+		}
+		for (U32 t = 0; t < 2 * Threads; t++) {
+			threads[t] = Sys::StartThread(t < Threads ? ProduceFn<Q> : ConsumeFn<Q>, &datas[t]);
+		}
+		for (U32 t = 0; t < 2 * Threads; t++) {
+			Sys::JoinThread(threads[t]);
+		}
+		U64 errors = 0;
+		for (U64 i = 0; i < N; i++) {
+			errors += seen[i] != 1;
+		}
+		Unit_CheckEq(errors, (U64)0);
+		Unit_CheckEq(popped, N);
+	}
+
+	Unit_SubTest("TripleBuffer") {
+		TripleBuffer<U32>* const tb = Mem::AllocT<TripleBuffer<U32>>(testMem, 1);
+		tb->Init();
+		Unit_Check(!tb->Acquire());
+		*tb->Back() = 1;
+		tb->Publish();
+		Unit_CheckEq(*tb->Acquire(), 1u);
+		Unit_CheckEq(*tb->Acquire(), 1u);	// nothing newer: the same one again
+		*tb->Back() = 2;
+		tb->Publish();
+		*tb->Back() = 3;
+		tb->Publish();
+		Unit_CheckEq(*tb->Acquire(), 3u);	// 2 was never seen
+		*tb->Back() = 4;
+		Unit_CheckEq(*tb->Acquire(), 3u);	// written but not published
+		tb->Publish();
+		Unit_CheckEq(*tb->Acquire(), 4u);
+	}
+
+	Unit_SubTest("TripleBuffer stress") {
+		TripleBuffer<TripleBufferFrame>* const tb = Mem::AllocT<TripleBuffer<TripleBufferFrame>>(testMem, 1);
+		tb->Init();
+		TripleBufferThreadData writer = { .tb = tb, .frames = 100000 };
+		TripleBufferThreadData reader = { .tb = tb, .frames = 100000 };
+		Sys::Thread const wt = Sys::StartThread(TripleBufferWriteFn, &writer);
+		Sys::Thread const rt = Sys::StartThread(TripleBufferReadFn, &reader);
+		Sys::JoinThread(wt);
+		Sys::JoinThread(rt);
+		Unit_CheckEq(reader.errors, (U64)0);
+		Unit_Check(reader.seen > 0);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Uncontended cost of the ops themselves: one thread pushing then popping batches
+Bench_Def("Queue: single-thread push/pop") {
+	constexpr U64 N     = 16 * 1024 * 1024;
+	constexpr U64 Batch = 32;
+
+	SpscQueue<U64> spsc(benchMem, 1024);
+	MpmcQueue<U64> mpmc(benchMem, 1024);
+	U64 batch[Batch] = {};
+	U64 sum = 0;
+
+	U64 start = Time::Now();
+	for (U64 i = 0; i < N; i++) {
+		spsc.Push(i);
+		spsc.Pop(&batch[0]);
+		sum += batch[0];
+	}
+	U64 const spscTicks = Time::Now() - start;
+	start = Time::Now();
+	for (U64 i = 0; i < N; i++) {
+		mpmc.Push(i);
+		mpmc.Pop(&batch[0]);
+		sum += batch[0];
+	}
+	U64 const mpmcTicks = Time::Now() - start;
+	start = Time::Now();
+	for (U64 i = 0; i < N; i += Batch) {
+		mpmc.PushN(batch, Batch);
+		sum += mpmc.PopN(batch, Batch);
+	}
+	U64 const mpmcBatchTicks = Time::Now() - start;
+
+	Bench::Report("SpscQueue",            spscTicks,      N);
+	Bench::Report("MpmcQueue",            mpmcTicks,      N);
+	Bench::Report("MpmcQueue, batch 32",  mpmcBatchTicks, N);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Throughput with every thread hammering the queue: P producers and P consumers, for P up to half
+// the cores (a 1-core box can only show the time-sliced P = 1 case).
+Bench_Def("Queue: throughput under contention") {
+	constexpr U64 PerThread = 1024 * 1024;
+	constexpr U32 MaxPairs  = 16;
+
+	U32 const cpus  = Sys::CpuCount();
+	U32 const pairs = cpus / 2 > 1 ? (cpus / 2 < MaxPairs ? cpus / 2 : MaxPairs) : 1;
+
+	{
+		using Q = SpscQueue<U64>;
+		Q q(benchMem, 4096);
+		U64 popped = 0;
+		QueueThreadData<Q> producer = { .q = &q, .begin = 0, .end = PerThread, .batchLen = 1 };
+		QueueThreadData<Q> consumer = { .q = &q, .batchLen = 1, .total = PerThread, .popped = &popped };
+		U64 const start = Time::Now();
+		Sys::Thread const pt = Sys::StartThread(ProduceFn<Q>, &producer);
+		Sys::Thread const ct = Sys::StartThread(ConsumeFn<Q>, &consumer);
+		Sys::JoinThread(pt);
+		Sys::JoinThread(ct);
+		Bench::Report("SpscQueue 1:1", Time::Now() - start, PerThread);
+		Bench::Consume(consumer.sum);
+	}
+
+	using Q = MpmcQueue<U64>;
+	for (U32 p = 1; p <= pairs; p *= 2) {
+		for (U64 batchLen = 1; batchLen <= 32; batchLen *= 32) {
+			MemMark const mark = Mem::Mark(benchMem);
+			Q q(benchMem, 4096);
+			U64 popped = 0;
+			QueueThreadData<Q>* const datas   = Mem::AllocT<QueueThreadData<Q>>(benchMem, 2 * p);
+			Sys::Thread*        const threads = Mem::AllocT<Sys::Thread>(benchMem, 2 * p);
+			for (U32 t = 0; t < p; t++) {
+				datas[t]     = { .q = &q, .begin = t * PerThread, .end = (t + 1) * PerThread, .batchLen = batchLen };
+				datas[p + t] = { .q = &q, .batchLen = batchLen, .total = p * PerThread, .popped = &popped };
+			}
+			U64 const start = Time::Now();
+			for (U32 t = 0; t < 2 * p; t++) {
+				threads[t] = Sys::StartThread(t < p ? ProduceFn<Q> : ConsumeFn<Q>, &datas[t]);
+			}
+			for (U32 t = 0; t < 2 * p; t++) {
+				Sys::JoinThread(threads[t]);
+			}
+			Bench::Report(SPrintf(benchMem, "MpmcQueue %u:%u, batch %u", p, p, (U32)batchLen), Time::Now() - start, p * PerThread);
+			Mem::Reset(benchMem, mark);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Round trip through a pair of SPSC queues: the handoff latency a pipeline stage pays per item.
+// Needs two cores: time-sliced on one, every trip waits out two scheduler quanta.
+Bench_Def("Queue: SPSC ping-pong latency") {
+	constexpr U64 Trips = 256 * 1024;
+
+	if (Sys::CpuCount() < 2) {
+		return;
+	}
+
+	struct PongData {
+		SpscQueue<U64>* ping;
+		SpscQueue<U64>* pong;
+	};
+	SpscQueue<U64> ping(benchMem, 64);
+	SpscQueue<U64> pong(benchMem, 64);
+	PongData pongData = { .ping = &ping, .pong = &pong };
+	Sys::Thread const thread = Sys::StartThread([](void* userData) {
+		PongData* const data = (PongData*)userData;
+		for (U64 i = 0; i < Trips; i++) {
+			U64 v = 0;
+			while (!data->ping->Pop(&v)) { Atomic::Pause(); }
+			while (!data->pong->Push(v + 1)) { Atomic::Pause(); }
+		}
+	}, &pongData);
+
+	U64 sum = 0;
+	U64 const start = Time::Now();
+	for (U64 i = 0; i < Trips; i++) {
+		U64 v = 0;
+		while (!ping.Push(i)) { Atomic::Pause(); }
+		while (!pong.Pop(&v)) { Atomic::Pause(); }
+		sum += v;
+	}
+	U64 const ticks = Time::Now() - start;
+	Sys::JoinThread(thread);
+	Bench::Report("round trip", ticks, Trips);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Atomic.h"
+#include "JC/Bit.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// Bounded lock-free ring queues. Push fails when full and Pop fails when empty: callers decide
+// whether to spin, back off or drop. Capacities round up to a power of two.
+// Indices only ever grow, so (tail - head) is the length and slots are [idx & mask].
+// Each side's index sits on its own cache line so producers and consumers don't false-share.
+
+constexpr U64 CacheLineSize = 64;
+
+//--------------------------------------------------------------------------------------------------
+
+// One producer thread, one consumer thread. Each side keeps a stale copy of the other's index and
+// only rereads it when the stale one says full (or empty), so in steady state a push or pop touches
+// no line the other side writes.
+template <class T> struct SpscQueue {
+	alignas(CacheLineSize) U64 head;	// consumer
+	U64                        tailCache;	// consumer's last look at tail
+	alignas(CacheLineSize) U64 tail;	// producer
+	U64                        headCache;	// producer's last look at head
+	alignas(CacheLineSize) T*  elems;
+	U64                        mask;
+
+	SpscQueue() = default;
+
+	SpscQueue(Mem mem, U64 cap) { Init(mem, cap); }
+
+	void Init(Mem mem, U64 cap) {
+		Assert(cap > 0);
+		U64 const len = Bit::AlignPow2(cap);
+		elems     = Mem::AllocT<T>(mem, len);
+		mask      = len - 1;
+		head      = 0;
+		tailCache = 0;
+		tail      = 0;
+		headCache = 0;
+	}
+
+	bool Push(T val) { return PushN(&val, 1) == 1; }
+	bool Pop(T* out) { return PopN(out, 1) == 1; }
+
+	// Only a hint while the other side is running
+	bool IsEmpty() const { return Atomic::Load(&head) == Atomic::Load(&tail); }
+
+	// Returns how many were pushed: all of them or as many as fit
+	U64 PushN(T const* vals, U64 n) {
+		U64 const t = tail;
+		U64 room = mask + 1 - (t - headCache);
+		if (room < n) {
+			headCache = Atomic::Load(&head);
+			room = mask + 1 - (t - headCache);
+		}
+		n = n < room ? n : room;
+		for (U64 i = 0; i < n; i++) {
+			elems[(t + i) & mask] = vals[i];
+		}
+		Atomic::Store(&tail, t + n);
+		return n;
+	}
+
+	U64 PopN(T* out, U64 n) {
+		U64 const h = head;
+		U64 avail = tailCache - h;
+		if (avail < n) {
+			tailCache = Atomic::Load(&tail);
+			avail = tailCache - h;
+		}
+		n = n < avail ? n : avail;
+		for (U64 i = 0; i < n; i++) {
+			out[i] = elems[(h + i) & mask];
+		}
+		Atomic::Store(&head, h + n);
+		return n;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+// Any number of producers and consumers (Vyukov's bounded MPMC). Every cell carries a sequence
+// number saying whose turn it is: seq == pos means free for the producer claiming pos, and
+// seq == pos + 1 means full for the consumer claiming pos. A side claims positions by CAS on its
+// index, then publishes the cell by bumping its seq, so the only contended line is that index.
+// PushN/PopN claim a run of ready cells with one CAS.
+template <class T> struct MpmcQueue {
+	struct Cell {
+		U64 seq;
+		T   val;
+	};
+
+	alignas(CacheLineSize) U64   pushPos;
+	alignas(CacheLineSize) U64   popPos;
+	alignas(CacheLineSize) Cell* cells;
+	U64                          mask;
+
+	MpmcQueue() = default;
+
+	MpmcQueue(Mem mem, U64 cap) { Init(mem, cap); }
+
+	void Init(Mem mem, U64 cap) {
+		Assert(cap > 0);
+		U64 const len = Bit::AlignPow2(cap);
+		cells   = Mem::AllocT<Cell>(mem, len);
+		mask    = len - 1;
+		pushPos = 0;
+		popPos  = 0;
+		for (U64 i = 0; i < len; i++) {
+			cells[i].seq = i;
+		}
+	}
+
+	bool Push(T val) { return PushN(&val, 1) == 1; }
+	bool Pop(T* out) { return PopN(out, 1) == 1; }
+
+	// Only a hint while anyone else is running: a claimed cell counts before it's published
+	bool IsEmpty() const { return Atomic::Load(&pushPos) == Atomic::Load(&popPos); }
+
+	U64 PushN(T const* vals, U64 n) {
+		U64 pos = Atomic::Load(&pushPos);
+		U64 k = 0;
+		for (;;) {
+			k = 0;
+			while (k < n && Atomic::Load(&cells[(pos + k) & mask].seq) == pos + k) {
+				k++;
+			}
+			if (k == 0) {
+				I64 const diff = (I64)(Atomic::Load(&cells[pos & mask].seq) - pos);
+				if (diff < 0) {
+					return 0;	// full: the consumer of this cell's last lap hasn't got to it
+				}
+				pos = Atomic::Load(&pushPos);	// another producer took it
+				continue;
+			}
+			if (Atomic::CompareExchange(&pushPos, pos, pos + k)) {
+				break;
+			}
+			pos = Atomic::Load(&pushPos);
+		}
+		for (U64 i = 0; i < k; i++) {
+			Cell* const cell = &cells[(pos + i) & mask];
+			cell->val = vals[i];
+			Atomic::Store(&cell->seq, pos + i + 1);
+		}
+		return k;
+	}
+
+	U64 PopN(T* out, U64 n) {
+		U64 pos = Atomic::Load(&popPos);
+		U64 k = 0;
+		for (;;) {
+			k = 0;
+			while (k < n && Atomic::Load(&cells[(pos + k) & mask].seq) == pos + k + 1) {
+				k++;
+			}
+			if (k == 0) {
+				I64 const diff = (I64)(Atomic::Load(&cells[pos & mask].seq) - (pos + 1));
+				if (diff < 0) {
+					return 0;	// empty: this cell's producer hasn't published it
+				}
+				pos = Atomic::Load(&popPos);	// another consumer took it
+				continue;
+			}
+			if (Atomic::CompareExchange(&popPos, pos, pos + k)) {
+				break;
+			}
+			pos = Atomic::Load(&popPos);
+		}
+		for (U64 i = 0; i < k; i++) {
+			Cell* const cell = &cells[(pos + i) & mask];
+			out[i] = cell->val;
+			Atomic::Store(&cell->seq, pos + i + mask + 1);	// free for the producer one lap on
+		}
+		return k;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+// One writer, one reader, and only the latest value matters: a frame's state handed from the sim
+// to the renderer. Of the three slots the writer owns one (back), the reader owns one (front) and
+// the third (middle) sits between them. Publish() swaps back into middle with one Exchange; Acquire()
+// swaps middle into front, but only when it holds something newer. Neither side ever waits or
+// copies, and nothing writes the slot the reader holds. A writer faster than the reader just
+// overwrites the middle: frames the reader never saw are dropped.
+template <class T> struct TripleBuffer {
+	static constexpr U32 FreshBit = 4;	// on middle: published since the reader last took it
+
+	alignas(CacheLineSize) U32 back;	// writer
+	alignas(CacheLineSize) U32 front;	// reader
+	bool                       acquired;	// reader: front holds something published
+	alignas(CacheLineSize) U32 middle;	// slot index | FreshBit
+	alignas(CacheLineSize) T   slots[3];
+
+	void Init() {
+		back     = 0;
+		middle   = 1;
+		front    = 2;
+		acquired = false;
+	}
+
+	// Holds whatever was published two frames ago, if anything: write every field
+	T* Back() { return &slots[back]; }
+
+	void Publish() { back = Atomic::Exchange(&middle, back | FreshBit) & ~FreshBit; }
+
+	// The newest published value, the one returned last time if nothing newer has been, or null
+	// before the first Publish(). Valid until the next Acquire().
+	T const* Acquire() {
+		if (Atomic::Load(&middle) & FreshBit) {
+			front    = Atomic::Exchange(&middle, front) & ~FreshBit;
+			acquired = true;
+		}
+		return acquired ? &slots[front] : nullptr;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -1,58 +1,89 @@
 #include "JC/Rng.h"
 
+#include "JC/UnitTest.h"
+
 namespace JC::Rng {
 
 //--------------------------------------------------------------------------------------------------
 
-static U64 xoroshiro128State[2] = { 1, 2 };
-static U64 splitMix64State; /* The xoroshiro128State can be seeded with any value. */
+static Gen shared = { .state = { 1, 2 } };
 
-static U64 SplitMix64() {
-	splitMix64State += 0x9e3779b97f4a7c15;
-	U64 z = splitMix64State;
+static U64 SplitMix64(U64* state) {
+	*state += 0x9e3779b97f4a7c15;
+	U64 z = *state;
 	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
 	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
 	return z ^ (z >> 31);
 }
 
+// The xoroshiro128 state can be seeded with any value: spread the seed over both words with SplitMix64
+Gen MakeGen(U64 seed) {
+	Gen gen;
+	gen.state[0] = SplitMix64(&seed);
+	gen.state[1] = SplitMix64(&seed);
+	return gen;
+}
+
 void Seed(U64 seed) {
-	splitMix64State = seed;
-	xoroshiro128State[0] = SplitMix64();
-	xoroshiro128State[1] = SplitMix64();
+	shared = MakeGen(seed);
 }
 
 static U64 Rotl(U64 x, U32 k) {
 	return (x << k) | (x >> (64 - k));
 }
 
-static U64 Next() {
-	U64 const s0 = xoroshiro128State[0];
-	U64 s1 = xoroshiro128State[1];
+static U64 Next(Gen* gen) {
+	U64 const s0 = gen->state[0];
+	U64 s1 = gen->state[1];
 	U64 const res = s0 + s1;
 	s1 ^= s0;
-	xoroshiro128State[0] = Rotl(s0, 24) ^ s1 ^ (s1 << 16);
-	xoroshiro128State[1] = Rotl(s1, 37);
+	gen->state[0] = Rotl(s0, 24) ^ s1 ^ (s1 << 16);
+	gen->state[1] = Rotl(s1, 37);
 	return res;
 }
 
 U32 NextU32() {
-	return (U32)Next();
+	return (U32)Next(&shared);
 }
 
 U32 NextU32(U32 minInclusive, U32 maxExclusive) {
-	return minInclusive + ((U32)Next() % (maxExclusive - minInclusive));
+	return minInclusive + ((U32)Next(&shared) % (maxExclusive - minInclusive));
 }
 
 U64 NextU64() {
-	return Next();
+	return Next(&shared);
 }
 
 F32 NextF32() {
-	return (F32)((Next() >> 11) * 0x1.0p-53);
+	return (F32)((Next(&shared) >> 11) * 0x1.0p-53);
 }
 
 F64 NextF64() {
-	return (Next() >> 11) * 0x1.0p-53;
+	return (Next(&shared) >> 11) * 0x1.0p-53;
+}
+
+U64 NextU64(Gen* gen) {
+	return Next(gen);
+}
+
+F32 NextF32(Gen* gen) {
+	return (F32)((Next(gen) >> 11) * 0x1.0p-53);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("Rng.Gen") {
+	Seed(0x9e3779b97f4a7c15);
+	U64 const shared0 = NextU64();
+	Seed(0x9e3779b97f4a7c15);
+	Gen gen = MakeGen(0x9e3779b97f4a7c15);
+	Unit_CheckEq(NextU64(&gen), shared0);	// same seed, same sequence
+	Gen other = MakeGen(0x9e3779b97f4a7c15);
+	NextU64(&other);
+	Unit_CheckEq(NextU64(), shared0);	// drawing from a Gen leaves the shared state alone
+	Unit_CheckEq(NextU64(&gen), NextU64(&other));
+	F32 const f = NextF32(&gen);
+	Unit_Check(f >= 0.f && f < 1.f);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -13,6 +13,16 @@ U64  NextU64();
 F32  NextF32();
 F64  NextF64();
 
+// A generator with its own state, for tests and benches that want a fixed sequence without
+// reseeding the shared one above
+struct Gen {
+	U64 state[2];
+};
+
+Gen MakeGen(U64 seed);
+U64 NextU64(Gen* gen);
+F32 NextF32(Gen* gen);
+
 //--------------------------------------------------------------------------------------------------
 
 }	// namespace JC::Rng
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "JC/SoA.h"
+
+#include "JC/Bench.h"
+#include "JC/Math.h"
+#include "JC/Rng.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("SoA") {
+	Unit_SubTest("Add/Remove") {
+		using TestSoA = SoA<U8, U64, Vec4>;
+		TestSoA soa(testMem, 100);
+		for (U32 i = 0; i < LenOf(soa.fields); i++) {
+			Unit_CheckEq((U64)soa.fields[i] % TestSoA::FieldAlign, (U64)0);
+		}
+
+		for (U32 i = 0; i < 10; i++) {
+			Unit_CheckEq(soa.Add((U8)i, (U64)i * 100, Vec4 { .x = (F32)i }), (U64)i);
+		}
+		Unit_CheckEq(soa.Add(), (U64)10);
+		Unit_CheckEq(soa.At<1>(10), (U64)0);
+		Unit_CheckEq(soa.len, (U64)11);
+
+		soa.RemoveUnordered(2);	// 10 moves into 2
+		Unit_CheckEq(soa.len, (U64)10);
+		Unit_CheckEq(soa.At<0>(2), (U8)0);
+		Unit_CheckEq(soa.At<1>(2), (U64)0);
+		soa.RemoveUnordered(9);	// the last one: nothing moves
+		Unit_CheckEq(soa.len, (U64)9);
+
+		soa.Swap(0, 8);
+		Unit_CheckEq(soa.At<0>(0), (U8)8);
+		Unit_CheckEq(soa.At<1>(8), (U64)0);
+		Unit_CheckEq(soa.At<2>(0).x, 8.0f);
+
+		// Every field moved together
+		Span<U8 const> const a = ((TestSoA const&)soa).Get<0>();
+		U64 errors = 0;
+		for (U64 i = 0; i < a.len; i++) {
+			errors += soa.At<1>(i) != (U64)a[i] * 100;
+			errors += soa.At<2>(i).x != (F32)a[i];
+		}
+		Unit_CheckEq(errors, (U64)0);
+
+		Unit_CheckEq(soa.AddN(5), (U64)9);
+		Unit_CheckEq(soa.Get<2>().len, (U64)14);
+		Unit_Check(soa.HasCapacity(86));
+		Unit_Check(!soa.HasCapacity(87));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Particle::Particle's layout, and UpdateParticleType's work, both ways round
+
+struct AoSParticle {
+	Vec2 pos;
+	F32  size;
+	F32  angle;
+	F32  speed;
+	F32  rotation;
+	Vec4 color;
+	F32  life;
+	F32  lifeEnd;
+};
+
+namespace PF {
+	constexpr U32 Pos      = 0;
+	constexpr U32 Size     = 1;
+	constexpr U32 Angle    = 2;
+	constexpr U32 Speed    = 3;
+	constexpr U32 Rotation = 4;
+	constexpr U32 Color    = 5;
+	constexpr U32 Life     = 6;
+	constexpr U32 LifeEnd  = 7;
+}
+
+using SoAParticles = SoA<Vec2, F32, F32, F32, F32, Vec4, F32, F32>;
+
+struct BenchParticleType {
+	F32  scaleInc;
+	F32  speedInc;
+	F32  angleInc;
+	F32  rotationInc;
+	Vec4 color1;
+	Vec4 color2;
+	Vec4 color3;
+};
+
+static inline Vec4 LerpV4(Vec4 a, Vec4 b, F32 t) {
+	return Vec4 { .x = a.x + (b.x - a.x) * t, .y = a.y + (b.y - a.y) * t, .z = a.z + (b.z - a.z) * t, .w = a.w + (b.w - a.w) * t };
+}
+
+static void UpdateAoS(F32 sec, BenchParticleType const* type, AoSParticle* ps, U64* len, bool full) {
+	for (U64 i = 0; i < *len;) {
+		AoSParticle* const p = &ps[i];
+		if (p->life += sec; p->life >= p->lifeEnd) {
+			ps[i] = ps[--*len];
+			continue;
+		}
+		p->size     += sec * type->scaleInc;
+		p->speed    += sec * type->speedInc;
+		p->angle    += sec * type->angleInc;
+		p->rotation += sec * type->rotationInc;
+		if (full) {
+			p->pos.x += sec * p->speed * Math::Cos(Math::DegToRad(p->angle));
+			p->pos.y += sec * p->speed * Math::Sin(Math::DegToRad(p->angle));
+			F32 const t = p->life / p->lifeEnd;
+			p->color = t < 0.5f ? LerpV4(type->color1, type->color2, t * 2.0f) : LerpV4(type->color2, type->color3, (t - 0.5f) * 2.0f);
+		}
+		i++;
+	}
+}
+
+static void UpdateSoA(F32 sec, BenchParticleType const* type, SoAParticles* ps, bool full) {
+	U64 const   len         = ps->len;
+	F32* const  life        = ps->Data<PF::Life>();
+	F32* const  lifeEnd     = ps->Data<PF::LifeEnd>();
+	F32* const  size        = ps->Data<PF::Size>();
+	F32* const  speed       = ps->Data<PF::Speed>();
+	F32* const  angle       = ps->Data<PF::Angle>();
+	F32* const  rotation    = ps->Data<PF::Rotation>();
+	F32 const   sizeInc     = sec * type->scaleInc;
+	F32 const   speedInc    = sec * type->speedInc;
+	F32 const   angleInc    = sec * type->angleInc;
+	F32 const   rotationInc = sec * type->rotationInc;
+	for (U64 i = 0; i < len; i++) {
+		life[i]     += sec;
+		size[i]     += sizeInc;
+		speed[i]    += speedInc;
+		angle[i]    += angleInc;
+		rotation[i] += rotationInc;
+	}
+	if (full) {
+		Vec2* const pos   = ps->Data<PF::Pos>();
+		Vec4* const color = ps->Data<PF::Color>();
+		for (U64 i = 0; i < len; i++) {
+			pos[i].x += sec * speed[i] * Math::Cos(Math::DegToRad(angle[i]));
+			pos[i].y += sec * speed[i] * Math::Sin(Math::DegToRad(angle[i]));
+			F32 const t = life[i] / lifeEnd[i];
+			color[i] = t < 0.5f ? LerpV4(type->color1, type->color2, t * 2.0f) : LerpV4(type->color2, type->color3, (t - 0.5f) * 2.0f);
+		}
+	}
+
+	for (U64 i = 0; i < ps->len;) {
+		if (life[i] >= lifeEnd[i]) {
+			ps->RemoveUnordered(i);
+			continue;
+		}
+		i++;
+	}
+}
+
+// "hot" is the per-frame scalar integration alone, "full" adds the position and color work.
+// 16K particles fit in L2 either way; 1M don't, and the loops become memory bound.
+Bench_Def("Particles: AoS vs SoA update") {
+	constexpr U64 Lens[] = { 16 * 1024, 1024 * 1024 };
+	constexpr U64 MaxLen = 1024 * 1024;
+	constexpr U32 Frames = 60;
+	constexpr F32 Sec    = 1.0f / 60.0f;
+
+	BenchParticleType const type = {
+		.scaleInc    = 0.1f,
+		.speedInc    = -0.5f,
+		.angleInc    = 15.0f,
+		.rotationInc = 90.0f,
+		.color1      = { 1.0f, 1.0f, 1.0f, 1.0f },
+		.color2      = { 1.0f, 0.5f, 0.0f, 1.0f },
+		.color3      = { 0.2f, 0.2f, 0.2f, 0.0f },
+	};
+
+	AoSParticle* const aos = Mem::AllocT<AoSParticle>(benchMem, MaxLen);
+	SoAParticles soa(benchMem, MaxLen);
+	for (U32 run = 0; run < 2 * LenOf(Lens); run++) {
+		U64 const  Len  = Lens[run / 2];
+		bool const full = run & 1;
+		Rng::Gen gen = Rng::MakeGen(0x2545f4914f6cdd1d);
+		U64 aosLen = Len;
+		soa.len = 0;
+		for (U64 i = 0; i < Len; i++) {
+			F32 const r = Rng::NextF32(&gen);
+			aos[i] = {
+				.pos      = { r * 1000.0f, r * 500.0f },
+				.size     = 1.0f,
+				.angle    = r * 360.0f,
+				.speed    = 10.0f + r * 10.0f,
+				.rotation = 0.0f,
+				.color    = type.color1,
+				.life     = 0.0f,
+				.lifeEnd  = 0.25f + r * 2.0f,	// about a third expire over the run
+			};
+			soa.Add(aos[i].pos, aos[i].size, aos[i].angle, aos[i].speed, aos[i].rotation, aos[i].color, aos[i].life, aos[i].lifeEnd);
+		}
+
+		U64 ops = 0;
+		U64 start = Time::Now();
+		for (U32 f = 0; f < Frames; f++) {
+			ops += aosLen;
+			UpdateAoS(Sec, &type, aos, &aosLen, full);
+		}
+		U64 const aosTicks = Time::Now() - start;
+
+		start = Time::Now();
+		for (U32 f = 0; f < Frames; f++) {
+			UpdateSoA(Sec, &type, &soa, full);
+		}
+		U64 const soaTicks = Time::Now() - start;
+
+		Assert(soa.len == aosLen);
+		char const* const what = full ? "full" : "hot";
+		Bench::Report(SPrintf(benchMem, "%uK %s: AoS", Len / 1024, what), aosTicks, ops);
+		Bench::Report(SPrintf(benchMem, "%uK %s: SoA", Len / 1024, what), soaTicks, ops);
+		Bench::Consume((U64)(soa.Get<PF::Size>()[0] + aos[0].size));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
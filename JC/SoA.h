@@ -0,0 +1,115 @@
+#pragma once
+
+#include "JC/Common.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+template <U32 I, class T, class... Ts> struct SoAFieldType { using Type = typename SoAFieldType<I - 1, Ts...>::Type; };
+template <class T, class... Ts> struct SoAFieldType<0, T, Ts...> { using Type = T; };
+
+// Array of structs turned inside out: one array per field, all sharing len and maxLen, so a loop
+// over a few fields streams only those and the compiler can vectorize it.
+// Fields are addressed by index, so give them names at the use site:
+//   namespace P { constexpr U32 Pos = 0; constexpr U32 Life = 1; }
+//   SoA<Vec2, F32> ps;  F32* life = ps.Data<P::Life>();
+// Field types must be trivially copyable: elements are moved with memcpy.
+template <class... Fields> struct SoA {
+	static constexpr U32 FieldsLen  = sizeof...(Fields);
+	static constexpr U64 FieldAlign = 64;	// a cache line: whole AVX-512 vectors, and no field array shares a line
+	static constexpr U64 FieldSizes[FieldsLen] = { sizeof(Fields)... };
+
+	template <U32 I> using Field = typename SoAFieldType<I, Fields...>::Type;
+
+	U8* fields[FieldsLen] = {};
+	U64 len    = 0;
+	U64 maxLen = 0;
+
+	SoA() = default;
+
+	SoA(Mem mem, U64 maxLenIn, SrcLoc sl = SrcLoc::Here()) {
+		Init(mem, maxLenIn, sl);
+	}
+
+	SoA(SoA const&) = delete;
+	SoA& operator=(SoA const&) = delete;
+
+	void Init(Mem mem, U64 maxLenIn, SrcLoc sl = SrcLoc::Here()) {
+		len    = 0;
+		maxLen = maxLenIn;
+		for (U32 f = 0; f < FieldsLen; f++) {
+			fields[f] = (U8*)Mem::AllocAligned(mem, maxLenIn * FieldSizes[f], FieldAlign, sl);
+		}
+	}
+
+	template <U32 I> Field<I>*       Data()       { return (Field<I>*)fields[I]; }
+	template <U32 I> Field<I> const* Data() const { return (Field<I> const*)fields[I]; }
+
+	template <U32 I> Span<Field<I>>       Get()       { return Span<Field<I>>((Field<I>*)fields[I], len); }
+	template <U32 I> Span<Field<I> const> Get() const { return Span<Field<I> const>((Field<I> const*)fields[I], len); }
+
+	template <U32 I> Field<I>& At(U64 i) { Assert(i < len); return ((Field<I>*)fields[I])[i]; }
+
+	// Zeroed element: returns its index
+	U64 Add() {
+		Assert(len + 1 <= maxLen);
+		for (U32 f = 0; f < FieldsLen; f++) {
+			memset(fields[f] + len * FieldSizes[f], 0, FieldSizes[f]);
+		}
+		return len++;
+	}
+
+	U64 Add(Fields const&... vals) {
+		Assert(len + 1 <= maxLen);
+		U32 f = 0;
+		((memcpy(fields[f] + len * FieldSizes[f], &vals, FieldSizes[f]), f++), ...);
+		return len++;
+	}
+
+	// Zeroed elements: returns the index of the first
+	U64 AddN(U64 n) {
+		Assert(len + n <= maxLen);
+		for (U32 f = 0; f < FieldsLen; f++) {
+			memset(fields[f] + len * FieldSizes[f], 0, n * FieldSizes[f]);
+		}
+		U64 const first = len;
+		len += n;
+		return first;
+	}
+
+	void Remove() {
+		Assert(len > 0);
+		len--;
+	}
+
+	void RemoveUnordered(U64 i) {
+		Assert(len > 0);
+		Assert(i < len);
+		len--;
+		if (i != len) {
+			for (U32 f = 0; f < FieldsLen; f++) {
+				memcpy(fields[f] + i * FieldSizes[f], fields[f] + len * FieldSizes[f], FieldSizes[f]);
+			}
+		}
+	}
+
+	void Swap(U64 i, U64 j) {
+		Assert(i < len && j < len);
+		for (U32 f = 0; f < FieldsLen; f++) {
+			U8* const pi = fields[f] + i * FieldSizes[f];
+			U8* const pj = fields[f] + j * FieldSizes[f];
+			for (U64 b = 0; b < FieldSizes[f]; b++) {
+				U8 const t = pi[b]; pi[b] = pj[b]; pj[b] = t;
+			}
+		}
+	}
+
+	bool HasCapacity(U64 n = 1) {
+		return len + n <= maxLen;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
@@ -1,37 +1,489 @@
 #include "JC/StrDb.h"
 
+#include "JC/Atomic.h"
+#include "JC/Bench.h"
+#include "JC/Bit.h"
+#include "JC/File.h"
 #include "JC/Hash.h"
 #include "JC/Map.h"
+#include "JC/Sys.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
 
 namespace JC::StrDb {
 
 //--------------------------------------------------------------------------------------------------
 
-static constexpr U64 MaxStrings = 1 * MB;	// bump as needed
+// Insert-only and safe from any thread, and lock-free outside of a grow. The table is (top 32 hash
+// bits | id) slots with linear probing. A new string gets its id, SymObj and bytes first and is then
+// published with a CAS on the first empty slot of its probe: a thread that loses the race to the
+// same slot rereads it and carries on probing, so two racing inserts of one string agree on one id.
+// The loser's id and bytes are left unused: a SymObj and the string, only when two threads add the
+// same new string at the same moment.
+// Past half full the inserting thread grows the table, RCU style: under growMutex it copies the
+// slots into one twice the size, sealing each empty slot with Moved as it passes so nothing can land
+// behind it, then publishes the new table with one store. Filled slots never change, so lookups on
+// the old table stay right; an insert or lookup that runs into Moved waits for (or, for a lookup,
+// skips past) the swap. Old tables are never freed, since a reader may still be probing one.
+// symObjs and the string bytes are reserved up front and committed as they fill, so entries never
+// move. Each thread copies its strings into its own 64KB chunk of the bytes, and only takes
+// commitMutex when an id crosses into an uncommitted page of symObjs.
+
+static constexpr U64 InitialSlots = 8 * 1024;	// 4K strings
+static constexpr U64 MaxSyms      = 16 * 1024 * 1024;	// only reserved
+static constexpr U64 MaxStrBytes  = 1 * GB;	// only reserved
+static constexpr U64 CommitSize   = 64 * KB;
+static constexpr U64 ChunkSize    = 64 * KB;	// per thread, a multiple of CommitSize
+static constexpr U64 TagMask      = 0xffffffff00000000;
+static constexpr U64 Moved        = ~(U64)0;	// an empty slot sealed by Grow(): ids never reach U32Max
 
 static constexpr char const* Empty = "";
 
-static Mem           mem;
-static Map<Str, Str> index;
+struct SymObj {
+	Str str;
+	U64 hash;
+};
+
+struct Table {
+	U64  mask;	// slots - 1
+	U64  len;	// filled slots
+	U64* slots;	// 0 is empty, Moved is sealed, else tag | id
+};
+
+struct Chunk {
+	char* data;
+	U64   len;
+	U64   cap;
+};
+
+static Mem        mem;	// tables, only allocated from under growMutex
+static U64        table;	// the current Table*
+static Sys::Mutex growMutex;
+static Sys::Mutex commitMutex;
+static SymObj*    symObjs;	// indexed by Sym::id
+static U64        symObjsLen;	// ids handed out
+static U64        symObjsCommit;	// bytes, only written under commitMutex
+static char*      strBytes;
+static U64        strBytesLen;	// handed out to the threads' chunks
+
+static thread_local Chunk chunk;
+
+//--------------------------------------------------------------------------------------------------
+
+static Table* GetTable() {
+	return (Table*)Atomic::Load(&table);
+}
+
+static Table* NewTable(U64 slotsLen) {
+	Table* const t = Mem::AllocT<Table>(mem, 1);
+	t->mask  = slotsLen - 1;
+	t->len   = 0;
+	t->slots = Mem::AllocT<U64>(mem, slotsLen);
+	return t;
+}
 
 //--------------------------------------------------------------------------------------------------
 
 void Init() {
-	mem = Mem::Create(1 * GB);
-	index.Init(mem, MaxStrings);
+	mem           = Mem::Create(1 * GB);
+	table         = (U64)NewTable(InitialSlots);
+	symObjs       = (SymObj*)Sys::VirtualReserve(Bit::AlignUp(MaxSyms * sizeof(SymObj), CommitSize));
+	Sys::VirtualCommit(symObjs, CommitSize);
+	symObjsCommit = CommitSize;
+	symObjs[0]    = { .str = Str(Empty, 0), .hash = Hash(Str(Empty, 0)) };
+	symObjsLen    = 1;
+	strBytes      = (char*)Sys::VirtualReserve(MaxStrBytes);
+	strBytesLen   = 0;
+	chunk         = {};
+	Sys::InitMutex(&growMutex);
+	Sys::InitMutex(&commitMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Sym() if s isn't in t, and *sealed says whether the probe ended on a slot sealed by Grow()
+static U32 FindIn(Table const* t, Str s, U64 h, bool* sealed) {
+	U64 const tag = h & TagMask;
+	for (U64 i = h & t->mask; ; i = (i + 1) & t->mask) {
+		U64 const slot = Atomic::Load(&t->slots[i]);
+		if (slot == 0 || slot == Moved) {
+			*sealed = slot == Moved;
+			return 0;
+		}
+		if ((slot & TagMask) == tag && symObjs[(U32)slot].str == s) {
+			return (U32)slot;
+		}
+	}
+}
+
+// Copies s into this thread's chunk: s may live in a temp arena or an unmapped file view
+static char* CopyStrBytes(Str s) {
+	if (chunk.len + s.len > chunk.cap) {
+		// The old chunk's tail is left unused: less than s.len
+		U64 const size = Bit::AlignUp(s.len > ChunkSize ? (U64)s.len : ChunkSize, CommitSize);
+		U64 const offset = Atomic::FetchAdd(&strBytesLen, size);
+		Assert(offset + size <= MaxStrBytes);
+		Sys::VirtualCommit(strBytes + offset, size);	// ours alone: no other thread touches these pages
+		chunk = { .data = strBytes + offset, .len = 0, .cap = size };
+	}
+	char* const data = chunk.data + chunk.len;
+	memcpy(data, s.data, s.len);
+	chunk.len += s.len;
+	return data;
+}
+
+static U32 NewSym(Str s, U64 h) {
+	U64 const id = Atomic::FetchAdd(&symObjsLen, 1);
+	Assert(id < MaxSyms);
+	U64 const needed = (id + 1) * sizeof(SymObj);
+	if (Atomic::Load(&symObjsCommit) < needed) {
+		Sys::LockMutex(&commitMutex);
+		for (U64 commit = symObjsCommit; commit < needed; commit += CommitSize) {
+			Sys::VirtualCommit((U8*)symObjs + commit, CommitSize);
+			Atomic::Store(&symObjsCommit, commit + CommitSize);
+		}
+		Sys::UnlockMutex(&commitMutex);
+	}
+	symObjs[id] = { .str = Str(CopyStrBytes(s), s.len), .hash = h };
+	return (U32)id;	// published by the caller's CAS
+}
+
+// Under growMutex, and into a table no other thread can see yet
+static void CopyIn(Table* t, U64 slot) {
+	for (U64 i = symObjs[(U32)slot].hash & t->mask; ; i = (i + 1) & t->mask) {
+		if (!t->slots[i]) {
+			t->slots[i] = slot;
+			t->len++;
+			return;
+		}
+	}
+}
+
+static void Grow(Table* t) {
+	Sys::LockMutex(&growMutex);
+	if (GetTable() == t) {	// else another thread got here first
+		Table* const next = NewTable(2 * (t->mask + 1));
+		for (U64 i = 0; i <= t->mask; i++) {
+			if (!Atomic::CompareExchange(&t->slots[i], 0, Moved)) {
+				CopyIn(next, Atomic::Load(&t->slots[i]));	// filled, by now or before the seal
+			}
+		}
+		Atomic::Store(&table, (U64)next);
+	}
+	Sys::UnlockMutex(&growMutex);
+}
+
+// A thread that ran into a sealed slot: the grow holds growMutex until the new table is published
+static void WaitForGrow() {
+	Sys::LockMutex(&growMutex);
+	Sys::UnlockMutex(&growMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Sym InternSym(Str s) {
+	if (s.len == 0) { return Sym(); }
+	U64 const h   = Hash(s);
+	U64 const tag = h & TagMask;
+	U32 newId = 0;	// made at the first empty slot, and kept across a grow
+	for (;;) {
+		Table* const t = GetTable();
+		for (U64 i = h & t->mask; ; i = (i + 1) & t->mask) {
+			U64 slot = Atomic::Load(&t->slots[i]);
+			if (slot == 0) {
+				if (!newId) {
+					newId = NewSym(s, h);
+				}
+				if (Atomic::CompareExchange(&t->slots[i], 0, tag | newId)) {
+					if (2 * (Atomic::FetchAdd(&t->len, 1) + 1) > t->mask + 1) {
+						Grow(t);
+					}
+					return Sym { .id = newId };
+				}
+				slot = Atomic::Load(&t->slots[i]);	// lost the slot: to Grow() or another insert
+			}
+			if (slot == Moved) {
+				break;
+			}
+			if ((slot & TagMask) == tag && symObjs[(U32)slot].str == s) {
+				return Sym { .id = (U32)slot };
+			}
+		}
+		WaitForGrow();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Sym FindSym(Str s) {
+	if (s.len == 0) { return Sym(); }
+	U64 const h = Hash(s);
+	for (;;) {
+		Table const* const t = GetTable();
+		bool sealed = false;
+		U32 const id = FindIn(t, s, h, &sealed);
+		// Sealed while t is still current: a grow is copying, and s would have landed before the
+		// sealed slot had it been added, so it isn't in yet
+		if (id || !sealed || GetTable() == t) {
+			return Sym { .id = id };
+		}
+	}
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Str Intern(Str s) {
-	if (s.len == 0) { return Str(Empty, 0); }
-	Str str = index.FindOrZero(s);
-	if (str.len) { return str; }
-	str.data = (char*)Mem::Alloc(mem, s.len);
-	str.len  = s.len;
-	memcpy((char*)str.data, s.data, s.len);
-	index.Put(s, str);
-	return str;
+	return symObjs[InternSym(s).id].str;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Str GetStr(Sym sym) {
+	Assert(sym.id < Atomic::Load(&symObjsLen));
+	return symObjs[sym.id].str;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+U64 GetHash(Sym sym) {
+	Assert(sym.id < Atomic::Load(&symObjsLen));
+	return symObjs[sym.id].hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+struct InternThreadData {
+	Str const* strs;
+	U32        strsLen;
+	U32        start;	// each thread walks the strings from a different place
+	Sym*       syms;
+};
+
+static void InternThreadFn(void* userData) {
+	InternThreadData* const data = (InternThreadData*)userData;
+	for (U32 i = 0; i < data->strsLen; i++) {
+		U32 const j = (data->start + i) % data->strsLen;
+		data->syms[j] = InternSym(data->strs[j]);
+	}
+}
+
+Unit_Test("StrDb.Sym") {
+	Unit_SubTest("Empty") {
+		Unit_Check(!InternSym(""));
+		Unit_Check(InternSym("") == Sym());
+		Unit_CheckEq(GetStr(Sym()).len, 0u);
+		Unit_CheckEq(Intern("").len, 0u);
+	}
+
+	Unit_SubTest("RoundTrip") {
+		char buf[] = "StrDb.Sym.RoundTrip";
+		Unit_Check(!FindSym(buf));
+		Sym const sym = InternSym(buf);
+		Unit_Check(sym);
+		Unit_Check(FindSym(buf) == sym);
+		buf[0] = 'X';	// the db owns its copy
+		Unit_Check(GetStr(sym) == "StrDb.Sym.RoundTrip");
+		Unit_CheckEq(GetHash(sym), Hash(Str("StrDb.Sym.RoundTrip")));
+		Unit_Check(InternSym("StrDb.Sym.RoundTrip") == sym);
+		Unit_Check(Intern("StrDb.Sym.RoundTrip").data == GetStr(sym).data);
+		Unit_Check(!(InternSym("StrDb.Sym.Other") == sym));
+	}
+
+	Unit_SubTest("Many") {
+		constexpr U32 N = 20000;	// enough to grow the table a few times and commit more string bytes
+		Sym* const syms = Mem::AllocT<Sym>(testMem, N);
+		for (U32 i = 0; i < N; i++) {
+			syms[i] = InternSym(SPrintf(testMem, "StrDb.Sym.Many.%u", i));
+		}
+		U32 errors = 0;
+		for (U32 i = 0; i < N; i++) {
+			Str const s = SPrintf(testMem, "StrDb.Sym.Many.%u", i);
+			errors += !(FindSym(s) == syms[i]);
+			errors += !(GetStr(syms[i]) == s);
+		}
+		Unit_CheckEq(errors, 0u);
+
+		Map<Sym, U32> map(testMem, 64);
+		for (U32 i = 0; i < N; i++) {
+			map.Put(syms[i], i + 1);
+		}
+		for (U32 i = 0; i < N; i++) {
+			errors += map.FindOrZero(syms[i]) != i + 1;
+		}
+		Unit_CheckEq(errors, 0u);
+	}
+
+	Unit_SubTest("Threads") {
+		// Every thread interns the same new strings, racing each other to add each one and to grow
+		constexpr U32 Threads = 4;
+		constexpr U32 N       = 20000;
+		Str* const strs = Mem::AllocT<Str>(testMem, N);
+		for (U32 i = 0; i < N; i++) {
+			strs[i] = SPrintf(testMem, "StrDb.Sym.Threads.%u", i);
+		}
+		InternThreadData datas[Threads];
+		Sys::Thread      threads[Threads];
+		for (U32 t = 0; t < Threads; t++) {
+			datas[t] = {
+				.strs    = strs,
+				.strsLen = N,
+				.start   = t * N / Threads,
+				.syms    = Mem::AllocT<Sym>(testMem, N),
+			};
+			threads[t] = Sys::StartThread(InternThreadFn, &datas[t]);
+		}
+		for (U32 t = 0; t < Threads; t++) {
+			Sys::JoinThread(threads[t]);
+		}
+		U32 errors = 0;
+		for (U32 i = 0; i < N; i++) {
+			for (U32 t = 1; t < Threads; t++) {
+				errors += !(datas[t].syms[i] == datas[0].syms[i]);
+			}
+			errors += !(GetStr(datas[0].syms[i]) == strs[i]);
+			errors += !(FindSym(strs[i]) == datas[0].syms[i]);
+		}
+		Unit_CheckEq(errors, 0u);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// What a Sym-keyed table saves over a Str-keyed one on lookups, for names of sprite-like length.
+Bench_Def("StrDb: Map<Str> vs Map<Sym> lookups") {
+	constexpr U32 Names   = 2048;
+	constexpr U64 Lookups = 4 * 1024 * 1024;
+
+	Str* const strs = Mem::AllocT<Str>(benchMem, Names);
+	Sym* const syms = Mem::AllocT<Sym>(benchMem, Names);
+	Map<Str, U32> strMap(benchMem, 4096);
+	Map<Sym, U32> symMap(benchMem, 4096);
+	for (U32 i = 0; i < Names; i++) {
+		strs[i] = Intern(SPrintf(benchMem, "Bench_Sprite_%u_BottomRight", i));
+		syms[i] = InternSym(strs[i]);
+		strMap.Put(strs[i], i + 1);
+		symMap.Put(syms[i], i + 1);
+	}
+
+	U64 sum = 0;
+	U64 idx = 0;
+	U64 start = Time::Now();
+	for (U64 i = 0; i < Lookups; i++) {
+		idx = (idx + 0x9e3779b97f4a7c15) % Names;
+		sum += strMap.FindOrZero(strs[idx]);
+	}
+	U64 const strTicks = Time::Now() - start;
+	start = Time::Now();
+	for (U64 i = 0; i < Lookups; i++) {
+		idx = (idx + 0x9e3779b97f4a7c15) % Names;
+		sum += symMap.FindOrZero(syms[idx]);
+	}
+	U64 const symTicks = Time::Now() - start;
+
+	Bench::Report("Map<Str>", strTicks, Lookups);
+	Bench::Report("Map<Sym>", symTicks, Lookups);
+	Bench::Consume(sum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+struct CorpusThreadData {
+	Span<Str> tokens;
+	U32       copyBegin;
+	U32       copyEnd;
+	U32       tagBase;	// 0: intern the tokens as they are, else suffix each copy so every string is new
+	U64       sum;
+};
+
+static void CorpusThreadFn(void* userData) {
+	CorpusThreadData* const data = (CorpusThreadData*)userData;
+	char buf[256];
+	U64 sum = 0;
+	for (U32 copy = data->copyBegin; copy < data->copyEnd; copy++) {
+		for (U64 i = 0; i < data->tokens.len; i++) {
+			Str s = data->tokens[i];
+			if (data->tagBase) {
+				U32 const len = s.len < 240 ? s.len : 240;
+				memcpy(buf, s.data, len);
+				U32 tag = data->tagBase + copy;
+				U32 n = len;
+				buf[n++] = '#';
+				do { buf[n++] = (char)('0' + tag % 10); tag /= 10; } while (tag);
+				s = Str(buf, n);
+			}
+			sum += InternSym(s).id;
+		}
+	}
+	data->sum = sum;
+}
+
+// Interning every string and name token of the Assets/*.def corpus, as Json parsing does, spread
+// over 1..max(CpuCount, 8) threads. Past CpuCount the threads share cores, so those rows show what
+// the races cost rather than how it scales. "insert" makes every copy of the corpus new strings;
+// "hit" re-interns the originals, which every Json load of an already-loaded file amounts to.
+Bench_Def("StrDb: parallel interning of Assets/*.def") {
+	constexpr U32 Copies     = 64;
+	constexpr U32 MaxThreads = 64;
+	constexpr U64 MaxTokens  = 64 * 1024;
+
+	Span<Str> const paths = File::EnumFiles("Assets", "def").Or(Span<Str>());
+	if (!paths.len) {
+		Bench::Report("no Assets/*.def: skipped", 0, 1);
+		return;
+	}
+	U64 tokensLen = 0;
+	Str* const tokens = Mem::AllocT<Str>(benchMem, MaxTokens);
+	for (U64 p = 0; p < paths.len; p++) {
+		Str const text = File::ReadAllStr(benchMem, paths[p]).Or(Str());
+		for (U32 i = 0; i < text.len && tokensLen < MaxTokens; ) {
+			char const c = text[i];
+			U32 const start = i;
+			if (c == '"') {
+				for (i++; i < text.len && text[i] != '"'; i++) {}
+				tokens[tokensLen++] = Str(text.data + start + 1, i - start - 1);
+				i++;
+			} else if (c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+				for (i++; i < text.len && (text[i] == '_' || (text[i] >= 'a' && text[i] <= 'z') || (text[i] >= 'A' && text[i] <= 'Z') || (text[i] >= '0' && text[i] <= '9')); i++) {}
+				tokens[tokensLen++] = Str(text.data + start, i - start);
+			} else if (c == '/' && i + 1 < text.len && text[i + 1] == '/') {
+				for (; i < text.len && text[i] != '\n'; i++) {}
+			} else {
+				i++;
+			}
+		}
+	}
+
+	U32 const cpus = Sys::CpuCount() < 8 ? 8 : Sys::CpuCount() < MaxThreads ? Sys::CpuCount() : MaxThreads;
+	U32 tagBase = 1000;
+	for (U32 threadsLen = 1; ; threadsLen = threadsLen * 2 < cpus ? threadsLen * 2 : cpus) {
+		for (U32 mode = 0; mode < 2; mode++) {
+			CorpusThreadData datas[MaxThreads];
+			Sys::Thread      threads[MaxThreads];
+			U64 const start = Time::Now();
+			for (U32 t = 0; t < threadsLen; t++) {
+				datas[t] = {
+					.tokens    = Span<Str>(tokens, tokensLen),
+					.copyBegin = t * Copies / threadsLen,
+					.copyEnd   = (t + 1) * Copies / threadsLen,
+					.tagBase   = mode == 0 ? tagBase : 0,
+					.sum       = 0,
+				};
+				threads[t] = Sys::StartThread(CorpusThreadFn, &datas[t]);
+			}
+			U64 sum = 0;
+			for (U32 t = 0; t < threadsLen; t++) {
+				Sys::JoinThread(threads[t]);
+				sum += datas[t].sum;
+			}
+			U64 const ticks = Time::Now() - start;
+			Bench::Report(SPrintf(benchMem, "%u threads on %u cpus: %s", threadsLen, Sys::CpuCount(), mode == 0 ? "insert" : "hit"), ticks, Copies * tokensLen);
+			Bench::Consume(sum);
+		}
+		tagBase += Copies;
+		if (threadsLen == cpus) {
+			break;
+		}
+	}
 }
 
 //--------------------------------------------------------------------------------------------------
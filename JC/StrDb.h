@@ -2,13 +2,40 @@
 
 #include "JC/Common.h"
 
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// An interned string by id: equality is one compare, and StrDb resolves it back to its text and
+// the hash computed when it was interned. Sym() is the empty string.
+struct Sym {
+	U32 id = 0;
+
+	explicit operator bool() const { return id != 0; }
+};
+inline bool operator==(Sym s1, Sym s2) { return s1.id == s2.id; }
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
+
 namespace JC::StrDb {
 
 //--------------------------------------------------------------------------------------------------
 
 void Init();
 Str  Intern(Str s);
+Sym  InternSym(Str s);
+Sym  FindSym(Str s);	// Sym() if s was never interned
+Str  GetStr(Sym sym);
+U64  GetHash(Sym sym);
 
 //--------------------------------------------------------------------------------------------------
 
-}	// namespace JC::StrDb
\ No newline at end of file
+}	// namespace JC::StrDb
+
+namespace JC {
+
+inline U64 Hash(Sym sym) { return StrDb::GetHash(sym); }	// no rehash of the text
+
+}	// namespace JC
\ No newline at end of file
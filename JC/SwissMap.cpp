@@ -0,0 +1,183 @@
+#include "JC/SwissMap.h"
+
+#include "JC/Bench.h"
+#include "JC/Map.h"
+#include "JC/Rng.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+struct SwissKey {
+	U64 key;
+	U64 hash;
+};
+static bool operator==(SwissKey k1, SwissKey k2) { return k1.key == k2.key; }
+static U64 Hash(SwissKey k) { return k.hash; }
+
+Unit_Test("SwissMap") {
+	Unit_SubTest("Basic") {
+		SwissMap<U64, U64> map(testMem, 100);
+		Unit_CheckEq(map.slotsMask + 1, (U64)128);
+		Unit_CheckEq(map.FindOrZero(1), (U64)0);
+		for (U64 i = 1; i <= 100; i++) {
+			map.Put(i, i * 10);
+		}
+		Unit_CheckEq(map.elemsLen, (U64)100);
+		for (U64 i = 1; i <= 100; i++) {
+			Unit_CheckEq(map.FindOrZero(i), i * 10);
+		}
+		Unit_CheckEq(map.FindOrZero(101), (U64)0);
+
+		*map.Put(7, 1) += 1;
+		Unit_CheckEq(map.FindOrZero(7), (U64)2);
+		Unit_CheckEq(map.elemsLen, (U64)100);
+
+		map.Remove(7);
+		map.Remove(7);
+		map.Remove(1000);
+		Unit_CheckEq(map.elemsLen, (U64)99);
+		Unit_CheckEq(map.FindOrZero(7), (U64)0);
+		for (U64 i = 1; i <= 100; i++) {
+			if (i != 7) {
+				Unit_CheckEq(map.FindOrZero(i), i * 10);
+			}
+		}
+	}
+
+	Unit_SubTest("Collisions") {
+		// Same hash: every key shares a tag and a probe start, so lookups must walk past full groups
+		SwissMap<SwissKey, U64> map(testMem, 64);
+		for (U64 i = 1; i <= 40; i++) {
+			map.Put(SwissKey { i, 0x1234 }, i);
+		}
+		for (U64 i = 1; i <= 40; i++) {
+			Unit_CheckEq(map.FindOrZero(SwissKey { i, 0x1234 }), i);
+		}
+		for (U64 i = 1; i <= 40; i += 2) {
+			map.Remove(SwissKey { i, 0x1234 });
+		}
+		for (U64 i = 1; i <= 40; i++) {
+			Unit_CheckEq(map.FindOrZero(SwissKey { i, 0x1234 }), (i & 1) ? (U64)0 : i);
+		}
+	}
+
+	Unit_SubTest("Wrap") {
+		// Probe starts in the last group: the mirrored ctrl bytes must stay in sync with the first group
+		SwissMap<SwissKey, U64> map(testMem, 14);
+		U64 const lastSlotHash = (U64)15 << 7;
+		for (U64 i = 1; i <= 14; i++) {
+			map.Put(SwissKey { i, lastSlotHash }, i);
+		}
+		for (U64 i = 1; i <= 14; i++) {
+			Unit_CheckEq(map.FindOrZero(SwissKey { i, lastSlotHash }), i);
+		}
+	}
+
+	Unit_SubTest("Churn") {
+		// Far more Put/Remove pairs than slots: tombstones must get reclaimed by the in-place rehash
+		constexpr U64 Cap = 1000;
+		SwissMap<U64, U64> map(testMem, Cap);
+		U64* const live = Mem::AllocT<U64>(testMem, Cap);	// live[k % Cap] == k if k is in the map
+		Rng::Gen gen = Rng::MakeGen(0x243f6a8885a308d3);
+		U64 errors = 0;
+		for (U64 i = 0; i < 200000; i++) {
+			U64 const k = Rng::NextU64(&gen) | 1;
+			U64* const l = &live[k % Cap];
+			if (*l) {
+				errors += map.FindOrZero(*l) != *l;
+				map.Remove(*l);
+			}
+			map.Put(k, k);
+			*l = k;
+		}
+		for (U64 i = 0; i < Cap; i++) {
+			if (live[i]) {
+				errors += map.FindOrZero(live[i]) != live[i];
+			}
+		}
+		Unit_CheckEq(errors, (U64)0);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Same slot count for both: Map's cap is its bucket count, SwissMap's cap is 7/8 of its slots.
+// Map is filled to the same fraction of its buckets, up to the 7/8 SwissMap can go to.
+Bench_Def("Map vs SwissMap: load factors") {
+	constexpr U64 Slots   = 1024 * 1024;
+	constexpr U64 Lookups = 4 * 1024 * 1024;
+
+	U64* const keys = Mem::AllocUninitT<U64>(benchMem, Slots * 2);
+	Rng::Gen gen = Rng::MakeGen(0x9e3779b97f4a7c15);
+	for (U64 i = 0; i < Slots * 2; i++) {
+		keys[i] = Rng::NextU64(&gen) | 1;	// never zero: FindOrZero() can't tell a zero value from a miss
+	}
+	U64 const* const missKeys = keys + Slots;
+
+	constexpr U32 LoadPercents[] = { 25, 50, 75, 87 };
+	for (U32 l = 0; l < LenOf(LoadPercents); l++) {
+		U64 const keysLen = Slots * LoadPercents[l] / 100;
+		MemMark const mark = Mem::Mark(benchMem);
+
+		Map<U64, U64> map(benchMem, Slots);
+		SwissMap<U64, U64> swissMap(benchMem, Slots - Slots / 8);
+		Assert(swissMap.slotsMask + 1 == Slots);
+
+		U64 start = Time::Now();
+		for (U64 i = 0; i < keysLen; i++) {
+			map.Put(keys[i], keys[i]);
+		}
+		U64 const mapPutTicks = Time::Now() - start;
+		start = Time::Now();
+		for (U64 i = 0; i < keysLen; i++) {
+			swissMap.Put(keys[i], keys[i]);
+		}
+		U64 const swissPutTicks = Time::Now() - start;
+
+		U64 sum = 0;
+		auto Lookup = [&](auto* m, U64 const* ks, U64 ksLen) {
+			U64 idx = 0;
+			U64 const startTicks = Time::Now();
+			for (U64 i = 0; i < Lookups; i++) {
+				idx = (idx + 0x9e3779b97f4a7c15) % ksLen;
+				sum += m->FindOrZero(ks[idx]);
+			}
+			return Time::Now() - startTicks;
+		};
+		U64 const mapHitTicks    = Lookup(&map,      keys,     keysLen);
+		U64 const swissHitTicks  = Lookup(&swissMap, keys,     keysLen);
+		U64 const mapMissTicks   = Lookup(&map,      missKeys, keysLen);
+		U64 const swissMissTicks = Lookup(&swissMap, missKeys, keysLen);
+
+		start = Time::Now();
+		for (U64 i = 0; i < keysLen; i++) {
+			map.Remove(keys[i]);
+		}
+		U64 const mapRemoveTicks = Time::Now() - start;
+		start = Time::Now();
+		for (U64 i = 0; i < keysLen; i++) {
+			swissMap.Remove(keys[i]);
+		}
+		U64 const swissRemoveTicks = Time::Now() - start;
+
+		U32 const lf = LoadPercents[l];
+		Bench::Report(SPrintf(benchMem, "%u%% put:    Map",      lf), mapPutTicks,      keysLen);
+		Bench::Report(SPrintf(benchMem, "%u%% put:    SwissMap", lf), swissPutTicks,    keysLen);
+		Bench::Report(SPrintf(benchMem, "%u%% hit:    Map",      lf), mapHitTicks,      Lookups);
+		Bench::Report(SPrintf(benchMem, "%u%% hit:    SwissMap", lf), swissHitTicks,    Lookups);
+		Bench::Report(SPrintf(benchMem, "%u%% miss:   Map",      lf), mapMissTicks,     Lookups);
+		Bench::Report(SPrintf(benchMem, "%u%% miss:   SwissMap", lf), swissMissTicks,   Lookups);
+		Bench::Report(SPrintf(benchMem, "%u%% remove: Map",      lf), mapRemoveTicks,   keysLen);
+		Bench::Report(SPrintf(benchMem, "%u%% remove: SwissMap", lf), swissRemoveTicks, keysLen);
+		Bench::Consume(sum);
+
+		Mem::Reset(benchMem, mark);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
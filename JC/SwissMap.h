@@ -0,0 +1,164 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Bit.h"
+#include "JC/Hash.h"
+
+#include <emmintrin.h>
+
+namespace JC {
+
+//-------------------------------------------------------------------------------------------------
+
+// Open addressing over 1-byte control tags probed a 16-byte group at a time (SSE2), as in Abseil's
+// Swiss tables. ctrl[slot] is Empty, Deleted, or the low 7 bits of the hash of the element in that
+// slot, so one compare of a group against those bits rules out nearly every key compare.
+// Elements stay dense in elems exactly as in Map, and slots hold indices into it, so the two are
+// drop-in replacements for each other.
+// cap is the element capacity: slots are sized so the table never runs more than 7/8 full.
+template <class K, class V> struct SwissMap {
+	static constexpr U64 GroupSize = 16;
+	static constexpr I8  Empty     = (I8)0x80;
+	static constexpr I8  Deleted   = (I8)0xfe;
+	static constexpr U64 NotFound  = U64Max;
+
+	struct Elem {
+		K key;
+		V val;
+	};
+
+	I8*   ctrl;	// slotsLen + GroupSize - 1: the first group is mirrored past the end so group loads never wrap
+	U32*  idxs;	// slot -> elems index
+	Elem* elems;
+	U64   elemsLen;
+	U64   cap;
+	U64   slotsMask;
+	U64   growthLeft;	// Empty slots we may still fill: tombstones don't give theirs back
+
+	SwissMap() = default;
+
+	SwissMap(Mem mem, U64 capIn) { Init(mem, capIn); }
+
+	void Init(Mem mem, U64 capIn) {
+		Assert(capIn > 0 && capIn <= U32Max);
+		U64 slotsLen = Bit::AlignPow2((capIn * 8 + 6) / 7);
+		if (slotsLen < GroupSize) {
+			slotsLen = GroupSize;
+		}
+		ctrl       = Mem::AllocUninitT<I8>(mem, slotsLen + GroupSize - 1);
+		idxs       = Mem::AllocUninitT<U32>(mem, slotsLen);
+		elems      = Mem::AllocT<Elem>(mem, capIn);
+		elemsLen   = 0;
+		cap        = capIn;
+		slotsMask  = slotsLen - 1;
+		growthLeft = slotsLen - slotsLen / 8;
+		memset(ctrl, Empty, slotsLen + GroupSize - 1);
+	}
+
+	static U32 Match(I8 const* group, I8 c) {
+		__m128i const g = _mm_loadu_si128((__m128i const*)group);
+		return (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(c)));
+	}
+
+	static U32 MatchEmptyOrDeleted(I8 const* group) {
+		__m128i const g = _mm_loadu_si128((__m128i const*)group);
+		return (U32)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), g));	// Empty and Deleted are the only tags < -1
+	}
+
+	void SetCtrl(U64 slot, I8 c) {
+		ctrl[slot] = c;
+		ctrl[((slot - (GroupSize - 1)) & slotsMask) + (GroupSize - 1)] = c;	// the mirror for slot < GroupSize - 1, else slot itself
+	}
+
+	// Triangular steps of whole groups: with a power-of-two slot count every group is visited
+	U64 FindSlot(K k, U64 h) const {
+		I8 const h2 = (I8)(h & 0x7f);
+		U64 pos = (h >> 7) & slotsMask;
+		for (U64 step = GroupSize; ; step += GroupSize) {
+			I8 const* const group = ctrl + pos;
+			for (U32 m = Match(group, h2); m; m &= m - 1) {
+				U64 const slot = (pos + Bit::Bsf64(m)) & slotsMask;
+				if (elems[idxs[slot]].key == k) {
+					return slot;
+				}
+			}
+			if (Match(group, Empty)) {
+				return NotFound;
+			}
+			pos = (pos + step) & slotsMask;
+		}
+	}
+
+	U64 FindInsertSlot(U64 h) const {
+		U64 pos = (h >> 7) & slotsMask;
+		for (U64 step = GroupSize; ; step += GroupSize) {
+			if (U32 const m = MatchEmptyOrDeleted(ctrl + pos); m) {
+				return (pos + Bit::Bsf64(m)) & slotsMask;
+			}
+			pos = (pos + step) & slotsMask;
+		}
+	}
+
+	V FindOrZero(K k) const {
+		U64 const slot = FindSlot(k, Hash(k));
+		return slot == NotFound ? (V)0 : elems[idxs[slot]].val;
+	}
+
+	V* Put(K k, V v) {
+		U64 const h = Hash(k);
+		if (U64 const slot = FindSlot(k, h); slot != NotFound) {
+			elems[idxs[slot]].val = v;
+			return &elems[idxs[slot]].val;
+		}
+
+		Assert(elemsLen < cap);
+		U64 slot = FindInsertSlot(h);
+		if (growthLeft == 0 && ctrl[slot] == Empty) {
+			RehashInPlace();	// only tombstones are left to reclaim
+			slot = FindInsertSlot(h);
+		}
+		growthLeft -= (ctrl[slot] == Empty);
+		SetCtrl(slot, (I8)(h & 0x7f));
+		idxs[slot] = (U32)elemsLen;
+		elems[elemsLen++] = Elem { .key = k, .val = v };
+		return &elems[elemsLen - 1].val;
+	}
+
+	void Remove(K k) {
+		U64 const slot = FindSlot(k, Hash(k));
+		if (slot == NotFound) {
+			return;
+		}
+
+		// If every 16-slot window covering this slot still has an Empty, no probe ever ran past it,
+		// so it can go straight back to Empty instead of leaving a tombstone
+		U32 const emptyAfter  = Match(ctrl + slot, Empty);
+		U32 const emptyBefore = Match(ctrl + ((slot - GroupSize) & slotsMask), Empty);
+		bool const neverFull  = emptyAfter && emptyBefore && Bit::Bsf64(emptyAfter) + (GroupSize - 1 - Bit::Bsr64(emptyBefore)) < GroupSize;
+		SetCtrl(slot, neverFull ? Empty : Deleted);
+		growthLeft += neverFull;
+
+		U64 const ei = idxs[slot];
+		if (ei != elemsLen - 1) {
+			elems[ei] = elems[elemsLen - 1];
+			idxs[FindSlot(elems[ei].key, Hash(elems[ei].key))] = (U32)ei;	// still resolves: elems[elemsLen - 1] holds the same key
+		}
+		--elemsLen;
+	}
+
+	void RehashInPlace() {
+		memset(ctrl, Empty, slotsMask + GroupSize);
+		for (U64 i = 0; i < elemsLen; i++) {
+			U64 const h = Hash(elems[i].key);
+			U64 const slot = FindInsertSlot(h);
+			SetCtrl(slot, (I8)(h & 0x7f));
+			idxs[slot] = (U32)i;
+		}
+		U64 const slotsLen = slotsMask + 1;
+		growthLeft = slotsLen - slotsLen / 8 - elemsLen;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
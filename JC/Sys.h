@@ -7,28 +7,60 @@ namespace JC::Sys {
 //--------------------------------------------------------------------------------------------------
 
 #if defined Platform_Windows
-	constexpr U32 MaxPath = 256;
-	constexpr U64 VirtualPageSize = 4096;
+	constexpr U32  MaxPath = 256;
+	constexpr U64  VirtualPageSize = 4096;
+	constexpr bool HasHugePages = false;	// VirtualReserve() ignores PageKind
+#elif defined Platform_Linux
+	constexpr U32  MaxPath = 4096;
+	constexpr U64  VirtualPageSize = 4096;
+	constexpr bool HasHugePages = true;
 #endif	// Platform
 
+constexpr U64 HugePageSize = 2 * MB;
+
 struct Mutex {
 	#if defined Platform_Windows
 		U64 opaque = 0;
+	#elif defined Platform_Linux
+		U64 opaque[5] = {};	// pthread_mutex_t, zero is PTHREAD_MUTEX_INITIALIZER
+	#endif	// Platform
+};
+
+struct Sem {
+	#if defined Platform_Windows
+		U64 opaque = 0;	// HANDLE
+	#elif defined Platform_Linux
+		U64 opaque[4] = {};	// sem_t
 	#endif	// Platform
 };
 
-void  Abort();
-bool  DbgPresent();
-void  DbgPrint(char const* msg);
-void  Print(Str msg);
-void* VirtualAlloc(U64 size);
-void* VirtualReserve(U64 size);
-void* VirtualCommit(void* p, U64 size);
-void  VirtualFree(void* p);
-void  InitMutex(Mutex* mutex);
-void  LockMutex(Mutex* mutex);
-void  UnlockMutex(Mutex* mutex);
-void  ShutdownMutex(Mutex* mutex);
+struct Thread {
+	U64 opaque = 0;
+};
+
+using ThreadFn = void (void* userData);
+
+void   Abort();
+bool   DbgPresent();
+void   DbgPrint(char const* msg);
+void   Print(Str msg);
+void*  VirtualAlloc(U64 size);
+void*  VirtualReserve(U64 size, PageKind pageKind = PageKind::Normal);
+U64    HugePageFallbacks();	// HugeExplicit 2MB chunks committed with THP because the hugetlb pool was short
+void*  VirtualCommit(void* p, U64 size);
+void   VirtualDecommit(void* p, U64 size);
+void   VirtualFree(void* p);
+void   InitMutex(Mutex* mutex);
+void   LockMutex(Mutex* mutex);
+void   UnlockMutex(Mutex* mutex);
+void   ShutdownMutex(Mutex* mutex);
+void   InitSem(Sem* sem, U32 count);
+void   WaitSem(Sem* sem);
+void   PostSem(Sem* sem, U32 count = 1);
+void   ShutdownSem(Sem* sem);
+Thread StartThread(ThreadFn* fn, void* userData);
+void   JoinThread(Thread thread);
+U32    CpuCount();
 
 //--------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,328 @@
+#include "JC/Sys.h"
+
+#include "JC/Atomic.h"
+#include "JC/Bit.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace JC::Sys {
+
+//--------------------------------------------------------------------------------------------------
+
+static_assert(sizeof(Mutex) >= sizeof(pthread_mutex_t));
+static_assert(sizeof(Sem) >= sizeof(sem_t));
+
+// munmap needs the mapping size, which VirtualFree() doesn't take, so remember every mapping
+struct Mapping {
+	void* p;
+	U64   size;
+};
+
+static constexpr U32 MaxMappings = 1024;
+
+static constexpr U32 MaxHugeExplicitMappings = 64;
+
+static Mapping mappings[MaxMappings];
+static U32     mappingsLen;
+static Mapping hugeExplicitMappings[MaxHugeExplicitMappings];	// the HugeExplicit subset, which VirtualCommit() looks up
+static U32     hugeExplicitMappingsLen;
+static U64     hugePageFallbacks;	// HugeExplicit chunks committed with THP: the pool was short
+static Mutex   mappingsMutex;
+
+static void AddMapping(void* p, U64 size) {
+	LockMutex(&mappingsMutex);
+	Assert(mappingsLen < MaxMappings);
+	mappings[mappingsLen++] = { .p = p, .size = size };
+	UnlockMutex(&mappingsMutex);
+}
+
+static U64 RemoveMapping(void* p) {
+	LockMutex(&mappingsMutex);
+	for (U32 i = 0; i < mappingsLen; i++) {
+		if (mappings[i].p == p) {
+			U64 const size = mappings[i].size;
+			mappings[i] = mappings[--mappingsLen];
+			for (U32 j = 0; j < hugeExplicitMappingsLen; j++) {
+				if (hugeExplicitMappings[j].p == p) {
+					hugeExplicitMappings[j] = hugeExplicitMappings[--hugeExplicitMappingsLen];
+					break;
+				}
+			}
+			UnlockMutex(&mappingsMutex);
+			return size;
+		}
+	}
+	Panic("Unknown mapping %p", p);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Abort() {
+	abort();
+}
+
+void Print(Str msg) {
+	for (U64 written = 0; written < msg.len; ) {
+		ssize_t const n = write(STDOUT_FILENO, msg.data + written, msg.len - written);
+		if (n <= 0) {
+			return;
+		}
+		written += (U64)n;
+	}
+}
+
+bool DbgPresent() {
+	int const fd = open("/proc/self/status", O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	char buf[4096];
+	ssize_t const n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n <= 0) {
+		return false;
+	}
+	buf[n] = 0;
+	constexpr Str tracerPid = "TracerPid:";
+	for (char const* iter = buf; *iter; iter++) {
+		if (!memcmp(iter, tracerPid.data, tracerPid.len)) {
+			iter += tracerPid.len;
+			while (*iter == ' ' || *iter == '\t') { iter++; }
+			return *iter != '0';
+		}
+	}
+	return false;
+}
+
+void DbgPrint(char const* msg) {
+	(void)!write(STDERR_FILENO, msg, strlen(msg));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void* VirtualAlloc(U64 size) {
+	Assert(size % VirtualPageSize == 0);
+	void* const p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		Panic("mmap failed: size=%u", size);
+	}
+	AddMapping(p, size);
+	return p;
+}
+
+// Only the HugeExplicit mappings: every other commit skips the lock while there are none
+static bool IsHugeExplicit(void* p) {
+	if (!Atomic::Load(&hugeExplicitMappingsLen)) {
+		return false;
+	}
+	LockMutex(&mappingsMutex);
+	bool found = false;
+	for (U32 i = 0; i < hugeExplicitMappingsLen && !found; i++) {
+		found = p >= hugeExplicitMappings[i].p && (U8*)p < (U8*)hugeExplicitMappings[i].p + hugeExplicitMappings[i].size;
+	}
+	UnlockMutex(&mappingsMutex);
+	return found;
+}
+
+U64 HugePageFallbacks() {
+	return Atomic::Load(&hugePageFallbacks);
+}
+
+// Reservations are PROT_NONE + MAP_NORESERVE so they cost address space only.
+// Huge: over-reserve so the returned range is huge page aligned, then ask for THP. The kernel backs
+// each aligned 2MB of committed memory with a huge page when it can, normal pages when it can't.
+// HugeExplicit: reserved the same way, but VirtualCommit() maps each 2MB chunk over the reservation
+// with MAP_HUGETLB, from the pool sized by /proc/sys/vm/nr_hugepages. A chunk only takes a pool page
+// when it's committed, and the mmap takes it then, so a short pool fails there rather than with a
+// SIGBUS on first touch. A chunk the pool can't cover gets THP instead and counts in
+// HugePageFallbacks().
+void* VirtualReserve(U64 size, PageKind pageKind) {
+	Assert(size % VirtualPageSize == 0);
+	int const flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+	if (pageKind == PageKind::Huge || pageKind == PageKind::HugeExplicit) {
+		U64 const mapSize = size + HugePageSize;
+		U8* const mapBegin = (U8*)mmap(nullptr, mapSize, PROT_NONE, flags, -1, 0);
+		if (mapBegin == (U8*)MAP_FAILED) {
+			Panic("mmap failed: size=%u", mapSize);
+		}
+		U8* const begin = (U8*)Bit::AlignPtrUp(mapBegin, HugePageSize);
+		U8* const end   = begin + size;
+		if (begin > mapBegin) {
+			munmap(mapBegin, (U64)(begin - mapBegin));
+		}
+		if (mapBegin + mapSize > end) {
+			munmap(end, (U64)(mapBegin + mapSize - end));
+		}
+		AddMapping(begin, size);
+		if (pageKind == PageKind::HugeExplicit) {
+			Assert(size % HugePageSize == 0);
+			LockMutex(&mappingsMutex);
+			Assert(hugeExplicitMappingsLen < MaxHugeExplicitMappings);
+			hugeExplicitMappings[hugeExplicitMappingsLen] = { .p = begin, .size = size };
+			Atomic::Store(&hugeExplicitMappingsLen, hugeExplicitMappingsLen + 1);
+			UnlockMutex(&mappingsMutex);
+		} else {
+			madvise(begin, size, MADV_HUGEPAGE);	// best effort: fails harmlessly when THP is disabled
+		}
+		return begin;
+	}
+
+	void* const p = mmap(nullptr, size, PROT_NONE, flags, -1, 0);
+	if (p == MAP_FAILED) {
+		Panic("mmap failed: size=%u", size);
+	}
+	AddMapping(p, size);
+	return p;
+}
+
+void* VirtualCommit(void* p, U64 size) {
+	Assert(p);
+	Assert((U64)p % VirtualPageSize == 0);
+	Assert(size % VirtualPageSize == 0);
+	if (IsHugeExplicit(p)) {
+		Assert((U64)p % HugePageSize == 0 && size % HugePageSize == 0);
+		for (U8* chunk = (U8*)p; chunk < (U8*)p + size; chunk += HugePageSize) {
+			if (mmap(chunk, HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0) != MAP_FAILED) {
+				continue;
+			}
+			// Remapped rather than mprotect()ed: a failed MAP_FIXED may have left a hole
+			if (mmap(chunk, HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0) == MAP_FAILED) {
+				Panic("mmap failed: size=%u, ptr=%p", HugePageSize, chunk);
+			}
+			madvise(chunk, HugePageSize, MADV_HUGEPAGE);
+			Atomic::FetchAdd(&hugePageFallbacks, 1);
+		}
+		return (U8*)p + size;
+	}
+	if (mprotect(p, size, PROT_READ | PROT_WRITE)) {
+		Panic("mprotect failed: size=%u, ptr=%p", size, p);
+	}
+	return (U8*)p + size;
+}
+
+void VirtualDecommit(void* p, U64 size) {
+	Assert(p);
+	Assert((U64)p % VirtualPageSize == 0);
+	Assert(size % VirtualPageSize == 0);
+	if (IsHugeExplicit(p)) {	// back to a plain reservation, which returns the pool pages
+		if (mmap(p, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0) == MAP_FAILED) {
+			Panic("mmap failed: size=%u, ptr=%p", size, p);
+		}
+		return;
+	}
+	if (madvise(p, size, MADV_DONTNEED) || mprotect(p, size, PROT_NONE)) {
+		Panic("madvise/mprotect failed: size=%u, ptr=%p", size, p);
+	}
+}
+
+void VirtualFree(void* p) {
+	if (p) {
+		munmap(p, RemoveMapping(p));
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InitMutex(Mutex* mutex) {
+	pthread_mutex_init((pthread_mutex_t*)mutex, nullptr);
+}
+
+void LockMutex(Mutex* mutex) {
+	pthread_mutex_lock((pthread_mutex_t*)mutex);
+}
+
+void UnlockMutex(Mutex* mutex) {
+	pthread_mutex_unlock((pthread_mutex_t*)mutex);
+}
+
+void ShutdownMutex(Mutex* mutex) {
+	pthread_mutex_destroy((pthread_mutex_t*)mutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InitSem(Sem* sem, U32 count) {
+	sem_init((sem_t*)sem, 0, count);
+}
+
+void WaitSem(Sem* sem) {
+	while (sem_wait((sem_t*)sem) && errno == EINTR) {}
+}
+
+void PostSem(Sem* sem, U32 count) {
+	for (U32 i = 0; i < count; i++) {
+		sem_post((sem_t*)sem);
+	}
+}
+
+void ShutdownSem(Sem* sem) {
+	sem_destroy((sem_t*)sem);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// pthread entry points take a single void*, so park fn + userData in a slot until the thread joins
+struct ThreadObj {
+	ThreadFn* fn;
+	void*     userData;
+	pthread_t pthread;
+	bool      used;
+};
+
+static constexpr U32 MaxThreads = 256;
+
+static ThreadObj threadObjs[MaxThreads];
+static Mutex     threadObjsMutex;
+
+static void* ThreadEntry(void* arg) {
+	ThreadObj* const threadObj = (ThreadObj*)arg;
+	threadObj->fn(threadObj->userData);
+	return nullptr;
+}
+
+Thread StartThread(ThreadFn* fn, void* userData) {
+	LockMutex(&threadObjsMutex);
+	ThreadObj* threadObj = 0;
+	for (U32 i = 0; i < MaxThreads; i++) {
+		if (!threadObjs[i].used) {
+			threadObj = &threadObjs[i];
+			threadObj->used = true;
+			break;
+		}
+	}
+	UnlockMutex(&threadObjsMutex);
+	Assert(threadObj);
+
+	threadObj->fn       = fn;
+	threadObj->userData = userData;
+	if (int const r = pthread_create(&threadObj->pthread, nullptr, ThreadEntry, threadObj); r) {
+		Panic("pthread_create failed: %i", r);
+	}
+	return Thread { .opaque = (U64)(threadObj - threadObjs) };
+}
+
+void JoinThread(Thread thread) {
+	Assert(thread.opaque < MaxThreads);
+	ThreadObj* const threadObj = &threadObjs[thread.opaque];
+	Assert(threadObj->used);
+	pthread_join(threadObj->pthread, nullptr);
+	LockMutex(&threadObjsMutex);
+	threadObj->used = false;
+	UnlockMutex(&threadObjsMutex);
+}
+
+U32 CpuCount() {
+	long const n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (U32)n : 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Sys
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "JC/Common.h"
+
+#include <errno.h>
+
+namespace JC::Sys {
+
+//--------------------------------------------------------------------------------------------------
+
+#define Linux_Errno(fn, ...) \
+	Err::Make(nullptr, SrcLoc::Here(), "Linux", "", (U64)errno, "fn", fn, ##__VA_ARGS__)
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Sys
\ No newline at end of file
@@ -30,7 +30,9 @@ void* VirtualAlloc(U64 size) {
 	return p;
 }
 
-void* VirtualReserve(U64 size) {
+// Windows large pages need SeLockMemoryPrivilege and must be committed up front with the
+// reservation, which defeats commit-on-demand arenas: every PageKind gets normal pages here.
+void* VirtualReserve(U64 size, PageKind) {
 	Assert(size % 65536 == 0);
 	void* p = ::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
 	if (!p) {
@@ -39,6 +41,10 @@ void* VirtualReserve(U64 size) {
 	return p;
 }
 
+U64 HugePageFallbacks() {
+	return 0;	// no huge pages to fall back from: see VirtualReserve()
+}
+
 void* VirtualCommit(void* p, U64 size) {
 	Assert(p);
 	Assert((U64)p % 4096 == 0);
@@ -49,6 +55,15 @@ void* VirtualCommit(void* p, U64 size) {
 	return (U8*)p + size;
 }
 
+void VirtualDecommit(void* p, U64 size) {
+	Assert(p);
+	Assert((U64)p % 4096 == 0);
+	Assert(size % 4096 == 0);
+	if (::VirtualFree(p, size, MEM_DECOMMIT) == FALSE) {
+		Panic("VirtualFree failed with MEM_DECOMMIT: lasterror=%u, size=%u, ptr=%p", GetLastError(), size, p);
+	}
+}
+
 void VirtualFree(void* p) {
 	if (p) {
 		::VirtualFree(p, 0, MEM_RELEASE);
@@ -71,6 +86,86 @@ void ShutdownMutex(Mutex*) {
 	// no-op on windows
 }
 
+void InitSem(Sem* sem, U32 count) {
+	HANDLE const h = CreateSemaphoreW(0, (LONG)count, LONG_MAX, 0);
+	if (!h) {
+		Panic("CreateSemaphoreW failed: lasterror=%u", GetLastError());
+	}
+	sem->opaque = (U64)h;
+}
+
+void WaitSem(Sem* sem) {
+	WaitForSingleObject((HANDLE)sem->opaque, INFINITE);
+}
+
+void PostSem(Sem* sem, U32 count) {
+	ReleaseSemaphore((HANDLE)sem->opaque, (LONG)count, 0);
+}
+
+void ShutdownSem(Sem* sem) {
+	if (sem->opaque) {
+		CloseHandle((HANDLE)sem->opaque);
+		sem->opaque = 0;
+	}
+}
+
+// Thread entry points take a single void*, so park fn + userData in a slot until the thread joins
+struct ThreadObj {
+	ThreadFn* fn;
+	void*     userData;
+	HANDLE    hthread;
+};
+
+static constexpr U32 MaxThreads = 256;
+
+static ThreadObj threadObjs[MaxThreads];
+static Mutex     threadObjsMutex;
+
+static DWORD WINAPI ThreadEntry(void* arg) {
+	ThreadObj* const threadObj = (ThreadObj*)arg;
+	threadObj->fn(threadObj->userData);
+	return 0;
+}
+
+Thread StartThread(ThreadFn* fn, void* userData) {
+	LockMutex(&threadObjsMutex);
+	ThreadObj* threadObj = 0;
+	for (U32 i = 0; i < MaxThreads; i++) {
+		if (!threadObjs[i].hthread) {
+			threadObj = &threadObjs[i];
+			threadObj->hthread = INVALID_HANDLE_VALUE;	// claimed
+			break;
+		}
+	}
+	UnlockMutex(&threadObjsMutex);
+	Assert(threadObj);
+
+	threadObj->fn       = fn;
+	threadObj->userData = userData;
+	HANDLE const h = CreateThread(0, 0, ThreadEntry, threadObj, CREATE_SUSPENDED, 0);
+	if (!h) {
+		Panic("CreateThread failed: lasterror=%u", GetLastError());
+	}
+	threadObj->hthread = h;
+	ResumeThread(h);
+	return Thread { .opaque = (U64)(threadObj - threadObjs) };
+}
+
+void JoinThread(Thread thread) {
+	Assert(thread.opaque < MaxThreads);
+	ThreadObj* const threadObj = &threadObjs[thread.opaque];
+	Assert(Sys::IsValidHandle(threadObj->hthread));
+	WaitForSingleObject(threadObj->hthread, INFINITE);
+	CloseHandle(threadObj->hthread);
+	LockMutex(&threadObjsMutex);
+	threadObj->hthread = 0;
+	UnlockMutex(&threadObjsMutex);
+}
+
+U32 CpuCount() {
+	return GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+}
+
 //--------------------------------------------------------------------------------------------------
 
 }	// namespace JC::Sys
\ No newline at end of file
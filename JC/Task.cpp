@@ -0,0 +1,392 @@
+#include "JC/Task.h"
+
+#include "JC/Asset.h"
+#include "JC/Atomic.h"
+#include "JC/Bench.h"
+#include "JC/Bit.h"
+#include "JC/Job.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC::Task {
+
+//--------------------------------------------------------------------------------------------------
+
+static constexpr U64 FrameReserveSize = 1 * GB;
+
+struct Timer {
+	F64                     wakeSec;
+	std::coroutine_handle<> handle;
+};
+
+// Exactly one of counter and load is set
+struct Poll {
+	Job::Counter*           counter;
+	Asset::Load             load;
+	std::coroutine_handle<> handle;
+};
+
+// Every suspended chain of tasks waits on exactly one thing, so each list holds at most maxTasks
+static bool                           init;
+static Mem                            mem;
+static Mem                            frameMem;	// a heap: frames end in any order
+static U32                            maxTasks;
+static U32                            running;
+static F64                            nowSec;	// sum of Update() secs: F32 would stop counting after a few hours
+static F32                            frameSec;
+static Array<std::coroutine_handle<>> nextFrame;
+static Array<std::coroutine_handle<>> ready;	// Update()'s, gathered before any of them resume
+static Array<Timer>                   timers;	// binary min-heap on wakeSec
+static Array<Poll>                    polls;
+
+//--------------------------------------------------------------------------------------------------
+
+void* Promise::operator new(size_t size) {
+	Assert(init);
+	return Mem::Alloc(frameMem, size);
+}
+
+void Promise::operator delete(void* ptr, size_t) {
+	Mem::Free(frameMem, ptr);
+}
+
+// A child hands control straight back to its parent. A task from Run() has no one to hand back
+// to, so it frees itself.
+std::coroutine_handle<> Promise::FinalAwaiter::await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+	Promise* const promise = &handle.promise();
+	if (promise->continuation) {
+		return promise->continuation;
+	}
+	if (promise->detached) {
+		handle.destroy();
+		running--;
+	}
+	return std::noop_coroutine();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void PushTimer(Timer timer) {
+	U64 i = timers.len;
+	timers.Add(timer);
+	while (i > 0) {
+		U64 const parent = (i - 1) / 2;
+		if (timers[parent].wakeSec <= timer.wakeSec) {
+			break;
+		}
+		timers[i] = timers[parent];
+		i = parent;
+	}
+	timers[i] = timer;
+}
+
+static Timer PopTimer() {
+	Timer const top  = timers[0];
+	Timer const last = timers[timers.len - 1];
+	timers.len--;
+	U64 i = 0;
+	for (;;) {
+		U64 child = 2 * i + 1;
+		if (child >= timers.len) {
+			break;
+		}
+		if (child + 1 < timers.len && timers[child + 1].wakeSec < timers[child].wakeSec) {
+			child++;
+		}
+		if (last.wakeSec <= timers[child].wakeSec) {
+			break;
+		}
+		timers[i] = timers[child];
+		i = child;
+	}
+	if (timers.len) {
+		timers[i] = last;
+	}
+	return top;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void NextFrameAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	nextFrame.Add(handle);
+}
+
+F32 NextFrameAwaiter::await_resume() {
+	return frameSec;
+}
+
+void WaitSecsAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	PushTimer({ .wakeSec = nowSec + sec, .handle = handle });
+}
+
+bool WaitJobAwaiter::await_ready() {
+	return Atomic::Load(&counter->val) == 0;
+}
+
+void WaitJobAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	polls.Add({ .counter = counter, .handle = handle });
+}
+
+bool WaitLoadAwaiter::await_ready() {
+	return Asset::IsDone(load);
+}
+
+void WaitLoadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	polls.Add({ .load = load, .handle = handle });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Init(U32 maxTasksIn) {
+	Assert(!init);
+	maxTasks = maxTasksIn;
+	mem      = Mem::Create(Bit::AlignPow2(4 * maxTasks * sizeof(Poll) + 1 * MB));
+	frameMem = Mem::CreateHeap(FrameReserveSize);
+	nextFrame.Init(mem, maxTasks);
+	ready.Init(mem, maxTasks);
+	timers.Init(mem, maxTasks);
+	polls.Init(mem, maxTasks);
+	running  = 0;
+	nowSec   = 0.0;
+	frameSec = 0.f;
+	init     = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Shutdown() {
+	if (!init) {
+		return;
+	}
+	Mem::Destroy(frameMem);
+	Mem::Destroy(mem);
+	init = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Run(Task task) {
+	Assert(init);
+	Assert(running < maxTasks);
+	std::coroutine_handle<Promise> const handle = task.handle;
+	task.handle = {};
+	handle.promise().detached = true;
+	running++;
+	handle.resume();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Nothing resumes until every ready task has been found: a task that waits again while we're
+// still looking goes on its list for the next Update(), not this one
+void Update(F32 sec) {
+	Assert(init);
+	nowSec  += sec;
+	frameSec = sec;
+
+	ready.len = 0;
+	ready.Add(nextFrame.data, nextFrame.len);
+	nextFrame.len = 0;
+	while (timers.len && timers[0].wakeSec <= nowSec) {
+		ready.Add(PopTimer().handle);
+	}
+	U64 keptLen = 0;
+	for (U64 i = 0; i < polls.len; i++) {
+		Poll const* const poll = &polls[i];
+		if (poll->counter ? Atomic::Load(&poll->counter->val) == 0 : Asset::IsDone(poll->load)) {
+			ready.Add(poll->handle);
+		} else {
+			polls[keptLen++] = *poll;
+		}
+	}
+	polls.len = keptLen;
+
+	for (U64 i = 0; i < ready.len; i++) {
+		ready[i].resume();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+U32 Running() {
+	return running;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static Task CountFrames(U32 frames, U32* counted, F32* secs) {
+	for (U32 i = 0; i < frames; i++) {
+		*secs += co_await NextFrame();
+		(*counted)++;
+	}
+}
+
+static Task Sleep(F32 sec, U32* order, U32* orderLen, U32 id) {
+	co_await WaitSecs(sec);
+	order[(*orderLen)++] = id;
+}
+
+static Task Child(U32* steps) {
+	(*steps)++;
+	co_await NextFrame();
+	(*steps)++;
+	co_await NextFrame();
+	(*steps)++;
+}
+
+static Task Parent(U32* steps) {
+	co_await Child(steps);
+	*steps += 10;
+	co_await Child(steps);	// a second child gets a fresh frame
+	*steps += 10;
+}
+
+static Task AwaitJob(Job::Counter* counter, bool* done) {
+	co_await WaitJob(counter);
+	*done = true;
+}
+
+static Task AwaitLoad(Asset::Load load, bool* done) {
+	co_await WaitLoad(load);
+	*done = (bool)Asset::Wait(load);
+}
+
+Unit_Test("Task") {
+	Init(1024);
+	Defer { Shutdown(); };
+
+	Unit_SubTest("NextFrame") {
+		U32 counted = 0;
+		F32 secs    = 0.f;
+		Run(CountFrames(3, &counted, &secs));
+		Unit_CheckEq(counted, 0u);	// ran up to its first co_await
+		Unit_CheckEq(Running(), 1u);
+		Update(0.25f);
+		Unit_CheckEq(counted, 1u);
+		Update(0.25f);
+		Update(0.5f);
+		Unit_CheckEq(counted, 3u);
+		Unit_CheckEq(secs, 1.f);
+		Unit_CheckEq(Running(), 0u);
+	}
+
+	Unit_SubTest("WaitSecs") {
+		// Out of order, with ties: they wake in deadline order, and none early
+		U32 order[8];
+		U32 orderLen = 0;
+		F32 const secs[8] = { 0.9f, 0.1f, 0.5f, 0.3f, 0.5f, 0.7f, 0.2f, 0.f };
+		for (U32 i = 0; i < 8; i++) {
+			Run(Sleep(secs[i], order, &orderLen, i));
+		}
+		Unit_CheckEq(orderLen, 1u);	// 0 secs doesn't suspend
+		Unit_CheckEq(order[0], 7u);
+		Update(0.25f);
+		Unit_CheckEq(orderLen, 3u);
+		Unit_CheckEq(order[1], 1u);
+		Unit_CheckEq(order[2], 6u);
+		Update(0.25f);
+		Unit_CheckEq(orderLen, 6u);
+		Unit_CheckEq(order[3], 3u);
+		Update(1.f);
+		Unit_CheckEq(orderLen, 8u);
+		Unit_CheckEq(order[6], 5u);
+		Unit_CheckEq(order[7], 0u);
+		Unit_CheckEq(Running(), 0u);
+	}
+
+	Unit_SubTest("Child") {
+		U32 steps = 0;
+		Run(Parent(&steps));
+		Unit_CheckEq(steps, 1u);
+		Update(0.f);
+		Unit_CheckEq(steps, 2u);
+		Update(0.f);
+		Unit_CheckEq(steps, 14u);	// the first child ends, the second starts
+		Update(0.f);
+		Update(0.f);
+		Unit_CheckEq(steps, 26u);
+		Unit_CheckEq(Running(), 0u);
+
+		Task const dropped = Child(&steps);	// never started, freed unrun
+		Unit_CheckEq(steps, 26u);
+	}
+
+	Unit_SubTest("WaitJob") {
+		Job::Counter counter;
+		bool done = false;
+		Run(AwaitJob(&counter, &done));	// already zero: no suspend
+		Unit_Check(done);
+
+		counter.val = 1;
+		done = false;
+		Run(AwaitJob(&counter, &done));
+		Update(0.f);
+		Unit_Check(!done);
+		counter.val = 0;
+		Update(0.f);
+		Unit_Check(done);
+	}
+
+	Unit_SubTest("WaitLoad") {
+		Asset::Init(nullptr);
+		Defer { Asset::Shutdown(); };
+		Asset::LoadDesc const desc = { .path = "nothing to do" };
+		Asset::Load const load = Asset::Start(&desc);
+		bool done = false;
+		Run(AwaitLoad(load, &done));
+		Update(0.f);
+		Unit_Check(!done);	// only Asset::Update() finishes a load
+		Unit_Check(Asset::Update());
+		Update(0.f);
+		Unit_Check(done);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static Task BenchWaitFrames(U32* resumes) {
+	for (;;) {
+		co_await NextFrame();
+		(*resumes)++;
+	}
+}
+
+static Task BenchWaitSecs(F32 sec) {
+	co_await WaitSecs(sec);
+}
+
+// What a frame costs with 10k tasks in flight: every one polled each frame, as a hand-written
+// state machine would be, versus all of them asleep on timers that don't fire
+Bench_Def("Task: 10k tasks in flight") {
+	constexpr U32 Tasks  = 10 * 1024;
+	constexpr U32 Frames = 1000;
+
+	Init(Tasks);
+	U32 resumes = 0;
+	for (U32 i = 0; i < Tasks; i++) {
+		Run(BenchWaitFrames(&resumes));
+	}
+	U64 start = Time::Now();
+	for (U32 i = 0; i < Frames; i++) {
+		Update(0.016f);
+	}
+	Bench::Report("each resumed every frame", Time::Now() - start, Frames);
+	Shutdown();
+	Bench::Consume(resumes);
+
+	Init(Tasks);
+	for (U32 i = 0; i < Tasks; i++) {
+		Run(BenchWaitSecs(1000.f + (F32)i));
+	}
+	start = Time::Now();
+	for (U32 i = 0; i < Frames; i++) {
+		Update(0.016f);
+	}
+	Bench::Report("all waiting on WaitSecs", Time::Now() - start, Frames);
+	Bench::Consume(Running());
+	Shutdown();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Task
\ No newline at end of file
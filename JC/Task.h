@@ -0,0 +1,116 @@
+#pragma once
+
+#include "JC/Common.h"
+
+#include <coroutine>
+
+namespace JC::Asset { DefHandle(Load); }
+namespace JC::Job   { struct Counter; }
+
+namespace JC::Task {
+
+//--------------------------------------------------------------------------------------------------
+
+// Coroutines for game logic that spans frames: an order walking hex to hex, a floating number
+// fading out, an AI plan. Write it straight-line and co_await whatever it has to wait for:
+//
+//     Task::Task Blink(Unit* unit) {
+//         for (U32 i = 0; i < 3; i++) {
+//             unit->hidden = !unit->hidden;
+//             co_await Task::WaitSecs(0.25f);
+//         }
+//     }
+//     Task::Run(Blink(unit));
+//
+// Update() resumes a task only once what it waits on is ready, so a waiting task costs a list entry
+// and nothing per frame. Frames come from the scheduler's own heap arena, never the global heap.
+// A Task may also co_await another Task: the child starts at once and the parent resumes when it ends.
+// Single-threaded: Run(), Update() and every co_await on the thread that calls Update(). Tasks
+// don't throw.
+
+struct Task;
+
+struct Promise {
+	struct FinalAwaiter {
+		bool                    await_ready() noexcept { return false; }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+		void                    await_resume() noexcept {}
+	};
+
+	std::coroutine_handle<> continuation;	// the task co_awaiting this one, if any
+	bool                    detached = false;	// Run(): the scheduler frees the frame when it ends
+
+	static void*        operator new(size_t size);
+	static void         operator delete(void* ptr, size_t size);
+	Task                get_return_object();
+	std::suspend_always initial_suspend() noexcept { return {}; }
+	FinalAwaiter        final_suspend() noexcept { return {}; }
+	void                return_void() {}
+	void                unhandled_exception() { Panic("Task threw"); }
+};
+
+// Owns its frame until Run() or a co_await takes it: a Task that's dropped never runs
+struct [[nodiscard]] Task {
+	using promise_type = Promise;
+
+	std::coroutine_handle<Promise> handle;
+
+	Task() = default;
+	explicit Task(std::coroutine_handle<Promise> h) { handle = h; }
+	Task(Task&& t) { handle = t.handle; t.handle = {}; }
+	Task(Task const&) = delete;
+	Task& operator=(Task const&) = delete;
+	~Task() { if (handle) { handle.destroy(); } }
+
+	bool                    await_ready() { return false; }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) { handle.promise().continuation = awaiting; return handle; }
+	void                    await_resume() {}
+};
+
+inline Task Promise::get_return_object() { return Task(std::coroutine_handle<Promise>::from_promise(*this)); }
+
+//--------------------------------------------------------------------------------------------------
+
+struct NextFrameAwaiter {
+	bool await_ready() { return false; }
+	void await_suspend(std::coroutine_handle<> handle);
+	F32  await_resume();
+};
+
+struct WaitSecsAwaiter {
+	F32  sec;
+	bool await_ready() { return sec <= 0.f; }
+	void await_suspend(std::coroutine_handle<> handle);
+	void await_resume() {}
+};
+
+struct WaitJobAwaiter {
+	Job::Counter* counter;
+	bool await_ready();
+	void await_suspend(std::coroutine_handle<> handle);
+	void await_resume() {}
+};
+
+struct WaitLoadAwaiter {
+	Asset::Load load;
+	bool await_ready();
+	void await_suspend(std::coroutine_handle<> handle);
+	void await_resume() {}
+};
+
+inline NextFrameAwaiter NextFrame()                    { return {}; }	// resumes in the next Update(), returning its sec
+inline WaitSecsAwaiter  WaitSecs(F32 sec)              { return { .sec = sec }; }	// of Update() time, not wall time
+inline WaitJobAwaiter   WaitJob(Job::Counter* counter) { return { .counter = counter }; }	// the counter reached zero
+inline WaitLoadAwaiter  WaitLoad(Asset::Load load)     { return { .load = load }; }	// Asset::IsDone(): Asset::Wait() it to release the handle
+
+//--------------------------------------------------------------------------------------------------
+
+void Init(U32 maxTasks);
+void Shutdown();	// drops unfinished tasks unresumed: their frames go with the arena
+void Run(Task task);	// runs it up to its first co_await; the scheduler owns it from then on
+void Update(F32 sec);
+U32  Running();	// tasks from Run() that haven't ended
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Task
\ No newline at end of file
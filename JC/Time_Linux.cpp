@@ -0,0 +1,46 @@
+#include "JC/Time.h"
+
+#include <time.h>
+
+namespace JC::Time {
+
+//--------------------------------------------------------------------------------------------------
+
+// Ticks are CLOCK_MONOTONIC nanoseconds
+
+static constexpr F64 ticksPerDay  = 1e9 * 60.0 * 60.0 * 24.0;
+static constexpr F64 ticksPerHour = 1e9 * 60.0 * 60.0;
+static constexpr F64 ticksPerMin  = 1e9 * 60.0;
+static constexpr F64 ticksPerSec  = 1e9;
+static constexpr F64 ticksPerMil  = 1e6;
+
+//--------------------------------------------------------------------------------------------------
+
+void Init() {
+}
+
+//--------------------------------------------------------------------------------------------------
+
+U64 Now() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (U64)ts.tv_sec * 1000000000 + (U64)ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+F64 Days (U64 ticks) { return (F64)ticks / ticksPerDay;  }
+F64 Hours(U64 ticks) { return (F64)ticks / ticksPerHour; }
+F64 Mins (U64 ticks) { return (F64)ticks / ticksPerMin;  }
+F64 Secs (U64 ticks) { return (F64)ticks / ticksPerSec;  }
+F64 Mils (U64 ticks) { return (F64)ticks / ticksPerMil;  }
+
+U64 FromDays (F64 days)  { return (U64)(days  * ticksPerDay ); }
+U64 FromHours(F64 hours) { return (U64)(hours * ticksPerHour); }
+U64 FromMins (F64 mins)  { return (U64)(mins  * ticksPerMin ); }
+U64 FromSecs (F64 secs)  { return (U64)(secs  * ticksPerSec ); }
+U64 FromMils (F64 mils)  { return (U64)(mils  * ticksPerMil ); }
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC::Time
\ No newline at end of file
@@ -24,7 +24,7 @@ bool operator==(wchar_t const* s1, Span<wchar_t>  s2) { return !wcscmp(s1, s2.da
 
 Span<wchar_t> Utf8ToWtf16z(Mem mem, Str s) {
 	// Max WTF-16 encoding of a UTF-8 string is 2*len(utf8Str)
-	wchar_t* const out = Mem::AllocT<wchar_t>(mem, (s.len * 2) + 1);
+	wchar_t* const out = Mem::AllocUninitT<wchar_t>(mem, (s.len * 2) + 1);
 	U64 outLen = 0;
 
 	U8 const* p = (U8 const*)s.data;
@@ -177,7 +177,7 @@ Unit_Test("Utf8ToWtf16z") {
 Str Wtf16zToUtf8(Mem mem, const wchar_t* s) {
 	// Max UTF-8 encoding of a WTF-16 string is len(wtf16Str) * 3, due to BMP chars/unpaired surrogates
 	U64 const len = wcslen(s);
-	char* out = Mem::AllocT<char>(mem, len * 3);	
+	char* out = Mem::AllocUninitT<char>(mem, len * 3);	
 	U32 outLen = 0;
 
 	wchar_t const* p = s;
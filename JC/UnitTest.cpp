@@ -1,4 +1,5 @@
 #include "JC/UnitTest.h"
+#include "JC/File.h"
 #include "JC/Log.h"
 #include "JC/StrDb.h"
 #include "JC/Sys.h"
@@ -90,6 +91,7 @@ bool Run() {
 	Mem tempMem = Mem::Create(16 * GB);
 
 	StrDb::Init();
+	File::Init(tempMem);
 
 	Log::Init(tempMem);
 
@@ -136,6 +138,7 @@ bool Run() {
 	Logf("Total failed: %u", failedTests);
 
 	Log::RemoveFn(logFn);
+	File::Shutdown();
 
 	return failedTests == 0;
 }
@@ -0,0 +1,110 @@
+#include "JC/VArray.h"
+
+#include "JC/Bench.h"
+#include "JC/DynamicArray.h"
+#include "JC/Time.h"
+#include "JC/UnitTest.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+Unit_Test("VArray") {
+	Unit_SubTest("Add") {
+		VArray<U64> arr(1024 * 1024);
+		Defer { arr.Shutdown(); };
+		Unit_CheckEq(arr.commitSize, (U64)0);
+
+		arr.Add(7);
+		U64 const* const first = &arr[0];
+		Unit_CheckEq(arr.commitSize, VArray<U64>::CommitSize);
+		for (U64 i = 1; i < 100000; i++) {
+			arr.Add(i);
+		}
+		Unit_Check(&arr[0] == first);	// grew in place
+		Unit_CheckEq(arr.len, (U64)100000);
+		Unit_CheckEq(arr[0], (U64)7);
+		Unit_CheckEq(arr[99999], (U64)99999);
+		Unit_Check(arr.commitSize >= 100000 * sizeof(U64));
+		Unit_CheckEq(arr.commitSize % VArray<U64>::CommitSize, (U64)0);
+
+		U64 const vals[] = { 1, 2, 3 };
+		U64* const added = arr.Add(vals, LenOf(vals));
+		Unit_CheckEq(added[2], (U64)3);
+		Unit_CheckEq(*arr.AddN(10), (U64)0);
+		Unit_CheckEq(arr.len, (U64)100013);
+
+		arr.RemoveUnordered(0);
+		Unit_CheckEq(arr[0], (U64)0);
+		arr.RemoveN(13);
+		arr.Remove();
+		Unit_CheckEq(arr.len, (U64)99998);
+	}
+
+	Unit_SubTest("Clear") {
+		VArray<U32> arr(1024 * 1024);
+		Defer { arr.Shutdown(); };
+		arr.AddN(50000);
+		U64 const commitSize = arr.commitSize;
+		arr.Clear();
+		Unit_CheckEq(arr.len, (U64)0);
+		Unit_CheckEq(arr.commitSize, commitSize);	// kept for the next fill
+		*arr.Add() = 5;
+		Unit_CheckEq(arr[0], 5u);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Appending to an array while something else allocates from the same arena, as Json's tokenizer
+// does when it interns: DynamicArray's Realloc can't extend in place, so every doubling copies and
+// strands the old block. VArray commits more of its reservation instead.
+Bench_Def("DynamicArray vs VArray: append") {
+	constexpr U64 Lens[] = { 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+
+	for (U32 l = 0; l < LenOf(Lens); l++) {
+		U64 const len = Lens[l];
+		U64 sum = 0;
+
+		MemMark const mark = Mem::Mark(benchMem);
+		U64 start = Time::Now();
+		{
+			DynamicArray<U64> arr(benchMem, 16);
+			for (U64 i = 0; i < len; i++) {
+				if (arr.len == arr.maxLen) {
+					Mem::Alloc(benchMem, 16);	// anything: the array is no longer the last allocation
+				}
+				arr.Add(i);
+			}
+			sum += arr[len - 1];
+		}
+		U64 const dynTicks = Time::Now() - start;
+		U64 const dynBytes = Mem::Mark(benchMem).mark - mark.mark;
+		Mem::Reset(benchMem, mark);
+
+		// First fill pays for faulting in fresh pages, refills don't: Json's per-thread array refills
+		// for every input that fits its bounded reservation
+		VArray<U64> arr(len);
+		U64 vTicks[2];
+		for (U32 pass = 0; pass < 2; pass++) {
+			arr.Clear();
+			start = Time::Now();
+			for (U64 i = 0; i < len; i++) {
+				arr.Add(i);
+			}
+			vTicks[pass] = Time::Now() - start;
+			sum += arr[len - 1];
+		}
+		U64 const vBytes = arr.commitSize;
+		arr.Shutdown();
+
+		Bench::Report(SPrintf(benchMem, "%u: DynamicArray (%u KB of arena)", len, dynBytes / KB), dynTicks,  len);
+		Bench::Report(SPrintf(benchMem, "%u: VArray first (%u KB committed)", len, vBytes / KB),   vTicks[0], len);
+		Bench::Report(SPrintf(benchMem, "%u: VArray refill", len),                                vTicks[1], len);
+		Bench::Consume(sum);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
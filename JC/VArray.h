@@ -0,0 +1,127 @@
+#pragma once
+
+#include "JC/Common.h"
+#include "JC/Bit.h"
+#include "JC/Sys.h"
+
+namespace JC {
+
+//--------------------------------------------------------------------------------------------------
+
+// DynamicArray over its own virtual reservation: address space for maxLen elements is reserved up
+// front and committed in CommitSize multiples as the array grows, so growth never copies and never
+// leaves a dead block behind, and pointers into the array stay valid until Shutdown().
+// Reserving is cheap: size maxLen for the worst case, not the expected one.
+template <class T> struct VArray {
+	static constexpr U64 CommitSize = 64 * KB;
+
+	static_assert(alignof(T) <= Sys::VirtualPageSize);
+
+	T*  data       = 0;
+	U64 len        = 0;
+	U64 maxLen     = 0;
+	U64 commitSize = 0;	// bytes
+
+	VArray() = default;
+
+	VArray(U64 maxLenIn) { Init(maxLenIn); }
+
+	VArray(VArray const&) = delete;
+	VArray& operator=(VArray const&) = delete;
+
+	void Init(U64 maxLenIn) {
+		Assert(maxLenIn > 0);
+		data       = (T*)Sys::VirtualReserve(Bit::AlignUp(maxLenIn * sizeof(T), CommitSize));
+		len        = 0;
+		maxLen     = maxLenIn;
+		commitSize = 0;
+	}
+
+	void Shutdown() {
+		Sys::VirtualFree(data);
+		data       = 0;
+		len        = 0;
+		maxLen     = 0;
+		commitSize = 0;
+	}
+
+	// Keeps the committed pages for the next fill
+	void Clear() { len = 0; }
+
+	constexpr T      & operator[](U64 i)       { Assert(i < len); return data[i]; }
+	constexpr T const& operator[](U64 i) const { Assert(i < len); return data[i]; }
+
+	T* Add() {
+		if ((len + 1) * sizeof(T) > commitSize) {
+			_CommitTo(len + 1);
+		}
+		memset(&data[len], 0, sizeof(T));
+		return &data[len++];
+	}
+
+	T* Add(T val) {
+		if ((len + 1) * sizeof(T) > commitSize) {
+			_CommitTo(len + 1);
+		}
+		data[len] = val;
+		return &data[len++];
+	}
+
+	T* Add(T const* vals, U64 valsLen) {
+		Assert(!valsLen || vals);
+		if ((len + valsLen) * sizeof(T) > commitSize) {
+			_CommitTo(len + valsLen);
+		}
+		memcpy(data + len, vals, valsLen * sizeof(T));
+		T* const result = &data[len];
+		len += valsLen;
+		return result;
+	}
+
+	T* Add(Span<T const> vals) {
+		return Add(vals.data, vals.len);
+	}
+
+	T* AddN(U64 n) {
+		if ((len + n) * sizeof(T) > commitSize) {
+			_CommitTo(len + n);
+		}
+		T* const result = &data[len];
+		memset(result, 0, n * sizeof(T));
+		len += n;
+		return result;
+	}
+
+	void Remove() {
+		Assert(len > 0);
+		len--;
+	}
+
+	void RemoveN(U64 n) {
+		Assert(len >= n);
+		len -= n;
+	}
+
+	void RemoveUnordered(U64 i) {
+		Assert(len > 0);
+		Assert(i < len);
+		len--;
+		data[i] = data[len];
+	}
+
+	// Doubles the committed size (within the reservation) so a long fill costs few syscalls
+	void _CommitTo(U64 newLen) {
+		Assert(newLen <= maxLen);
+		U64 const reserveSize = Bit::AlignUp(maxLen * sizeof(T), CommitSize);
+		U64 newCommitSize = Bit::AlignUp(newLen * sizeof(T), CommitSize);
+		if (newCommitSize < commitSize * 2) {
+			newCommitSize = commitSize * 2 < reserveSize ? commitSize * 2 : reserveSize;
+		}
+		Sys::VirtualCommit((U8*)data + commitSize, newCommitSize - commitSize);
+		commitSize = newCommitSize;
+	}
+};
+
+//--------------------------------------------------------------------------------------------------
+
+}	// namespace JC
\ No newline at end of file
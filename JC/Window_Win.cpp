@@ -210,7 +210,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lpara
 			const HRAWINPUT hrawInput = (HRAWINPUT)lparam;
 			UINT size = 0;
 			GetRawInputData(hrawInput, RID_INPUT, 0, &size, sizeof(RAWINPUTHEADER));
-			RAWINPUT* rawInput = (RAWINPUT*)Mem::Alloc(tempMem, size);
+			RAWINPUT* rawInput = (RAWINPUT*)Mem::AllocUninit(tempMem, size);
 			GetRawInputData(hrawInput, RID_INPUT, rawInput, &size, sizeof(RAWINPUTHEADER));
 			if (rawInput->header.dwType == RIM_TYPEMOUSE) {
 				const RAWMOUSE* const rawMouse = &rawInput->data.mouse;